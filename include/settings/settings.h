@@ -127,6 +127,33 @@ namespace vlue::settings {
         void parseYAMLNode(const YAML::Node &config) override;
     };
 
+    // Thread placement configuration struct
+    struct SchedulingConfig final : Config {
+        struct ThreadGroup {
+            std::vector<int> cpus;  // empty leaves placement to the OS
+            int priority{0};        // SCHED_FIFO priority, 0 keeps the default policy
+        };
+
+        bool enable{false};
+        ThreadGroup capture;
+        // Pin the thread that runs the matcher before its first frame: OpenCV's parallel_for_ workers are
+        // spawned from it and inherit the CPU set.
+        ThreadGroup matcher;
+        ThreadGroup sink;
+        // Prefer the NUMA nodes of each group's CPUs for the memory its threads allocate.
+        bool numa_local{false};
+
+        SchedulingConfig() = default;
+        explicit SchedulingConfig(const YAML::Node &config) : Config(config) {
+            parseYAMLNode(config);
+        }
+
+        std::ostream &serialize(std::ostream &os, int layer) const override;
+
+    protected:
+        void parseYAMLNode(const YAML::Node &config) override;
+    };
+
     // Main configuration struct
     struct AppConfig final : Config {
         AppConfig();
@@ -140,6 +167,7 @@ namespace vlue::settings {
         [[nodiscard]] CameraConfig &getCameraConfig() const { return *camera_;}
         [[nodiscard]] CaptureConfig &getCaptureConfig() const { return *capture_;}
         [[nodiscard]] LoggingConfig &getLoggingConfig() const { return *logging_;}
+        [[nodiscard]] SchedulingConfig &getSchedulingConfig() const { return *scheduling_;}
 
     protected:
         void parseYAMLNode(const YAML::Node &config) override;
@@ -149,6 +177,7 @@ namespace vlue::settings {
         SharedPtr<CameraConfig> camera_;
         SharedPtr<CaptureConfig> capture_;
         SharedPtr<LoggingConfig> logging_;
+        SharedPtr<SchedulingConfig> scheduling_;
     };
 
     // Overload << operator for Config
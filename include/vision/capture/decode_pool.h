@@ -0,0 +1,103 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_CAPTURE_DECODE_POOL_H
+#define VISION_CAPTURE_DECODE_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "vision/capture/frame_source.h"
+
+namespace vlue::utils {
+    class ThreadPool;
+}
+
+namespace vlue::capture {
+    /**
+     * Moves frame decoding off the capture thread.
+     *
+     * A capture thread only dequeues frames from the (already started) source(s) and posts them to a pool of
+     * decode workers; next() hands finished frames back strictly in capture order. With two sources, left and
+     * right are decoded as independent tasks. A single side-by-side MJPEG stream is one bitstream, so it is
+     * decoded as one task and split afterwards.
+     *
+     * Compressed payloads are copied (they are small) so driver buffers go straight back to the queue;
+     * uncompressed frames keep their lease until converted. At most `maxInFlight` frames are queued or being
+     * decoded; beyond that the capture thread waits and the driver drops frames as it would without the pool.
+     *
+     * When the right grab times out, the left frame is kept and paired with the next right frame rather than
+     * dropped, so the two streams stay in step. If a source throws (e.g. a device was unplugged), the capture
+     * thread stops and next() rethrows the error once the frames captured before it have been delivered.
+     */
+    class DecodePool {
+    public:
+        struct Options {
+            // Decode threads, 0 for one per hardware thread.
+            unsigned workers{0};
+            // 0 allows two frames per worker.
+            int maxInFlight{0};
+            bool gray{true};
+            // Width of one view; single-source frames twice as wide are split side by side. 0 disables splitting.
+            int width{0};
+            std::chrono::milliseconds grabTimeout{std::chrono::milliseconds(100)};
+            // Run first on the capture thread / each decode worker, e.g. utils::placeCurrentThread.
+            std::function<void()> captureThreadInit;
+            std::function<void(unsigned)> workerThreadInit;
+        };
+
+    private:
+        struct Slot {
+            StereoFrame frame;
+            int pending{0};
+            bool failed{false};
+        };
+
+        std::shared_ptr<FrameSource> m_Left, m_Right;
+        Options m_Options;
+        std::atomic<bool> m_Gray;
+        std::unique_ptr<utils::ThreadPool> m_Pool;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Ready, m_Space;
+        std::map<uint64_t, Slot> m_Slots;
+        // Frames get consecutive pool sequence numbers; m_Delivered is the next one next() returns.
+        uint64_t m_Submitted{0}, m_Delivered{0};
+        bool m_Running{false};
+        std::atomic<uint64_t> m_Failures{0};
+        // First exception thrown by a source; ends capture and is rethrown by next().
+        std::exception_ptr m_Error;
+        std::thread m_Capture;
+
+    public:
+        DecodePool(std::shared_ptr<FrameSource> source, Options options);
+        DecodePool(std::shared_ptr<FrameSource> left, std::shared_ptr<FrameSource> right, Options options);
+        DecodePool(const DecodePool &) = delete;
+        DecodePool &operator=(const DecodePool &) = delete;
+        ~DecodePool();
+
+        void start();
+        void stop();
+
+        // Next frame in capture order. Returns false if none finished within `timeout`; throws what a source threw
+        // once capture has failed and every earlier frame was delivered.
+        bool next(StereoFrame &frame, std::chrono::milliseconds timeout);
+
+        void setGray(bool gray) { m_Gray = gray; }
+        [[nodiscard]] uint64_t getDecodeFailures() const { return m_Failures; }
+
+    private:
+        void capture_();
+        void decode_(uint64_t index, const RawFrame &raw, bool right);
+    };
+}
+
+#endif //VISION_CAPTURE_DECODE_POOL_H
@@ -0,0 +1,35 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_CAPTURE_FRAME_CONVERT_H
+#define VISION_CAPTURE_FRAME_CONVERT_H
+
+#include <cstdint>
+
+namespace cv {
+    class Mat;
+}
+
+namespace vlue::capture {
+    /**
+     * Conversions from raw camera payloads (CAP_PROP_CONVERT_RGB disabled) straight to 8-bit grayscale,
+     * skipping the BGR frame OpenCV would otherwise build.
+     *
+     * `packed` is a CV_8UC2 4:2:2 frame. Luma sits in the first byte of each pair for YUYV/YVYU and in the
+     * second for UYVY.
+     */
+    void extractLuma(const cv::Mat &packed, cv::Mat &gray, bool lumaFirst = true);
+
+    // extractLuma fused with the side-by-side split: columns [0, splitColumn) go to `left`, the rest to `right`.
+    void extractLumaSplit(const cv::Mat &packed, cv::Mat &left, cv::Mat &right, int splitColumn,
+                          bool lumaFirst = true);
+
+    // Decode a compressed frame (MJPEG) directly to grayscale. Returns false if the payload does not decode.
+    bool decodeGray(const cv::Mat &compressed, cv::Mat &gray);
+
+    // Convert a FrameSource payload of format `fourcc` to 8-bit gray or BGR. Always produces a new image.
+    bool convertRaw(const cv::Mat &data, uint32_t fourcc, bool gray, cv::Mat &image);
+}
+
+#endif //VISION_CAPTURE_FRAME_CONVERT_H
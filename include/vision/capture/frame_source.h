@@ -0,0 +1,111 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_CAPTURE_FRAME_SOURCE_H
+#define VISION_CAPTURE_FRAME_SOURCE_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <opencv2/core/mat.hpp>
+
+namespace vlue::capture {
+    constexpr uint32_t makeFourcc(char a, char b, char c, char d) {
+        return static_cast<uint32_t>(static_cast<uint8_t>(a)) | (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) | (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+    }
+
+    constexpr uint32_t FOURCC_YUYV = makeFourcc('Y', 'U', 'Y', 'V');
+    constexpr uint32_t FOURCC_UYVY = makeFourcc('U', 'Y', 'V', 'Y');
+    constexpr uint32_t FOURCC_GREY = makeFourcc('G', 'R', 'E', 'Y');
+    constexpr uint32_t FOURCC_MJPG = makeFourcc('M', 'J', 'P', 'G');
+
+    /**
+     * One buffer dequeued from a FrameSource.
+     *
+     * `data` is a view into the source's buffer, not a copy: CV_8UC2 for YUYV/UYVY, CV_8UC1 for GREY, and a
+     * single row of `bytesused` bytes for compressed formats. The buffer goes back to the source when the last
+     * copy of `lease` is dropped, so keep the lease (or clone `data`) for as long as the pixels are needed.
+     * Holding every lease starves the source and grab() times out.
+     */
+    struct RawFrame {
+        cv::Mat data;
+        uint32_t fourcc{0};
+        uint64_t sequence{0};
+        // Capture time on the monotonic clock, taken by the kernel where the backend supports it.
+        std::chrono::nanoseconds timestamp{0};
+        // DMABUF file descriptor of the buffer when the backend exports one, -1 otherwise. Owned by the source.
+        int dmabufFd{-1};
+        std::shared_ptr<void> lease;
+
+        [[nodiscard]] bool empty() const { return data.empty(); }
+        void release() {
+            data.release();
+            lease.reset();
+        }
+    };
+
+    // A stereo pair as produced by StereoCapture from one device frame (or two, for separate cameras).
+    struct StereoFrame {
+        cv::Mat left, right;
+        uint64_t sequence{0};
+        std::chrono::nanoseconds timestamp{0};
+        // Set when left/right are views into a FrameSource buffer; that buffer is requeued once this is dropped.
+        std::shared_ptr<void> lease;
+
+        void release() {
+            left.release();
+            right.release();
+            lease.reset();
+        }
+    };
+
+    // Device-level capture interface; StereoCapture splits and converts what it delivers.
+    class FrameSource {
+    public:
+        virtual ~FrameSource() = default;
+
+        virtual void start() = 0;
+        virtual void stop() = 0;
+
+        // Wait up to `timeout` for the next frame. Returns false on timeout or end of stream.
+        virtual bool grab(RawFrame &frame, std::chrono::milliseconds timeout) = 0;
+
+        [[nodiscard]] virtual cv::Size getSize() const = 0;
+        [[nodiscard]] virtual uint32_t getFourcc() const = 0;
+    };
+
+    /**
+     * Fake device replaying a file of raw frames through the same fixed buffer pool semantics as a driver queue:
+     * `bufferCount` buffers, each leased out by grab() and requeued when released.
+     *
+     * Uncompressed formats (YUYV, UYVY, GREY) are read as back-to-back frames of the size implied by
+     * width x height; MJPG files are a concatenation of JPEG images.
+     */
+    class FileFrameSource : public FrameSource {
+    private:
+        struct Pool;
+
+        std::string m_Path;
+        cv::Size m_Size;
+        uint32_t m_Fourcc;
+        int m_BufferCount;
+        bool m_Loop;
+        std::shared_ptr<Pool> m_Pool;
+
+    public:
+        FileFrameSource(std::string path, int width, int height, uint32_t fourcc, int bufferCount = 4, bool loop = false);
+        ~FileFrameSource() override;
+
+        void start() override;
+        void stop() override;
+        bool grab(RawFrame &frame, std::chrono::milliseconds timeout) override;
+
+        [[nodiscard]] cv::Size getSize() const override { return m_Size; }
+        [[nodiscard]] uint32_t getFourcc() const override { return m_Fourcc; }
+    };
+}
+
+#endif //VISION_CAPTURE_FRAME_SOURCE_H
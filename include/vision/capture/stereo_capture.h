@@ -5,6 +5,9 @@
 #ifndef STEREO_CAPTURE_H
 #define STEREO_CAPTURE_H
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -14,6 +17,11 @@ namespace cv {
 }
 
 namespace vlue::capture {
+    class FrameSource;
+    class DecodePool;
+    struct RawFrame;
+    struct StereoFrame;
+
     class StereoCapture {
     public:
         enum class CaptureFrameState_ {
@@ -23,6 +31,13 @@ namespace vlue::capture {
             HasRightFrame,
         };
 
+        enum class OutputFormat_ {
+            // Whatever cv::VideoCapture delivers after its default conversion, normally BGR.
+            BGR,
+            // 8-bit luma taken from the raw YUYV/UYVY or MJPEG payload, without building a BGR frame first.
+            Gray,
+        };
+
         // Reference to the shared pointer for the left camera capture object.
         std::shared_ptr<cv::VideoCapture> &cap_left = cap_left_;
         std::shared_ptr<cv::VideoCapture> &cap_right = cap_right_;
@@ -39,20 +54,53 @@ namespace vlue::capture {
 
         StereoCapture(int source_left, int source_right, int width, int height);
 
+        // Capture from a native backend (e.g. V4L2FrameSource). The source is started here; `width` is the
+        // width of one view, so a source twice as wide is split side by side.
+        StereoCapture(std::shared_ptr<FrameSource> source, int width, int height);
+
         ~StereoCapture();
 
         CaptureFrameState_ captureStereoFrame(cv::Mat &frame_left, cv::Mat &frame_right) const;
+
+        /**
+         * Same, plus sequence number and capture timestamp. With a FrameSource whose pixels already have the
+         * requested format (GREY for Gray output) the views point into the driver buffer and `frame.lease`
+         * keeps it out of the queue until released.
+         */
+        CaptureFrameState_ captureStereoFrame(StereoFrame &frame,
+                                              std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)) const;
         void setupCapLeft(int source, int width = 640, int height = 480, int frameWidthScale=1);
         void setupCapLeft(const std::string &source, int width = 640, int height = 480, int frameWidthScale=1);
         void setupCapRight(int source, int width = 640, int height = 480, int frameWidthScale=1);
         void setupCapRight(const std::string &source, int width = 640, int height = 480, int frameWidthScale=1);
 
+        // Gray disables CAP_PROP_CONVERT_RGB on the opened sources. Call again after replacing a source.
+        void setOutputFormat(OutputFormat_ format);
+        [[nodiscard]] OutputFormat_ getOutputFormat() const { return output_format_; }
+
+        /**
+         * Decode frames from the FrameSource on `workers` threads (see DecodePool); 0 decodes inline again. The
+         * hooks run first on the pool's capture thread and on each decode worker, e.g. to place them.
+         */
+        void setDecodeWorkers(unsigned workers, int maxInFlight = 0, std::function<void()> captureThreadInit = nullptr,
+                              std::function<void(unsigned)> workerThreadInit = nullptr);
+
     private:
         // Shared pointers to video capture objects for left and right cameras.
         std::shared_ptr<cv::VideoCapture> cap_left_;
         std::shared_ptr<cv::VideoCapture> cap_right_;
+        std::shared_ptr<FrameSource> source_;
+        std::shared_ptr<DecodePool> decode_pool_;
+        mutable uint64_t frame_count_ = 0;
+        OutputFormat_ output_format_ = OutputFormat_::BGR;
+        // Pixel format each source negotiated, read when switching to raw output.
+        int fourcc_left_ = 0;
+        int fourcc_right_ = 0;
         void cap_init_(const std::shared_ptr<cv::VideoCapture> &cap, int source, int width, int height, int frameWidthScale=1);
         void cap_init_(const std::shared_ptr<cv::VideoCapture> &cap, const std::string &source, int width, int height, int frameWidthScale=1);
+        CaptureFrameState_ captureGrayFrame_(cv::Mat &frame_left, cv::Mat &frame_right) const;
+        static bool toGray_(const cv::Mat &raw, int fourcc, cv::Mat &gray);
+        CaptureFrameState_ splitRaw_(const RawFrame &raw, StereoFrame &frame) const;
 
     public:
         using RawPtr =
@@ -65,6 +113,7 @@ namespace vlue::capture {
             std::shared_ptr<StereoCapture const>;
     };
     using CaptureFrameState = StereoCapture::CaptureFrameState_;
+    using CaptureOutputFormat = StereoCapture::OutputFormat_;
 }
 
 #endif //STEREO_CAPTURE_H
@@ -0,0 +1,57 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_CAPTURE_V4L2_SOURCE_H
+#define VISION_CAPTURE_V4L2_SOURCE_H
+
+#include <string>
+
+#include "vision/capture/frame_source.h"
+
+namespace vlue::capture {
+    /**
+     * Native Video4Linux2 capture with memory-mapped driver buffers (Linux only, see VISION_WITH_V4L2).
+     *
+     * Frames are handed out as views straight into the mapped buffers and requeued to the driver when their
+     * lease is released, so nothing is copied between the driver and the pipeline. Timestamps come from the
+     * kernel. With `exportDmabuf` each buffer is also exported as a DMABUF descriptor for sharing with other
+     * devices.
+     */
+    class V4L2FrameSource : public FrameSource {
+    public:
+        struct Config {
+            std::string device{"/dev/video0"};
+            // Full frame as delivered by the device, i.e. both views for side-by-side cameras.
+            int width{1280};
+            int height{480};
+            uint32_t fourcc{FOURCC_YUYV};
+            int bufferCount{4};
+            int fps{0};
+            bool exportDmabuf{false};
+        };
+
+    private:
+        struct Queue;
+
+        Config m_Config;
+        cv::Size m_Size;
+        uint32_t m_Fourcc{0};
+        std::shared_ptr<Queue> m_Queue;
+
+    public:
+        explicit V4L2FrameSource(Config config);
+        ~V4L2FrameSource() override;
+
+        void start() override;
+        void stop() override;
+        bool grab(RawFrame &frame, std::chrono::milliseconds timeout) override;
+
+        // Negotiated values; valid after start().
+        [[nodiscard]] cv::Size getSize() const override { return m_Size; }
+        [[nodiscard]] uint32_t getFourcc() const override { return m_Fourcc; }
+        [[nodiscard]] const Config &getConfig() const { return m_Config; }
+    };
+}
+
+#endif //VISION_CAPTURE_V4L2_SOURCE_H
@@ -0,0 +1,102 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_DISPARITY_BATCH_H
+#define VISION_DISPARITY_BATCH_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+
+namespace YAML {
+    class Node;
+}
+
+namespace vlue::utils {
+    class ThreadPool;
+}
+
+namespace vlue::disparity {
+    class StereoSGBM;
+
+    struct BatchResult {
+        uint64_t sequence{0};
+        cv::Mat left, right;
+        cv::Mat leftDisparity, rightDisparity;
+    };
+
+    /**
+     * Frame-level parallelism for offline and replay processing.
+     *
+     * submit() queues a stereo pair; up to `maxInFlight` frames are matched concurrently on a pool of workers,
+     * each borrowing one of the matchers built by the factory, so no two frames share matcher or filter state.
+     * next() returns results strictly in submission order regardless of which frame finishes first, so output
+     * is the same as processing the frames one by one.
+     */
+    class BatchStereoMatcher {
+    public:
+        using MatcherFactory = std::function<std::unique_ptr<StereoSGBM>()>;
+
+        struct Options {
+            // Worker threads (and matcher instances), 0 for one per hardware thread.
+            unsigned workers{0};
+            // Frames queued, being matched or waiting in the reorder buffer; 0 allows two per worker.
+            int maxInFlight{0};
+            bool computeRight{false};
+            // Copy submitted images; only skip if callers never write into a Mat after submitting it.
+            bool copyInputs{true};
+        };
+
+    private:
+        Options m_Options;
+        std::mutex m_Mutex;
+        std::condition_variable m_Ready, m_Space;
+        std::vector<std::unique_ptr<StereoSGBM>> m_Idle;
+        struct Finished {
+            BatchResult result;
+            std::exception_ptr error;
+        };
+        std::map<uint64_t, Finished> m_Finished;
+        uint64_t m_Submitted{0}, m_Delivered{0};
+        // Declared last: its destructor finishes the queued frames while the members above still exist.
+        std::unique_ptr<utils::ThreadPool> m_Pool;
+
+    public:
+        BatchStereoMatcher(const MatcherFactory &factory, Options options);
+        // Every worker gets its own StereoSGBM built from `disparity_config`, pre/post-process stages included.
+        BatchStereoMatcher(const YAML::Node &disparity_config, Options options);
+        BatchStereoMatcher(const BatchStereoMatcher &) = delete;
+        BatchStereoMatcher &operator=(const BatchStereoMatcher &) = delete;
+        ~BatchStereoMatcher();
+
+        /**
+         * Queue a frame, waiting while `maxInFlight` frames are outstanding. Returns its sequence number. Only
+         * next() frees room, so a caller that submits and consumes on the same thread must drain while full()
+         * before submitting, or it waits forever.
+         */
+        uint64_t submit(const cv::Mat &left, const cv::Mat &right);
+        [[nodiscard]] bool full();
+
+        // Next result in submission order. Returns false if it is not done within `timeout` (by default: once
+        // every submitted frame has been returned); rethrows the exception if matching that frame failed.
+        bool next(BatchResult &result, std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+        // Frames submitted but not yet returned by next().
+        [[nodiscard]] std::size_t pending();
+        [[nodiscard]] unsigned getWorkers() const { return m_Options.workers; }
+
+    private:
+        void process_(uint64_t sequence, BatchResult result);
+    };
+}
+
+#endif //VISION_DISPARITY_BATCH_H
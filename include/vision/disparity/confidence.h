@@ -0,0 +1,53 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_DISPARITY_CONFIDENCE_H
+#define VISION_DISPARITY_CONFIDENCE_H
+
+namespace cv {
+    class Mat;
+}
+
+namespace vlue::disparity {
+    /**
+     * Per-pixel confidence of a CV_16S disparity map, in [0, 1].
+     *
+     * cv::StereoSGBM does not expose its cost volume, so the score is built from the two cues available after
+     * matching: left-right agreement, falling linearly from 1 at perfect agreement to 0 at `lrTolerance` pixels
+     * (or where the right pixel is invalid or out of view), and local smoothness, sigma^2 / (sigma^2 + var) over
+     * the valid disparities of a (2 * radius + 1)^2 window. The two terms are multiplied. Invalid pixels get 0.
+     *
+     * The window sums are box filters; the combination is one branch-light pass per row.
+     */
+    class DisparityConfidence {
+    public:
+        struct Parameters {
+            int minDisparity{0};
+            // Only used to recognise invalid pixels of the right map.
+            int numDisparities{16};
+            double lrTolerance{2.0};
+            int radius{2};
+            // Local standard deviation, in pixels, at which the smoothness term drops to 0.5.
+            double sigma{1.0};
+        };
+
+    private:
+        Parameters m_Params;
+
+    public:
+        explicit DisparityConfidence(const Parameters &params);
+
+        [[nodiscard]] const Parameters &getParameters() const { return m_Params; }
+
+        /**
+         * @param leftDisparity  CV_16SC1 disparity to score.
+         * @param rightDisparity CV_16SC1 right-view disparity (createRightMatcher convention, negative values), or
+         *                       empty to skip the left-right term.
+         * @param confidence     CV_32FC1 output of the disparity map's size.
+         */
+        void compute(const cv::Mat &leftDisparity, const cv::Mat &rightDisparity, cv::Mat &confidence) const;
+    };
+}
+
+#endif //VISION_DISPARITY_CONFIDENCE_H
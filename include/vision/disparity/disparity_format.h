@@ -0,0 +1,23 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_DISPARITY_DISPARITY_FORMAT_H
+#define VISION_DISPARITY_DISPARITY_FORMAT_H
+
+namespace vlue::disparity {
+    // cv::StereoSGBM outputs CV_16S disparity in fixed point with 4 fractional bits.
+    constexpr int DISP_SHIFT = 4;
+    constexpr int DISP_SCALE = 1 << DISP_SHIFT;
+
+    // Value the matcher writes for pixels it could not match.
+    constexpr short invalidDisparity(int minDisparity = 0) {
+        return static_cast<short>((minDisparity - 1) * DISP_SCALE);
+    }
+
+    constexpr bool isValidDisparity(short disparity, int minDisparity = 0) {
+        return disparity >= minDisparity * DISP_SCALE;
+    }
+}
+
+#endif //VISION_DISPARITY_DISPARITY_FORMAT_H
@@ -0,0 +1,86 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_DISPARITY_INCREMENTAL_H
+#define VISION_DISPARITY_INCREMENTAL_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+
+namespace vlue::disparity {
+    class StereoSGBM;
+
+    // What one IncrementalStereoMatcher::compute() call did.
+    struct IncrementalFrameInfo {
+        bool keyframe{false};
+        // Tiles whose left or right pixels moved away from the reference, and tiles recomputed because of them.
+        int changedTiles{0};
+        int recomputedTiles{0};
+        int totalTiles{0};
+        // Pixels fed to the matcher, margins included, relative to one full frame.
+        double matchedArea{0.0};
+    };
+
+    /**
+     * Motion-gated disparity for mostly static scenes, e.g. fixed-mount inspection cameras.
+     *
+     * Both rectified views are compared tile by tile with the images each tile was last matched from (SIMD sum of
+     * absolute differences). Only tiles whose mean difference exceeds `threshold` are matched again; everywhere
+     * else the cached disparity is returned. A changed right tile invalidates the left tiles that can match into
+     * it, i.e. the tiles up to the disparity range to its right. Changed tiles are grown by `dilate` tiles, since
+     * the block window and SGM aggregation carry a change a little beyond its pixels, and covered with a few
+     * rectangles. Each rectangle is matched on a crop that adds the disparity range plus `margin` on the left and
+     * `margin` on the other sides, and only its interior is copied back.
+     *
+     * Comparing against the reference instead of the previous frame means slow drift still triggers a recompute
+     * once it adds up. Every `keyframeInterval` frames, after a size change, or when more than `fullFraction` of
+     * the tiles changed, the whole frame is matched instead.
+     *
+     * Not thread-safe; use one instance per stream.
+     */
+    class IncrementalStereoMatcher {
+    public:
+        struct Options {
+            int tileSize{32};
+            // Mean absolute difference per byte, in grey levels, above which a tile counts as changed.
+            double threshold{3.0};
+            int dilate{1};
+            int margin{16};
+            // 0 only matches a full frame when it has to.
+            int keyframeInterval{300};
+            double fullFraction{0.5};
+        };
+
+    private:
+        std::shared_ptr<const StereoSGBM> m_Matcher;
+        Options m_Options;
+        // Images each tile's cached disparity was computed from, and that disparity.
+        cv::Mat m_RefLeft, m_RefRight, m_Disparity;
+        uint64_t m_SinceKeyframe{0};
+        bool m_ForceKeyframe{true};
+
+    public:
+        IncrementalStereoMatcher(std::shared_ptr<const StereoSGBM> matcher, Options options);
+
+        /**
+         * Left disparity of the pair, in the matcher's usual CV_16S format. Pre- and post-processing registered on
+         * the matcher run on each crop, so stick to local stages (WLS on a crop only sees the crop).
+         */
+        IncrementalFrameInfo compute(const cv::Mat &left, const cv::Mat &right, cv::Mat &disparity);
+
+        // Match the whole next frame, e.g. after the matcher's parameters changed.
+        void reset() { m_ForceKeyframe = true; }
+
+        [[nodiscard]] const Options &getOptions() const { return m_Options; }
+
+    private:
+        void changedTiles_(const cv::Mat &image, const cv::Mat &reference, std::vector<uint8_t> &changed,
+                           int tilesX, int tilesY) const;
+    };
+}
+
+#endif //VISION_DISPARITY_INCREMENTAL_H
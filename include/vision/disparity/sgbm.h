@@ -5,9 +5,14 @@
 #ifndef VISION_DISPARITY_SGBM_H
 #define VISION_DISPARITY_SGBM_H
 
+#include <chrono>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "vision/helpers/memory_tracker.h"
+#include "vision/helpers/rcu.h"
+
 namespace cv {
     class Mat;
     class StereoSGBM;
@@ -17,16 +22,23 @@ namespace YAML {
     class Node;
 }
 
+namespace vlue::utils {
+    class FileWatcher;
+}
+
 namespace vlue::processing {
     class Pipeline;
     using PipelinePtr = std::shared_ptr<Pipeline>;
+
+    template<typename... Stages>
+    class StaticDisparityPipeline;
 }
 
 namespace vlue::disparity {
+    class DisparityUpsampler;
+    class DisparityConfidence;
+
     class StereoSGBM {
-    private:
-        std::vector<processing::PipelinePtr> m_Preprocess, m_PostProcess;
-        std::shared_ptr<cv::StereoSGBM> m_MatcherLeft, m_MatcherRight;
     public:
         enum
         {
@@ -35,17 +47,119 @@ namespace vlue::disparity {
             MODE_SGBM_3WAY = 2,
             MODE_HH4  = 3
         };
+
+        struct Parameters {
+            int minDisparity{0};
+            int numDisparities{16};
+            int blockSize{3};
+            int P1{0};
+            int P2{0};
+            int disp12MaxDiff{0};
+            int preFilterCap{0};
+            int uniquenessRatio{0};
+            int speckleWindowSize{0};
+            int speckleRange{0};
+            int mode{MODE_SGBM};
+            // Match on images downscaled by this factor (1, 2 or 4) and upsample the result, guided by the
+            // full-resolution views. The other parameters stay expressed at full resolution.
+            int downscale{1};
+            // Confidence map (see DisparityConfidence), only computed on request.
+            double confidenceTolerance{2.0};
+            int confidenceRadius{2};
+            double confidenceSigma{1.0};
+        };
+
+    private:
+        // Everything built from one set of Parameters. Immutable once published, so a frame that grabbed a
+        // snapshot can finish with it while a newer one is swapped in.
+        struct MatcherSet {
+            Parameters params;
+            std::shared_ptr<cv::StereoSGBM> left, right;
+            std::shared_ptr<DisparityUpsampler> upsampler;
+            std::shared_ptr<DisparityConfidence> confidence;
+        };
+
+        // A stage of a plan with its trace name and memory region, both looked up once when the plan is built.
+        struct PlannedStage {
+            processing::PipelinePtr pipeline;
+            const char *traceName;
+            utils::MemoryTracker::Region *memoryRegion;
+        };
+
+        std::vector<processing::PipelinePtr> m_Preprocess, m_PostProcess;
+        // What actually runs: the registered stages with adjacent pointwise stages fused.
+        std::vector<PlannedStage> m_PreprocessPlan, m_PostProcessPlan;
+        utils::RcuCell<const MatcherSet> m_Matchers;
+        // Declared last so the watcher thread stops before anything it could update is destroyed.
+        std::shared_ptr<utils::FileWatcher> m_Watcher;
+
+    public:
         explicit StereoSGBM(const std::string &disparity_param_path);
+        // Optional `preprocess` / `postprocess` sequences are built with processing::PipelineFactory and registered.
         explicit StereoSGBM(const YAML::Node &disparity_config);
+        explicit StereoSGBM(const Parameters &params);
         explicit StereoSGBM(int minDisparity=0, int numDisparities=16, int blockSize=3, int P1=0, int P2=0, int disp12MaxDiff=0, int preFilterCap=0, int uniquenessRatio=0, int speckleWindowSize=0, int speckleRange=0, int mode=MODE_SGBM);
 
+        // Copies share the registered stages and take a snapshot of the matchers, but not the parameter file
+        // watcher: its callback is bound to the instance that started it.
+        StereoSGBM(const StereoSGBM &other);
+        StereoSGBM &operator=(const StereoSGBM &other);
         ~StereoSGBM() = default;
 
         void registerPreprocessPipeline(const processing::PipelinePtr &pipeline);
         void registerPostprocessPipeline(const processing::PipelinePtr &pipeline);
         void computeDisparity(const cv::Mat &left, const cv::Mat& right, cv::Mat &leftDisparity, cv::Mat &rightDisparity, bool computeRight=false) const;
 
+        /**
+         * Same as above, and fills `confidence` with a CV_32FC1 map in [0, 1] scoring the final left disparity
+         * against the right one (see DisparityConfidence). Consumers can weight or skip pixels by it.
+         */
+        void computeDisparity(const cv::Mat &left, const cv::Mat &right, cv::Mat &leftDisparity, cv::Mat &rightDisparity,
+                              cv::Mat &confidence, bool computeRight=false) const;
+
+        // Same as above, but post-processing runs the compile-time chain `postprocess` instead of the registered
+        // post-process pipelines. Include "vision/pipeline/static_pipeline.h" to use it.
+        template<typename... Stages>
+        void computeDisparity(const cv::Mat &left, const cv::Mat &right, cv::Mat &leftDisparity, cv::Mat &rightDisparity,
+                              const processing::StaticDisparityPipeline<Stages...> &postprocess) const {
+            preprocessAndMatch_(left, right, leftDisparity, rightDisparity);
+            postprocess(leftDisparity, left, rightDisparity, right);
+        }
+
+        void setDownscale(int factor);
+        [[nodiscard]] int getDownscale() const { return getParameters().downscale; }
+        [[nodiscard]] Parameters getParameters() const;
+
+        /**
+         * Retune the matcher while frames are being processed. The new matchers are built on the calling thread
+         * and swapped in atomically; frames already in computeDisparity finish with the previous set, the next
+         * frame picks up the new one. The per-frame path never takes a lock.
+         */
+        void updateParameters(const Parameters &params);
+        // Also pushes the `preprocess` / `postprocess` entries into the registered stages they were built from
+        // (see PipelineFactory::update). Adding, removing or reordering stages needs a new instance.
+        void updateParameters(const YAML::Node &disparity_config);
+
+        // Reload the parameters, including those of the filter stages, whenever the file changes on disk.
+        void watchParameterFile(const std::string &disparity_param_path,
+                                std::chrono::milliseconds interval = std::chrono::milliseconds(500));
+        void stopWatchingParameterFile();
+
+        static Parameters parseParameters(const YAML::Node &disparity_config);
+
     private:
+        static std::shared_ptr<const MatcherSet> createMatchers_(const Parameters &params);
+
+        static std::vector<PlannedStage> plan_(const std::vector<processing::PipelinePtr> &pipelines);
+
+        static void updateStages_(const std::vector<processing::PipelinePtr> &stages, const YAML::Node &config,
+                                  const char *section);
+
+        // Returns the matcher snapshot the frame was matched with.
+        std::shared_ptr<const MatcherSet> preprocessAndMatch_(const cv::Mat &left, const cv::Mat &right, cv::Mat &leftDisparity, cv::Mat &rightDisparity) const;
+
+        static void match_(const MatcherSet &matchers, const cv::Mat &left, const cv::Mat &right, cv::Mat &leftDisparity, cv::Mat &rightDisparity);
+
         void preprocess(cv::Mat &left, cv::Mat &right) const;
 
         void postprocess(cv::Mat &leftDisparity, const cv::Mat &leftView, cv::Mat &rightDisparity, const cv::Mat &rightView, bool filterRight=false) const;
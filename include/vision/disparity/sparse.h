@@ -0,0 +1,76 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_DISPARITY_SPARSE_H
+#define VISION_DISPARITY_SPARSE_H
+
+#include <vector>
+#include <opencv2/core/mat.hpp>
+
+namespace vlue::disparity {
+    struct SparseMatch {
+        bool valid{false};
+        // Disparity in pixels (subpixel when enabled).
+        float disparity{0.0f};
+        // Z in the units of the calibration baseline; 0 when no Q was given or the match is invalid.
+        float depth{0.0f};
+        // Reprojected point in the rectified left camera frame, as cv::reprojectImageTo3D would give.
+        cv::Point3f point;
+        // (second best - best) / second best cost, in [0, 1]. Higher is more distinctive.
+        float confidence{0.0f};
+    };
+
+    /**
+     * Disparity for a handful of left-image points instead of a whole frame.
+     *
+     * For each point the window is compared against every candidate along the epipolar row of the rectified
+     * right image, so the work is points x numDisparities x blockSize^2 and independent of the image size.
+     * SAD costs are accumulated for 16 disparities at a time with OpenCV universal intrinsics; Census uses a
+     * 5x5 transform computed only over the searched strip and Hamming distance.
+     */
+    class SparseStereoMatcher {
+    public:
+        enum class Cost_ {
+            SAD,
+            Census,
+        };
+
+        struct Parameters {
+            int minDisparity{0};
+            int numDisparities{64};
+            // Odd, at most 15 so SAD costs fit 16-bit accumulators.
+            int blockSize{7};
+            Cost_ cost{Cost_::SAD};
+            // Matches with a confidence below this are reported invalid.
+            float uniquenessRatio{0.1f};
+            bool subpixel{true};
+        };
+
+    private:
+        // Per-thread scratch buffers, reused across the points of one parallel range.
+        struct Workspace;
+
+        Parameters m_Params;
+        cv::Mat m_Q;
+
+    public:
+        // `Q` is the 4x4 reprojection matrix from cv::stereoRectify; leave it empty to skip depth.
+        explicit SparseStereoMatcher(const Parameters &params, const cv::Mat &Q = cv::Mat());
+
+        // `left` and `right` are rectified CV_8UC1 images of the same size. `matches` gets one entry per point.
+        void match(const cv::Mat &left, const cv::Mat &right, const std::vector<cv::Point2f> &points,
+                   std::vector<SparseMatch> &matches) const;
+
+        [[nodiscard]] const Parameters &getParameters() const { return m_Params; }
+        void setQ(const cv::Mat &Q);
+
+    private:
+        SparseMatch matchPoint_(const cv::Mat &left, const cv::Mat &right, const cv::Point2f &point,
+                                Workspace &workspace) const;
+    };
+
+    using SparseCost = SparseStereoMatcher::Cost_;
+}
+
+#endif //VISION_DISPARITY_SPARSE_H
@@ -0,0 +1,43 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_DISPARITY_UPSAMPLING_H
+#define VISION_DISPARITY_UPSAMPLING_H
+
+namespace cv {
+    class Mat;
+}
+
+namespace vlue::disparity {
+    /**
+     * Joint bilateral upsampling (Kopf et al., 2007) of a low-resolution CV_16S disparity map.
+     *
+     * Every full-resolution pixel averages the (2 * radius + 1)^2 nearest valid low-resolution disparities.
+     * Each sample is weighted by its spatial distance and by how similar the full-resolution guide is at the two
+     * locations, so depth edges follow image edges instead of the blocky low-resolution grid. Disparities are
+     * rescaled by the upsampling factor.
+     */
+    class DisparityUpsampler {
+    private:
+        int m_Radius;
+        double m_SigmaColor;
+        double m_SigmaSpatial;
+
+    public:
+        explicit DisparityUpsampler(int radius = 1, double sigmaColor = 12.0, double sigmaSpatial = 1.0);
+
+        /**
+         * @param lowDisparity    CV_16SC1 disparity computed on images downscaled by `factor`.
+         * @param guide           Full-resolution view the disparity refers to, 8-bit gray or BGR.
+         * @param dst             CV_16SC1 output with the guide's size.
+         * @param lowMinDisparity Minimum disparity of the low-resolution matcher, for validity.
+         * @param dstMinDisparity Minimum disparity at full resolution. Valid output is clamped to it, since
+         *                        lowMinDisparity * factor may lie below it, and it sets the invalid value.
+         */
+        void upsample(const cv::Mat &lowDisparity, const cv::Mat &guide, cv::Mat &dst, int factor,
+                      int lowMinDisparity, int dstMinDisparity) const;
+    };
+}
+
+#endif //VISION_DISPARITY_UPSAMPLING_H
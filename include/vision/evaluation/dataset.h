@@ -0,0 +1,73 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_EVALUATION_DATASET_H
+#define VISION_EVALUATION_DATASET_H
+
+#include <string>
+#include <vector>
+#include <opencv2/core/mat.hpp>
+
+namespace vlue::evaluation {
+    struct StereoSample {
+        std::string name;
+        cv::Mat left, right;
+        // CV_32F disparity in pixels, empty when the recording has none. Non-positive values are unknown.
+        cv::Mat groundTruth;
+    };
+
+    /**
+     * Rectified stereo pairs on disk. Supported layouts:
+     *
+     *     Directory    root/left/<name>.png, root/right/<name>.png,
+     *                  optional root/disparity/<name>.pfm or <name>.png (16-bit, disparity * 256, 0 = unknown)
+     *     Middlebury   root/<scene>/im0.png, im1.png, optional disp0GT.pfm or disp0.pfm
+     *     Kitti        root/image_2|image_0/<id>_10.png, root/image_3|image_1/<id>_10.png,
+     *                  optional root/disp_occ_0|disp_noc_0|disp_occ/<id>_10.png
+     *
+     * Samples are sorted by name so runs are reproducible.
+     */
+    class StereoDataset {
+    public:
+        enum class Layout_ {
+            Auto,
+            Directory,
+            Middlebury,
+            Kitti,
+        };
+
+    private:
+        std::vector<StereoSample> m_Samples;
+
+    public:
+        StereoDataset() = default;
+        explicit StereoDataset(std::vector<StereoSample> samples);
+
+        static StereoDataset load(const std::string &root, Layout_ layout = Layout_::Auto, bool grayscale = false);
+        static StereoDataset loadDirectory(const std::string &root, bool grayscale = false);
+        static StereoDataset loadMiddlebury(const std::string &root, bool grayscale = false);
+        static StereoDataset loadKitti(const std::string &root, bool grayscale = false);
+
+        // Directory if root has left/, Kitti if it has image_2/ or image_0/, Middlebury otherwise.
+        static Layout_ detectLayout(const std::string &root);
+
+        [[nodiscard]] const std::vector<StereoSample> &getSamples() const { return m_Samples; }
+        [[nodiscard]] std::size_t size() const { return m_Samples.size(); }
+        [[nodiscard]] bool empty() const { return m_Samples.empty(); }
+        [[nodiscard]] bool hasGroundTruth() const;
+    };
+
+    using DatasetLayout = StereoDataset::Layout_;
+
+    // Decode a 16-bit PNG disparity map scaled by 256 into CV_32F pixels, or an empty Mat if the file is absent.
+    cv::Mat readScaledDisparity(const std::string &path, double scale = 256.0);
+
+    // Read a single-channel PFM (as used by Middlebury) into CV_32F, top row first. Infinity marks unknown pixels.
+    cv::Mat readPfm(const std::string &path);
+
+    // readPfm for .pfm files, readScaledDisparity otherwise; empty if the file is absent.
+    cv::Mat readDisparity(const std::string &path);
+}
+
+#endif //VISION_EVALUATION_DATASET_H
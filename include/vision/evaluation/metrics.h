@@ -0,0 +1,51 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_EVALUATION_METRICS_H
+#define VISION_EVALUATION_METRICS_H
+
+#include <vector>
+
+namespace cv {
+    class Mat;
+}
+
+namespace vlue::evaluation {
+    struct DisparityMetrics {
+        // Fraction of pixels with a valid disparity.
+        double density{0.0};
+        // Fraction of valid left pixels whose right-view match points back within one pixel.
+        double lrConsistency{0.0};
+        // Only filled when ground truth was supplied.
+        bool hasGroundTruth{false};
+        // Fraction of ground-truth pixels that are invalid or off by more than the bad-pixel threshold.
+        double badPixelRate{0.0};
+        // Mean absolute error in pixels over ground-truth pixels that have an estimate.
+        double endPointError{0.0};
+    };
+
+    /**
+     * Disparity maps are CV_16S fixed point as produced by StereoSGBM; the right map uses the right matcher's
+     * negative convention. Ground truth is CV_32F in pixels with non-positive or non-finite values marking
+     * unknown pixels.
+     */
+    double disparityDensity(const cv::Mat &disparity, int minDisparity = 0);
+
+    // Right pixels the right matcher left unmatched never count as consistent.
+    double leftRightConsistency(const cv::Mat &leftDisparity, const cv::Mat &rightDisparity, int minDisparity,
+                                int numDisparities, int threshold = 1);
+
+    void groundTruthError(const cv::Mat &disparity, const cv::Mat &groundTruth, double badThreshold,
+                          double &badPixelRate, double &endPointError, int minDisparity = 0);
+
+    // Bad-pixel rate for each threshold in one pass, e.g. {0.5, 1, 2, 4} for the usual bad-0.5 ... bad-4.0 table.
+    std::vector<double> badPixelRates(const cv::Mat &disparity, const cv::Mat &groundTruth,
+                                      const std::vector<double> &thresholds, int minDisparity = 0);
+
+    DisparityMetrics evaluateDisparity(const cv::Mat &leftDisparity, const cv::Mat &rightDisparity,
+                                       const cv::Mat &groundTruth, int minDisparity, int numDisparities,
+                                       double badThreshold = 2.0);
+}
+
+#endif //VISION_EVALUATION_METRICS_H
@@ -0,0 +1,53 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_HELPERS_FILE_WATCHER_H
+#define VISION_HELPERS_FILE_WATCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace vlue::utils {
+    /**
+     * Polls a file's modification time on a background thread and invokes `callback` after it changes.
+     *
+     * Polling keeps this portable and cheap at configuration-file rates. The callback runs on the watcher
+     * thread; exceptions it throws are reported and swallowed so a bad edit does not stop the watch.
+     */
+    class FileWatcher {
+    public:
+        using Callback = std::function<void(const std::string &path)>;
+
+    private:
+        std::string m_Path;
+        Callback m_Callback;
+        std::chrono::milliseconds m_Interval;
+        std::filesystem::file_time_type m_LastWrite;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Cv;
+        bool m_Stop = false;
+        std::thread m_Thread;
+
+    public:
+        FileWatcher(std::string path, Callback callback,
+                    std::chrono::milliseconds interval = std::chrono::milliseconds(500));
+        FileWatcher(const FileWatcher &) = delete;
+        FileWatcher &operator=(const FileWatcher &) = delete;
+        ~FileWatcher();
+
+        void stop();
+        [[nodiscard]] const std::string &getPath() const { return m_Path; }
+
+    private:
+        void run_();
+    };
+}
+
+#endif //VISION_HELPERS_FILE_WATCHER_H
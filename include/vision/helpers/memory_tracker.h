@@ -0,0 +1,107 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_HELPERS_MEMORY_TRACKER_H
+#define VISION_HELPERS_MEMORY_TRACKER_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace vlue::utils {
+    struct MemoryStats {
+        std::string region;
+        int64_t currentBytes{0};
+        int64_t peakBytes{0};
+        uint64_t allocations{0};
+        uint64_t deallocations{0};
+    };
+
+    /**
+     * Per-region accounting of cv::Mat buffers.
+     *
+     * install() makes a tracking cv::MatAllocator the OpenCV default. Every buffer it hands out is charged to
+     * the innermost ScopedMemoryRegion open on the allocating thread and credited back to the same region when
+     * released, whichever thread releases it. Threads without a region of their own, such as OpenCV's
+     * parallel_for_ workers, charge the most recently opened region that is still open, or "unscoped" if
+     * there is none. With several threads inside regions at once that is a best guess: a worker is charged to
+     * the newest region, not necessarily the one whose parallel_for_ it runs, and once scopes on three or more
+     * threads close out of order the fallback may drop to "unscoped" early.
+     *
+     * Only cv::Mat storage is seen: buffers allocated through other means (std::vector, cv::AutoBuffer, raw
+     * malloc) inside OpenCV are not. While nothing is installed regions cost one atomic load.
+     */
+    class MemoryTracker {
+    public:
+        struct Region;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_Impl;
+
+        MemoryTracker();
+
+    public:
+        // Lives until exit so buffers released during static destruction can still be credited.
+        static MemoryTracker &instance();
+
+        // Buffers allocated before install() keep their allocator and are never counted.
+        void install();
+        // Restores the previous default allocator; buffers allocated meanwhile are still credited on release.
+        void uninstall();
+        [[nodiscard]] bool isInstalled() const;
+
+        // Lookups take the registry lock: resolve a region once, e.g. with regionOf<T>() or when a stage is
+        // registered, and open scopes with the Region * rather than by name per frame.
+        [[nodiscard]] Region *region(const std::string &name);
+        // Region named after the demangled type without namespaces, e.g. "SpeckleFilterPipeline".
+        [[nodiscard]] Region *region(const std::type_info &type);
+        // instance().region(typeid(Tp)), resolved on the first call only.
+        template<typename Tp>
+        [[nodiscard]] static Region *regionOf() {
+            static Region *const region = instance().region(typeid(Tp));
+            return region;
+        }
+        [[nodiscard]] std::vector<MemoryStats> snapshot() const;
+        // Zeroed statistics if the region was never used.
+        [[nodiscard]] MemoryStats stats(const std::string &name) const;
+        // Peak := current, e.g. after warm-up.
+        void resetPeaks();
+
+        void dump(std::ostream &os) const;
+        void startPeriodicDump(std::chrono::milliseconds interval, std::ostream &os = std::cerr);
+        void stopPeriodicDump();
+
+        ~MemoryTracker();
+        MemoryTracker(const MemoryTracker &) = delete;
+        MemoryTracker &operator=(const MemoryTracker &) = delete;
+    };
+
+    // Opening and closing a scope is lock-free; only the by-name constructors look the region up.
+    class ScopedMemoryRegion {
+    private:
+        MemoryTracker::Region *m_Region{nullptr};
+        MemoryTracker::Region *m_Previous{nullptr};
+        // Fallback region this scope replaced, restored on close if that region is still open somewhere.
+        MemoryTracker::Region *m_PreviousFallback{nullptr};
+
+    public:
+        explicit ScopedMemoryRegion(MemoryTracker::Region *region);
+        explicit ScopedMemoryRegion(const char *name);
+        explicit ScopedMemoryRegion(const std::string &name) : ScopedMemoryRegion(name.c_str()) {}
+        ~ScopedMemoryRegion();
+
+        ScopedMemoryRegion(const ScopedMemoryRegion &) = delete;
+        ScopedMemoryRegion &operator=(const ScopedMemoryRegion &) = delete;
+
+    private:
+        void enter_(MemoryTracker::Region *region);
+    };
+}
+
+#endif //VISION_HELPERS_MEMORY_TRACKER_H
@@ -0,0 +1,84 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_HELPERS_RCU_H
+#define VISION_HELPERS_RCU_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace vlue::utils {
+    /**
+     * Read-copy-update cell holding a std::shared_ptr<T>.
+     *
+     * load() never blocks: it registers with the current epoch, copies the current pointer and leaves. The copy
+     * keeps the snapshot alive for as long as the reader needs it, e.g. for the duration of a frame. store()
+     * publishes a new value with a single atomic exchange, flips the epoch and only waits, off the hot path, for
+     * the readers registered with the previous epoch, i.e. those that might still be copying the previous holder.
+     * Readers arriving meanwhile count against the new epoch, so a steady stream of loads cannot starve a store.
+     * The old value is then freed once its last snapshot is released.
+     */
+    template<typename Tp>
+    class RcuCell {
+    private:
+        std::atomic<std::shared_ptr<Tp> *> m_Current;
+        mutable std::atomic<uint64_t> m_Epoch{0};
+        // Readers in flight, per epoch parity.
+        mutable std::atomic<int> m_Readers[2]{};
+        std::mutex m_WriteMutex;
+
+    public:
+        explicit RcuCell(std::shared_ptr<Tp> value = nullptr)
+            : m_Current(new std::shared_ptr<Tp>(std::move(value))) {}
+
+        // Copies take a snapshot of the other cell; the two cells are independent afterwards.
+        RcuCell(const RcuCell &other) : RcuCell(other.load()) {}
+
+        RcuCell &operator=(const RcuCell &other) {
+            if (this != &other) {
+                store(other.load());
+            }
+            return *this;
+        }
+
+        ~RcuCell() {
+            delete m_Current.load();
+        }
+
+        [[nodiscard]] std::shared_ptr<Tp> load() const {
+            for (;;) {
+                const uint64_t epoch = m_Epoch.load();
+                std::atomic<int> &readers = m_Readers[epoch & 1];
+                readers.fetch_add(1);
+                // A store() that flipped in between may already be past waiting for this counter; retry so the
+                // copy below is always covered by the wait of any store() that could free what it reads.
+                if (m_Epoch.load() == epoch) {
+                    std::shared_ptr<Tp> value = *m_Current.load();
+                    readers.fetch_sub(1);
+                    return value;
+                }
+                readers.fetch_sub(1);
+            }
+        }
+
+        void store(std::shared_ptr<Tp> value) {
+            auto *next = new std::shared_ptr<Tp>(std::move(value));
+            std::lock_guard<std::mutex> lock(m_WriteMutex);
+            auto *previous = m_Current.exchange(next);
+            // Readers of the previous epoch may have loaded `previous`; everyone registering from now on sees
+            // the new epoch and therefore `next`.
+            const uint64_t epoch = m_Epoch.fetch_add(1);
+            while (m_Readers[epoch & 1].load() != 0) {
+                std::this_thread::yield();
+            }
+            delete previous;
+        }
+    };
+}
+
+#endif //VISION_HELPERS_RCU_H
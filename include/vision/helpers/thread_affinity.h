@@ -0,0 +1,51 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_HELPERS_THREAD_AFFINITY_H
+#define VISION_HELPERS_THREAD_AFFINITY_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace vlue::utils {
+    /**
+     * Where a thread ended up after placeCurrentThread(). `cpus` is the affinity actually in effect, which is
+     * the whole machine when nothing was requested or pinning failed; `error` explains any part that failed.
+     */
+    struct ThreadPlacement {
+        std::string role;
+        std::vector<int> requestedCpus;
+        std::vector<int> cpus;
+        std::vector<int> numaNodes;
+        int priority{0};  // SCHED_FIFO priority in effect, 0 for the default policy
+        bool numaLocal{false};
+        std::string error;
+    };
+
+    // "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}. Throws std::invalid_argument on malformed lists.
+    std::vector<int> parseCpuList(const std::string &list);
+    std::string formatCpuList(const std::vector<int> &cpus);
+
+    /**
+     * Pin the calling thread to `cpus` (empty leaves the affinity alone) and, with `priority` > 0, switch it to
+     * SCHED_FIFO at that priority. With `numaLocal` the thread's memory policy prefers the NUMA nodes of its
+     * CPUs, so buffers it allocates and first touches stay local. Threads started afterwards from this one,
+     * including OpenCV's parallel_for_ workers, inherit the affinity.
+     *
+     * Failures (e.g. missing CAP_SYS_NICE for real-time priority) are reported, not thrown. Every call is
+     * recorded for placementReport().
+     */
+    ThreadPlacement placeCurrentThread(const std::string &role, const std::vector<int> &cpus, int priority = 0,
+                                       bool numaLocal = false);
+
+    [[nodiscard]] std::vector<int> currentThreadAffinity();
+    // NUMA node of `cpu`, or -1 if unknown.
+    [[nodiscard]] int numaNodeOfCpu(int cpu);
+
+    [[nodiscard]] std::vector<ThreadPlacement> placementReport();
+    void printPlacementReport(std::ostream &os);
+}
+
+#endif //VISION_HELPERS_THREAD_AFFINITY_H
@@ -0,0 +1,59 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_HELPERS_THREAD_POOL_H
+#define VISION_HELPERS_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace vlue::utils {
+    /**
+     * Fixed set of worker threads draining one FIFO task queue.
+     *
+     * For long-lived pipeline work (decoding, batch frames) that should not compete with cv::parallel_for_'s
+     * own pool for the same short-lived parallel regions. Pending tasks still run on destruction.
+     */
+    class ThreadPool {
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_Cv;
+        std::deque<std::function<void()>> m_Tasks;
+        bool m_Stop = false;
+        std::vector<std::thread> m_Workers;
+
+    public:
+        // 0 uses one thread per hardware thread. `onStart(index)` runs first on each worker, e.g. to pin it.
+        explicit ThreadPool(unsigned threads = 0, std::function<void(unsigned)> onStart = nullptr);
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+        ~ThreadPool();
+
+        template<typename F>
+        auto submit(F &&task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+            auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            auto future = packaged->get_future();
+            post([packaged] { (*packaged)(); });
+            return future;
+        }
+
+        // Fire-and-forget; exceptions escaping `task` terminate, so catch inside it.
+        void post(std::function<void()> task);
+
+        [[nodiscard]] std::size_t size() const { return m_Workers.size(); }
+
+    private:
+        void run_(unsigned index, const std::function<void(unsigned)> &onStart);
+    };
+}
+
+#endif //VISION_HELPERS_THREAD_POOL_H
@@ -0,0 +1,114 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_HELPERS_TRACE_H
+#define VISION_HELPERS_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+
+namespace vlue::utils {
+    /**
+     * Span tracing exported as Chrome trace-event JSON (opens in Perfetto and chrome://tracing).
+     *
+     * Each thread appends completed spans to its own chunked buffer: the owner is the only writer, and the
+     * exporter only reads entries the owner has published, so recording takes no lock. Spans carry the frame
+     * sequence set by the innermost TraceFrame on the thread. While tracing is off a TraceSpan is a single
+     * relaxed load and branch.
+     *
+     * Span names and categories must be string literals (or otherwise outlive the trace). Names derived from a
+     * type come from intern(), which takes the registry lock: look them up once, e.g. with nameOf<T>() or when
+     * a stage is registered, rather than per span.
+     */
+    class Tracer {
+    public:
+        static constexpr uint64_t NO_FRAME = ~uint64_t(0);
+
+        [[nodiscard]] static bool isEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+        static void start();
+        static void stop();
+        // Drops recorded spans. Only call it while no traced work is running.
+        static void clear();
+
+        // Label the calling thread in the exported trace.
+        static void setThreadName(const std::string &name);
+
+        static void writeChromeTrace(std::ostream &os);
+        // Returns false if `path` cannot be written.
+        static bool writeChromeTrace(const std::string &path);
+        [[nodiscard]] static std::size_t spanCount();
+
+        // Internal entry points for TraceSpan / TraceFrame.
+        static int64_t now();
+        static void record(const char *name, const char *category, int64_t begin, int64_t end, uint64_t frame);
+        static const char *intern(const std::type_info &type);
+        // intern(typeid(Tp)), resolved on the first call only.
+        template<typename Tp>
+        [[nodiscard]] static const char *nameOf() {
+            static const char *const name = intern(typeid(Tp));
+            return name;
+        }
+        [[nodiscard]] static uint64_t currentFrame() { return s_Frame; }
+
+    private:
+        friend class TraceFrame;
+
+        static inline std::atomic<bool> s_Enabled{false};
+        static inline thread_local uint64_t s_Frame = NO_FRAME;
+    };
+
+    class TraceSpan {
+    private:
+        const char *m_Name{nullptr};
+        const char *m_Category{nullptr};
+        int64_t m_Begin{0};
+        uint64_t m_Frame{Tracer::NO_FRAME};
+
+    public:
+        explicit TraceSpan(const char *name, const char *category = "vision") {
+            if (Tracer::isEnabled()) {
+                begin_(name, category);
+            }
+        }
+
+        ~TraceSpan() {
+            if (m_Name != nullptr) {
+                Tracer::record(m_Name, m_Category, m_Begin, Tracer::now(), m_Frame);
+            }
+        }
+
+        // Tag a span whose frame only becomes known inside it, e.g. a grab.
+        void setFrame(uint64_t frame) { m_Frame = frame; }
+
+        TraceSpan(const TraceSpan &) = delete;
+        TraceSpan &operator=(const TraceSpan &) = delete;
+
+    private:
+        void begin_(const char *name, const char *category) {
+            m_Name = name;
+            m_Category = category;
+            m_Frame = Tracer::currentFrame();
+            m_Begin = Tracer::now();
+        }
+    };
+
+    // Tags spans opened on this thread within its scope with `frame`.
+    class TraceFrame {
+    private:
+        uint64_t m_Previous;
+
+    public:
+        explicit TraceFrame(uint64_t frame) : m_Previous(Tracer::s_Frame) { Tracer::s_Frame = frame; }
+        ~TraceFrame() { Tracer::s_Frame = m_Previous; }
+
+        TraceFrame(const TraceFrame &) = delete;
+        TraceFrame &operator=(const TraceFrame &) = delete;
+    };
+}
+
+#endif //VISION_HELPERS_TRACE_H
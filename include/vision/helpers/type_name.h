@@ -0,0 +1,32 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_HELPERS_TYPE_NAME_H
+#define VISION_HELPERS_TYPE_NAME_H
+
+#include <cstdlib>
+#include <string>
+#include <typeinfo>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace vlue::utils {
+    // Demangled type name without namespaces: vlue::processing::SpeckleFilterPipeline -> "SpeckleFilterPipeline".
+    inline std::string shortTypeName(const std::type_info &type) {
+        std::string name = type.name();
+#if defined(__GNUG__)
+        int status = 0;
+        if (char *demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status)) {
+            if (status == 0) name = demangled;
+            std::free(demangled);
+        }
+#endif
+        const auto lastScope = name.rfind("::", name.find('<'));
+        return lastScope == std::string::npos ? name : name.substr(lastScope + 2);
+    }
+}
+
+#endif //VISION_HELPERS_TYPE_NAME_H
@@ -0,0 +1,53 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_PIPELINE_GUIDED_FILTER_H
+#define VISION_PIPELINE_GUIDED_FILTER_H
+
+#include "vision/pipeline/pipeline.h"
+
+namespace vlue::processing {
+    /**
+     * Edge-aware disparity smoothing with the fast guided filter (He & Sun, 2015), guided by the left view.
+     *
+     * The linear coefficients are estimated on a grid subsampled by `subsample` and upsampled bilinearly, so the
+     * cost is dominated by a handful of box filters at 1/subsample^2 of the pixels. Invalid disparities are
+     * excluded from the estimate through a validity weight, which keeps them from bleeding into valid regions;
+     * valid pixels whose windows hold almost no valid support keep their input value.
+     *
+     * radius:    window radius at full resolution, larger values smooth more.
+     * eps:       regularisation on the normalised [0, 1] guide, larger values preserve fewer edges.
+     * fillHoles: write the filtered value into invalid pixels that have enough valid support.
+     */
+    class DisparityFastGuidedFilterPipeline : public DisparityFilterPipeline {
+    private:
+        int m_Radius;
+        double m_Eps;
+        int m_Subsample;
+        int m_MinDisparity;
+        bool m_FillHoles;
+
+    public:
+        DisparityFastGuidedFilterPipeline(int radius, double eps, int subsample = 2, int minDisparity = 0,
+                                          bool fillHoles = false, bool enable = true);
+
+        void setRadius(int radius);
+        void setEps(double eps);
+        void setSubsample(int subsample);
+
+        [[nodiscard]] int getRadius() const { return m_Radius; }
+        [[nodiscard]] double getEps() const { return m_Eps; }
+        [[nodiscard]] int getSubsample() const { return m_Subsample; }
+
+        // Non-virtual entry point, used by StaticDisparityPipeline.
+        [[nodiscard]] cv::Mat apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                    const cv::Mat &rightDisparity, const cv::Mat &rightView) const;
+
+    protected:
+        [[nodiscard]] cv::Mat filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                      const cv::Mat &rightDisparity, const cv::Mat &rightView) const override;
+    };
+}
+
+#endif //VISION_PIPELINE_GUIDED_FILTER_H
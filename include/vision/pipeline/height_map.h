@@ -0,0 +1,94 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_PIPELINE_HEIGHT_MAP_H
+#define VISION_PIPELINE_HEIGHT_MAP_H
+
+#include <functional>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/matx.hpp>
+
+#include "vision/pipeline/pipeline.h"
+
+namespace vlue::processing {
+    /**
+     * 2.5D grid over the ground plane. Cell (row, col) covers ground x in [xMin + col * resolution, ...) and
+     * y in [yMin + row * resolution, ...), in the ground frame (x forward, y left, z up).
+     */
+    struct HeightMap {
+        float resolution{0.0f};
+        float xMin{0.0f}, yMin{0.0f};
+        // CV_32F: highest point above the ground per cell, NaN where the cell was not observed.
+        cv::Mat height;
+        // CV_32S: points that fell into each cell.
+        cv::Mat count;
+        // CV_8S, as in nav_msgs/OccupancyGrid: -1 unknown, 0 free, 100 occupied.
+        cv::Mat occupancy;
+    };
+
+    /**
+     * Projects disparity straight into a ground-plane height / occupancy grid, without building a point cloud.
+     *
+     * Every valid pixel is mapped through `cameraToGround * Q` and binned into the grid, keeping the highest
+     * point per cell. The terms of that 4x4 product depending on the row are evaluated once per row, the u and d
+     * terms per pixel. Each row stripe is projected into a partial grid of its own; the partial grids are merged
+     * at the end.
+     */
+    class HeightMapPipeline : public DisparityFilterPipeline {
+    public:
+        using Callback = std::function<void(const HeightMap &map)>;
+
+        struct Parameters {
+            int minDisparity{0};
+            // Camera frame (x right, y down, z forward) to ground frame; see cameraToGround(). The default is a
+            // level camera at ground height.
+            cv::Matx44d cameraToGround{0, 0, 1, 0,
+                                       -1, 0, 0, 0,
+                                       0, -1, 0, 0,
+                                       0, 0, 0, 1};
+            float resolution{0.05f};
+            float xMin{0.0f}, xMax{10.0f};
+            float yMin{-5.0f}, yMax{5.0f};
+            // Points outside this height band (noise under the floor, ceilings) are dropped.
+            float minHeight{-0.5f}, maxHeight{2.0f};
+            // A cell is occupied if its highest point is above this, free otherwise.
+            float obstacleHeight{0.15f};
+            // Cells with fewer points stay unknown.
+            int minPoints{3};
+            // Project every `pixelStep`-th pixel of every `pixelStep`-th row.
+            int pixelStep{1};
+        };
+
+    private:
+        Parameters m_Params;
+        cv::Matx44d m_Q;
+        Callback m_Callback;
+
+    public:
+        // `Q` is the 4x4 reprojection matrix of the rectified pair, e.g. StereoCamera::Q.
+        HeightMapPipeline(const Parameters &params, const cv::Mat &Q, Callback callback = nullptr, bool enable = true);
+
+        void setCallback(Callback callback) { m_Callback = std::move(callback); }
+        [[nodiscard]] const Parameters &getParameters() const { return m_Params; }
+
+        // Camera `height` metres above flat ground, pitched down by `pitch` radians, no roll.
+        static cv::Matx44d cameraToGround(double height, double pitch);
+
+        // One-shot projection of a CV_16S disparity map.
+        static HeightMap build(const cv::Mat &disparity, const cv::Mat &Q, const Parameters &params);
+
+        // Hands build() of leftDisparity to the callback and returns leftDisparity itself.
+        [[nodiscard]] cv::Mat apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                    const cv::Mat &rightDisparity, const cv::Mat &rightView) const;
+
+    protected:
+        [[nodiscard]] cv::Mat filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                      const cv::Mat &rightDisparity, const cv::Mat &rightView) const override;
+
+    private:
+        static HeightMap build_(const cv::Mat &disparity, const cv::Matx44d &Q, const Parameters &params);
+    };
+}
+
+#endif //VISION_PIPELINE_HEIGHT_MAP_H
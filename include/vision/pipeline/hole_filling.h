@@ -0,0 +1,51 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_PIPELINE_HOLE_FILLING_H
+#define VISION_PIPELINE_HOLE_FILLING_H
+
+#include "vision/pipeline/pipeline.h"
+
+namespace vlue::processing {
+    /**
+     * Scanline filling of invalid disparity runs, one row per task.
+     *
+     * Background mode copies the smaller of the two bounding disparities into the run. Holes are mostly
+     * occlusions, and those belong to the farther surface. Interpolate mode blends linearly between the two ends.
+     * Runs wider than `maxHoleWidth` pixels (0 = unlimited) are left invalid.
+     *
+     * The stage works in place: the input disparity buffer is modified and returned.
+     */
+    class HoleFillingPipeline : public DisparityFilterPipeline {
+    public:
+        enum class Mode {
+            Background,
+            Interpolate,
+        };
+
+    private:
+        Mode m_Mode;
+        int m_MaxHoleWidth;
+        int m_MinDisparity;
+
+    public:
+        explicit HoleFillingPipeline(Mode mode = Mode::Background, int maxHoleWidth = 0, int minDisparity = 0,
+                                     bool enable = true);
+
+        [[nodiscard]] Mode getMode() const { return m_Mode; }
+        [[nodiscard]] int getMaxHoleWidth() const { return m_MaxHoleWidth; }
+
+        // Non-virtual entry point, used by StaticDisparityPipeline.
+        [[nodiscard]] cv::Mat apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                    const cv::Mat &rightDisparity, const cv::Mat &rightView) const;
+
+    protected:
+        [[nodiscard]] cv::Mat filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                      const cv::Mat &rightDisparity, const cv::Mat &rightView) const override;
+    };
+
+    using HoleFillingMode = HoleFillingPipeline::Mode;
+}
+
+#endif //VISION_PIPELINE_HOLE_FILLING_H
@@ -0,0 +1,56 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_PIPELINE_LR_CHECK_H
+#define VISION_PIPELINE_LR_CHECK_H
+
+#include "vision/pipeline/pipeline.h"
+
+namespace vlue::processing {
+    /**
+     * Left-right consistency check with optional parabolic subpixel refinement.
+     *
+     * A left disparity d at x survives when the right disparity at x - d agrees within `threshold` pixels. The
+     * right map follows the cv::ximgproc::createRightMatcher convention (negative disparities) and is mirrored
+     * before the comparison, so agreement is tested as |dL - (-dR)| <= threshold. The right matcher marks its
+     * unmatched pixels with a value that mirrors to minDisparity + numDisparities, one pixel past the left range,
+     * which a threshold of one would accept; with `numDisparities` set such right pixels never agree. Left pixels
+     * landing outside the image or on an unmatched right pixel are set to the matcher's invalid value.
+     *
+     * With `subpixel` enabled, surviving pixels are re-fitted with a parabola through the block SAD costs at
+     * d - 1, d and d + 1 over a (2 * subpixelRadius + 1)^2 window of the rectified views. This is mostly useful
+     * for integer-precision inputs, e.g. after hole filling or upsampling.
+     *
+     * The input disparity is left untouched; the checked map is returned in a new buffer.
+     */
+    class DisparityLRCheckPipeline : public DisparityFilterPipeline {
+    private:
+        int m_Threshold;
+        bool m_Subpixel;
+        int m_SubpixelRadius;
+        int m_MinDisparity;
+        int m_NumDisparities;
+
+    public:
+        // numDisparities is the left matcher's; 0 skips detecting unmatched right pixels.
+        explicit DisparityLRCheckPipeline(int threshold = 1, bool subpixel = false, int subpixelRadius = 2,
+                                          int minDisparity = 0, int numDisparities = 0, bool enable = true);
+
+        void setThreshold(int threshold) { m_Threshold = threshold; }
+        void setSubpixel(bool subpixel) { m_Subpixel = subpixel; }
+
+        [[nodiscard]] int getThreshold() const { return m_Threshold; }
+        [[nodiscard]] bool getSubpixel() const { return m_Subpixel; }
+
+        // Non-virtual entry point, used by StaticDisparityPipeline.
+        [[nodiscard]] cv::Mat apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                    const cv::Mat &rightDisparity, const cv::Mat &rightView) const;
+
+    protected:
+        [[nodiscard]] cv::Mat filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                      const cv::Mat &rightDisparity, const cv::Mat &rightView) const override;
+    };
+}
+
+#endif //VISION_PIPELINE_LR_CHECK_H
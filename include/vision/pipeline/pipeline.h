@@ -7,6 +7,8 @@
 
 #include <memory>
 
+#include "vision/helpers/rcu.h"
+
 namespace cv {
     namespace ximgproc {
         class DisparityFilter;
@@ -21,6 +23,7 @@ namespace vlue::processing {
         enum class Type {
             Image,
             DisparityMap,
+            Pointwise,
         };
         Pipeline() = default; // Default constructor
         Pipeline(const Pipeline&) = default; // Copy constructor
@@ -42,7 +45,7 @@ namespace vlue::processing {
 
     class DisparityFilterPipeline : public Pipeline {
     public:
-        DisparityFilterPipeline() = default;
+        DisparityFilterPipeline() { m_Type = Type::DisparityMap; }
         DisparityFilterPipeline(const DisparityFilterPipeline&) = default;
         DisparityFilterPipeline(DisparityFilterPipeline&&) = default;
         DisparityFilterPipeline& operator=(const DisparityFilterPipeline&) = default;
@@ -55,17 +58,24 @@ namespace vlue::processing {
 
     protected:
         [[nodiscard]] virtual cv::Mat filter_(const cv::Mat &leftDisparity, [[maybe_unused]] const cv::Mat &leftView, [[maybe_unused]] const cv::Mat &rightDisparity, [[maybe_unused]] const cv::Mat &rightView) const = 0;
-
-    protected:
-        Type m_Type = Type::DisparityMap;
     };
 
     class DisparityWLSFilterPipeline : public DisparityFilterPipeline {
     private:
-        std::shared_ptr<cv::ximgproc::DisparityWLSFilter> m_Filter;
+        utils::RcuCell<cv::ximgproc::DisparityWLSFilter> m_Filter;
     public:
         DisparityWLSFilterPipeline(double lambda, double sigmaColor, int LRCThresh, int discRadius, bool enable = true);
 
+        // Build a filter with new parameters and swap it in; frames already filtering finish with the old one.
+        void updateParameters(double lambda, double sigmaColor, int LRCThresh, int discRadius);
+
+        [[nodiscard]] double getLambda() const;
+        [[nodiscard]] double getSigmaColor() const;
+
+        // Non-virtual entry point, used by StaticDisparityPipeline.
+        [[nodiscard]] cv::Mat apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                    const cv::Mat &rightDisparity, const cv::Mat &rightView) const;
+
     protected:
         [[nodiscard]] cv::Mat filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView, const cv::Mat &rightDisparity,
                         const cv::Mat &rightView) const override;
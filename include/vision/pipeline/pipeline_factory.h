@@ -0,0 +1,49 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_PIPELINE_PIPELINE_FACTORY_H
+#define VISION_PIPELINE_PIPELINE_FACTORY_H
+
+#include <memory>
+#include <vector>
+
+namespace YAML {
+    class Node;
+}
+
+namespace vlue::processing {
+    class Pipeline;
+    using PipelinePtr = std::shared_ptr<Pipeline>;
+
+    /**
+     * Builds pipeline stages from YAML so chains can live in the disparity configuration:
+     *
+     *     postprocess:
+     *       - type: wls
+     *         lambda: 8000.0
+     *         sigmaColor: 1.5
+     *       - type: speckle
+     *         maxSpeckleSize: 200
+     *         speckleRange: 2
+     *
+     * Known types: wls, guided, lr_check, speckle, hole_filling, scale, threshold, clamp, convert.
+     * Every stage also accepts `enable` (default true).
+     */
+    class PipelineFactory {
+    public:
+        static PipelinePtr create(const YAML::Node &config);
+
+        // Build every entry of a YAML sequence; a missing node yields an empty chain.
+        static std::vector<PipelinePtr> createAll(const YAML::Node &config);
+
+        /**
+         * Push `config` into a running stage of the same type, e.g. after the configuration file changed.
+         * Only stages that can swap their parameters safely while frames are in flight are updated (wls);
+         * returns false for the others, which keep the parameters they were created with.
+         */
+        static bool update(Pipeline &pipeline, const YAML::Node &config);
+    };
+}
+
+#endif //VISION_PIPELINE_PIPELINE_FACTORY_H
@@ -0,0 +1,108 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_PIPELINE_POINTWISE_H
+#define VISION_PIPELINE_POINTWISE_H
+
+#include "vision/pipeline/pipeline.h"
+
+#include <vector>
+
+namespace vlue::processing {
+    /**
+     * A stage whose output pixel depends only on the same input pixel.
+     *
+     * Kernels run on float samples, channels interleaved, so a chain of them can be evaluated tile by tile
+     * without materialising intermediate images. Used on its own, a pointwise stage is a single fused pass.
+     * Streams must have a depth float holds exactly (8U, 8S, 16U, 16S or 32F); 32S and 64F are rejected.
+     */
+    class PointwisePipeline : public Pipeline {
+    public:
+        PointwisePipeline() { m_Type = Type::Pointwise; }
+
+        // Transform `count` samples in place.
+        virtual void apply(float *data, int count) const = 0;
+
+        // Depth (CV_8U, CV_16S, ...) of the samples this stage produces, or -1 to keep the incoming depth.
+        [[nodiscard]] virtual int outputDepth() const { return -1; }
+
+        [[nodiscard]] cv::Mat process(const cv::Mat &inputImage) const override;
+    };
+
+    // dst = alpha * src + beta
+    class ScalePipeline : public PointwisePipeline {
+    private:
+        float m_Alpha, m_Beta;
+    public:
+        explicit ScalePipeline(double alpha, double beta = 0.0, bool enable = true);
+        void apply(float *data, int count) const override;
+    };
+
+    // Same semantics as cv::threshold for the non-adaptive binary/trunc/to-zero types.
+    class ThresholdPipeline : public PointwisePipeline {
+    public:
+        enum class Mode {
+            Binary,
+            BinaryInv,
+            Trunc,
+            ToZero,
+            ToZeroInv,
+        };
+    private:
+        float m_Threshold, m_MaxValue;
+        Mode m_Mode;
+    public:
+        ThresholdPipeline(double threshold, double maxValue, Mode mode = Mode::Binary, bool enable = true);
+        void apply(float *data, int count) const override;
+    };
+
+    // dst = min(max(src, low), high)
+    class ClampPipeline : public PointwisePipeline {
+    private:
+        float m_Low, m_High;
+    public:
+        ClampPipeline(double low, double high, bool enable = true);
+        void apply(float *data, int count) const override;
+    };
+
+    // Changes the depth of the stream. Integer targets round and saturate exactly like cv::Mat::convertTo.
+    class ConvertPipeline : public PointwisePipeline {
+    private:
+        int m_Depth;
+    public:
+        explicit ConvertPipeline(int depth, bool enable = true);
+        void apply(float *data, int count) const override;
+        [[nodiscard]] int outputDepth() const override { return m_Depth; }
+    };
+
+    /**
+     * Runs adjacent pointwise stages as one pass: each worker converts a tile of a row to float, applies every
+     * enabled kernel while the tile is in cache, and stores it once in the final depth.
+     *
+     * Between kernels an integer stream is rounded and saturated to its depth, exactly where running the stages
+     * one by one would store it, so fusing never changes the result (Scale(0.5) then Scale(2) on 3 gives 4
+     * either way).
+     */
+    class FusedPointwisePipeline : public Pipeline {
+    private:
+        std::vector<std::shared_ptr<PointwisePipeline>> m_Stages;
+        std::vector<const PointwisePipeline *> m_Kernels;
+    public:
+        explicit FusedPointwisePipeline(std::vector<std::shared_ptr<PointwisePipeline>> stages);
+
+        [[nodiscard]] cv::Mat process(const cv::Mat &inputImage) const override;
+        [[nodiscard]] size_t size() const { return m_Stages.size(); }
+
+        // Replace every run of two or more adjacent pointwise stages with a fused stage; other stages are kept.
+        static std::vector<std::shared_ptr<Pipeline>> fuse(const std::vector<std::shared_ptr<Pipeline>> &pipelines);
+
+        // Evaluate `stages` over `src` in one tiled pass. Disabled stages are skipped.
+        static cv::Mat run(const cv::Mat &src, const std::vector<const PointwisePipeline *> &stages);
+        static cv::Mat run(const cv::Mat &src, const PointwisePipeline *const *stages, size_t count);
+    };
+
+    using ThresholdMode = ThresholdPipeline::Mode;
+}
+
+#endif //VISION_PIPELINE_POINTWISE_H
@@ -0,0 +1,44 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_PIPELINE_SPECKLE_FILTER_H
+#define VISION_PIPELINE_SPECKLE_FILTER_H
+
+#include "vision/pipeline/pipeline.h"
+
+namespace vlue::processing {
+    /**
+     * Parallel replacement for SGBM's single-threaded speckleWindowSize filtering.
+     *
+     * Neighbouring valid pixels whose disparities differ by at most `speckleRange` pixels belong to the same
+     * blob. Blobs smaller than `maxSpeckleSize` pixels are invalidated. Labelling runs a union-find per
+     * horizontal stripe in parallel, then a short sequential pass merges labels across stripe seams. The labelling
+     * buffers are kept per calling thread and reused from frame to frame, so apply may run concurrently.
+     *
+     * The stage works in place: the input disparity buffer is modified and returned. Disable the matcher's own
+     * speckle filter (speckleWindowSize = 0) when using it.
+     */
+    class SpeckleFilterPipeline : public DisparityFilterPipeline {
+    private:
+        int m_MaxSpeckleSize;
+        int m_SpeckleRange;
+        int m_MinDisparity;
+
+    public:
+        SpeckleFilterPipeline(int maxSpeckleSize, int speckleRange, int minDisparity = 0, bool enable = true);
+
+        [[nodiscard]] int getMaxSpeckleSize() const { return m_MaxSpeckleSize; }
+        [[nodiscard]] int getSpeckleRange() const { return m_SpeckleRange; }
+
+        // Non-virtual entry point, used by StaticDisparityPipeline.
+        [[nodiscard]] cv::Mat apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                    const cv::Mat &rightDisparity, const cv::Mat &rightView) const;
+
+    protected:
+        [[nodiscard]] cv::Mat filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                      const cv::Mat &rightDisparity, const cv::Mat &rightView) const override;
+    };
+}
+
+#endif //VISION_PIPELINE_SPECKLE_FILTER_H
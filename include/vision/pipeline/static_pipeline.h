@@ -0,0 +1,119 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_PIPELINE_STATIC_PIPELINE_H
+#define VISION_PIPELINE_STATIC_PIPELINE_H
+
+#include "vision/pipeline/pipeline.h"
+#include "vision/pipeline/pointwise.h"
+#include "vision/helpers/memory_tracker.h"
+#include "vision/helpers/trace.h"
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <opencv2/core/mat.hpp>
+
+namespace vlue::processing {
+    /**
+     * A post-processing chain fixed at compile time.
+     *
+     * Stages are held by value in a tuple and run in declaration order through their non-virtual `apply`. No
+     * shared_ptr, no getType() check, no dynamic cast and no per-stage try/catch. Errors propagate to the caller.
+     * Disparity stages are any type with
+     *
+     *     cv::Mat apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+     *                   const cv::Mat &rightDisparity, const cv::Mat &rightView) const;
+     *
+     * and pointwise stages (PointwisePipeline subclasses) run on the disparity. Consecutive pointwise stages are
+     * grouped at compile time and run as one tiled pass (see FusedPointwisePipeline), without allocating.
+     *
+     *     StaticDisparityPipeline post{DisparityLRCheckPipeline(1), SpeckleFilterPipeline(200, 2)};
+     *     sgbm.computeDisparity(left, right, leftDisparity, rightDisparity, post);
+     *
+     * The runtime path through registerPostprocessPipeline stays available for chains configured at runtime.
+     */
+    template<typename... Stages>
+    class StaticDisparityPipeline {
+    private:
+        std::tuple<Stages...> m_Stages;
+
+    public:
+        explicit StaticDisparityPipeline(Stages... stages) : m_Stages(std::move(stages)...) {}
+
+        template<std::size_t I>
+        [[nodiscard]] auto &get() { return std::get<I>(m_Stages); }
+
+        template<std::size_t I>
+        [[nodiscard]] const auto &get() const { return std::get<I>(m_Stages); }
+
+        static constexpr std::size_t size() { return sizeof...(Stages); }
+
+        void operator()(cv::Mat &leftDisparity, const cv::Mat &leftView, const cv::Mat &rightDisparity,
+                        const cv::Mat &rightView) const {
+            runFrom_<0>(leftDisparity, leftView, rightDisparity, rightView);
+        }
+
+    private:
+        template<std::size_t I>
+        static constexpr bool isPointwise_() {
+            if constexpr (I < sizeof...(Stages)) {
+                return std::is_base_of_v<PointwisePipeline, std::tuple_element_t<I, std::tuple<Stages...>>>;
+            } else {
+                return false;
+            }
+        }
+
+        // One past the last stage of the run of pointwise stages starting at I.
+        template<std::size_t I>
+        static constexpr std::size_t pointwiseEnd_() {
+            if constexpr (isPointwise_<I>()) {
+                return pointwiseEnd_<I + 1>();
+            } else {
+                return I;
+            }
+        }
+
+        template<std::size_t I>
+        void runFrom_(cv::Mat &leftDisparity, const cv::Mat &leftView, const cv::Mat &rightDisparity,
+                      const cv::Mat &rightView) const {
+            if constexpr (I < sizeof...(Stages)) {
+                if constexpr (isPointwise_<I>()) {
+                    constexpr std::size_t end = pointwiseEnd_<I>();
+                    runPointwise_<I>(std::make_index_sequence<end - I>(), leftDisparity);
+                    runFrom_<end>(leftDisparity, leftView, rightDisparity, rightView);
+                } else {
+                    using Stage = std::tuple_element_t<I, std::tuple<Stages...>>;
+                    const Stage &stage = std::get<I>(m_Stages);
+                    if (stage.isEnabled()) {
+                        const utils::ScopedMemoryRegion region(utils::MemoryTracker::regionOf<Stage>());
+                        const utils::TraceSpan span(utils::Tracer::nameOf<Stage>(), "postprocess");
+                        leftDisparity = stage.apply(leftDisparity, leftView, rightDisparity, rightView);
+                    }
+                    runFrom_<I + 1>(leftDisparity, leftView, rightDisparity, rightView);
+                }
+            }
+        }
+
+        template<std::size_t First, std::size_t... Is>
+        void runPointwise_(std::index_sequence<Is...>, cv::Mat &leftDisparity) const {
+            if (!(std::get<First + Is>(m_Stages).isEnabled() || ...)) {
+                return;
+            }
+            // A lone stage keeps its own name in the memory and trace reports.
+            using Named = std::conditional_t<sizeof...(Is) == 1,
+                                             std::tuple_element_t<First, std::tuple<Stages...>>,
+                                             FusedPointwisePipeline>;
+            const utils::ScopedMemoryRegion region(utils::MemoryTracker::regionOf<Named>());
+            const utils::TraceSpan span(utils::Tracer::nameOf<Named>(), "postprocess");
+            const PointwisePipeline *const stages[] = {&std::get<First + Is>(m_Stages)...};
+            leftDisparity = FusedPointwisePipeline::run(leftDisparity, stages, sizeof...(Is));
+        }
+    };
+
+    template<typename... Stages>
+    StaticDisparityPipeline(Stages...) -> StaticDisparityPipeline<Stages...>;
+}
+
+#endif //VISION_PIPELINE_STATIC_PIPELINE_H
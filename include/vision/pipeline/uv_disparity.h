@@ -0,0 +1,83 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_PIPELINE_UV_DISPARITY_H
+#define VISION_PIPELINE_UV_DISPARITY_H
+
+#include <functional>
+#include <vector>
+#include <opencv2/core/mat.hpp>
+
+#include "vision/pipeline/pipeline.h"
+
+namespace vlue::processing {
+    // A column of the image where something stands above the ground at integer disparity `disparity`.
+    struct ObstacleColumn {
+        int u{0};
+        int disparity{0};
+        // Rows spanned by the obstacle's pixels in this column.
+        int top{0}, bottom{0};
+        // Above-ground pixels at this disparity in the column.
+        int count{0};
+    };
+
+    struct UVDisparitySummary {
+        // Ground line in V-disparity: row v = groundSlope * disparity + groundIntercept.
+        bool hasGround{false};
+        double groundSlope{0.0};
+        double groundIntercept{0.0};
+        int groundInliers{0};
+        // At most one per image column: the nearest obstacle, left to right.
+        std::vector<ObstacleColumn> obstacles;
+        // CV_32S histograms, rows x numDisparities (V) and numDisparities x cols (U). Filled on request only.
+        cv::Mat vDisparity, uDisparity;
+    };
+
+    /**
+     * Ground and obstacle detection from U- and V-disparity histograms, without reprojecting to 3D.
+     *
+     * The V-disparity histogram is built one image row per task. A flat ground plane is a straight line in it,
+     * which is fitted robustly to the dominant disparity of each row. The U-disparity histogram is then built
+     * from the pixels above that line, one stripe of 64 image columns per task. Obstacles are U-disparity cells
+     * holding at least `minObstacleHeight` pixels.
+     */
+    class UVDisparityPipeline : public DisparityFilterPipeline {
+    public:
+        using Callback = std::function<void(const UVDisparitySummary &summary)>;
+
+        struct Parameters {
+            int minDisparity{0};
+            int numDisparities{64};
+            // Rows within this distance of the ground line count as ground.
+            double groundTolerance{2.0};
+            // Disparities below this are too far away to fit the ground reliably.
+            int minGroundDisparity{2};
+            int minObstacleHeight{20};
+            bool keepHistograms{false};
+        };
+
+    private:
+        Parameters m_Params;
+        Callback m_Callback;
+
+    public:
+        explicit UVDisparityPipeline(const Parameters &params, Callback callback = nullptr, bool enable = true);
+
+        void setCallback(Callback callback) { m_Callback = std::move(callback); }
+        [[nodiscard]] const Parameters &getParameters() const { return m_Params; }
+
+        // One-shot analysis of a CV_16S disparity map.
+        static UVDisparitySummary analyze(const cv::Mat &disparity, const Parameters &params);
+
+        // Reports analyze(leftDisparity) to the callback and returns leftDisparity itself.
+        [[nodiscard]] cv::Mat apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                    const cv::Mat &rightDisparity, const cv::Mat &rightView) const;
+
+    protected:
+        [[nodiscard]] cv::Mat filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                      const cv::Mat &rightDisparity, const cv::Mat &rightView) const override;
+    };
+}
+
+#endif //VISION_PIPELINE_UV_DISPARITY_H
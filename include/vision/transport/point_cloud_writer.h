@@ -0,0 +1,127 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_TRANSPORT_POINT_CLOUD_WRITER_H
+#define VISION_TRANSPORT_POINT_CLOUD_WRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+
+namespace vlue::transport {
+    enum class CloudFormat {
+        PLY,  // binary PLY, host byte order
+        PCD,  // PCL's binary PCD v0.7
+    };
+
+    /**
+     * Streams point clouds to binary PLY or PCD files (POSIX only, see VISION_WITH_POINT_CLOUD_WRITER).
+     *
+     * write() takes the output of cv::reprojectImageTo3D (CV_32FC3, plus an optional CV_8UC3 BGR or CV_8UC1
+     * image for colour), packs the valid points into a recycled buffer and hands it to a background thread.
+     * That thread preallocates the destination file, fills it through a memory mapping and closes it, so the
+     * caller never waits on the file system. If the disk falls behind by more than `queueFrames` clouds, write()
+     * drops the cloud (or waits, with `blockWhenFull`).
+     *
+     * In `PerFrame` mode every cloud gets its own file, `<prefix>_<frame>.ply`. In `Sequence` mode clouds are
+     * appended as complete, self-contained PLY/PCD documents to `<prefix>_part<n>.ply` (or `.pcd`), which rolls
+     * over to the next part after `rollBytes`; split a part by parsing one header at a time.
+     */
+    class PointCloudWriter {
+    public:
+        enum class Mode {
+            PerFrame,
+            Sequence,
+        };
+
+        struct Options {
+            CloudFormat format{CloudFormat::PLY};
+            Mode mode{Mode::PerFrame};
+            // Points further than this (reprojectImageTo3D marks missing disparity with Z = 10000) or not
+            // finite are skipped.
+            float maxDepth{1000.0f};
+            // Sequence mode: the part file grows in steps of `preallocate` bytes and rolls over after `rollBytes`.
+            std::size_t preallocate{std::size_t(64) << 20};
+            std::size_t rollBytes{std::size_t(1) << 30};
+            std::size_t queueFrames{4};
+            bool blockWhenFull{false};
+        };
+
+    private:
+        struct Job {
+            std::vector<uint8_t> body;
+            std::size_t points{0};
+            bool color{false};
+            uint64_t frame{0};
+        };
+
+        std::string m_Prefix;
+        Options m_Options;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Work, m_Space;
+        std::deque<Job> m_Queue;
+        std::vector<std::vector<uint8_t>> m_Buffers;  // recycled job bodies
+        std::size_t m_InFlight{0};  // clouds being packed, queued or stored
+        bool m_Stop{false};
+        uint64_t m_Written{0};
+        uint64_t m_Dropped{0};
+        uint64_t m_Failed{0};
+        uint64_t m_NextFrame{0};
+
+        // Sequence mode state, owned by the writer thread.
+        int m_Fd{-1};
+        uint8_t *m_Map{nullptr};
+        std::size_t m_Capacity{0};
+        std::size_t m_Used{0};
+        unsigned m_Part{0};
+
+        std::thread m_Thread;
+
+    public:
+        // `prefix` is a path without extension, e.g. "/data/run1/cloud". Its directory must exist.
+        PointCloudWriter(std::string prefix, Options options);
+        // Writes everything still queued, then closes the current part file.
+        ~PointCloudWriter();
+
+        PointCloudWriter(const PointCloudWriter &) = delete;
+        PointCloudWriter &operator=(const PointCloudWriter &) = delete;
+
+        /**
+         * Queues one cloud. `frame` names the file in per-frame mode; by default clouds are numbered in the order
+         * they are written. Returns false if the cloud was dropped because the writer is behind.
+         */
+        bool write(const cv::Mat &points, const cv::Mat &colors = cv::Mat(), int64_t frame = -1);
+
+        // Waits until every queued cloud is on disk (in the page cache, as with any write).
+        void flush();
+
+        [[nodiscard]] uint64_t getWritten();
+        [[nodiscard]] uint64_t getDropped();
+        // Clouds lost to I/O errors; the error is logged.
+        [[nodiscard]] uint64_t getFailed();
+
+        // Header of a cloud with `points` points, as written in front of each body.
+        static std::string header(CloudFormat format, std::size_t points, bool color);
+        // Bytes per packed point.
+        static std::size_t pointSize(CloudFormat format, bool color);
+
+    private:
+        void run_();
+        void store_(const Job &job);
+        void storeFile_(const Job &job, const std::string &header);
+        void storeSequence_(const Job &job, const std::string &header);
+        void closePart_();
+        [[nodiscard]] std::string extension_() const;
+    };
+}
+
+#endif //VISION_TRANSPORT_POINT_CLOUD_WRITER_H
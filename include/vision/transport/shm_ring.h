@@ -0,0 +1,118 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_TRANSPORT_SHM_RING_H
+#define VISION_TRANSPORT_SHM_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <opencv2/core/mat.hpp>
+
+namespace vlue::transport {
+    // What a message carries; stored in the slot header for subscribers.
+    enum class PayloadKind : uint32_t {
+        Image = 0,
+        Disparity = 1,
+        PointCloud = 2,
+        Raw = 3,
+    };
+
+    struct MessageInfo {
+        uint64_t sequence{0};  // position in the ring, assigned by the publisher
+        PayloadKind kind{PayloadKind::Raw};
+        int rows{0};
+        int cols{0};
+        int type{0};  // OpenCV matrix type
+        uint64_t frameSequence{0};
+        int64_t timestamp{0};  // nanoseconds, caller-defined clock
+        std::size_t size{0};  // payload bytes; rows are packed without padding
+    };
+
+    class ShmSegment;
+
+    /**
+     * Shared-memory ring of fixed-size slots in /dev/shm, for handing frames, disparity maps and point clouds
+     * to other processes on the same host (POSIX only, see VISION_WITH_SHM).
+     *
+     * One publisher owns the segment; any number of subscribers map it read-only. Message n goes to slot
+     * n % slotCount, guarded by a per-slot seqlock: the slot's version is odd while it is being written and
+     * 2 * (n + 1) once message n is complete. Readers never take a lock and never block the publisher; they
+     * compare versions to notice messages that were overwritten before or while they were read, and skip
+     * ahead when they fall more than a ring behind. Messages are served as cv::Mat views into the mapping, so
+     * fan-out to several consumers costs no copies.
+     */
+    class ShmPublisher {
+    private:
+        std::shared_ptr<ShmSegment> m_Segment;
+        uint64_t m_Next{0};
+        bool m_Writing{false};
+
+    public:
+        // Creates (or replaces) the segment `name`; `slotSize` is the payload capacity of each slot in bytes.
+        ShmPublisher(const std::string &name, std::size_t slotSize, uint32_t slotCount = 8);
+        // Unlinks the segment; subscribers that still map it keep reading the last messages.
+        ~ShmPublisher();
+
+        ShmPublisher(const ShmPublisher &) = delete;
+        ShmPublisher &operator=(const ShmPublisher &) = delete;
+
+        // Copies `data` into the next slot and publishes it. Returns the message sequence.
+        uint64_t publish(const cv::Mat &data, PayloadKind kind, uint64_t frameSequence = 0, int64_t timestamp = 0);
+
+        /**
+         * Zero-copy publishing: returns a view of the next slot for the producer to fill in place (e.g. as the
+         * output of a matcher, provided it does not reallocate), then commit() publishes it. The slot is marked
+         * as being written from here on, so readers of the message it held see it as overwritten.
+         */
+        cv::Mat beginWrite(int rows, int cols, int type);
+        uint64_t commit(PayloadKind kind, uint64_t frameSequence = 0, int64_t timestamp = 0);
+
+        [[nodiscard]] std::size_t getSlotSize() const;
+        [[nodiscard]] uint32_t getSlotCount() const;
+        [[nodiscard]] uint64_t getPublished() const { return m_Next; }
+    };
+
+    /**
+     * A received message. `data` points into the shared mapping and stays readable even after the publisher
+     * moves on, but its content is only trustworthy if valid() still holds once the reader is done with it.
+     * Clone `data` first if it has to outlive the ring.
+     */
+    struct ShmMessage {
+        MessageInfo info;
+        cv::Mat data;
+        std::shared_ptr<const ShmSegment> segment;
+
+        [[nodiscard]] bool valid() const;
+    };
+
+    // Read side of a ShmPublisher's ring. Subscribers are independent: each keeps its own position.
+    class ShmSubscriber {
+    private:
+        std::shared_ptr<ShmSegment> m_Segment;
+        uint64_t m_Next{0};
+        uint64_t m_Dropped{0};
+
+    public:
+        // Maps an existing segment and starts with the next message published after this point.
+        explicit ShmSubscriber(const std::string &name);
+
+        // Waits up to `timeout` for the next message. Messages overwritten before they could be read are
+        // skipped and counted in getDropped().
+        bool next(ShmMessage &message, std::chrono::milliseconds timeout = std::chrono::milliseconds(100));
+
+        // Jump to the most recent complete message on the next call to next().
+        void seekLatest();
+
+        [[nodiscard]] uint64_t getDropped() const { return m_Dropped; }
+        [[nodiscard]] std::size_t getSlotSize() const;
+        [[nodiscard]] uint32_t getSlotCount() const;
+    };
+}
+
+#endif //VISION_TRANSPORT_SHM_RING_H
@@ -4,8 +4,10 @@
 
 #include "settings/settings.h"
 #include "vision/helpers/yaml.h"
+#include "vision/helpers/thread_affinity.h"
 
 #include <iostream>
+#include <utility>
 
 namespace vlue::settings {
     static auto indent(int layer) {
@@ -46,13 +48,16 @@ namespace vlue::settings {
     }
 
     void CameraConfig::parseYAMLNode(const YAML::Node &config) {
+        if (!config) {
+            return;
+        }
         config_path = config["config"].as<std::string>("");
 
         YAML::Node settings_ = config["settings"];
-        if (settings_)
+        if (!settings_)
             return;
-        settings.exposure = settings_["exposure"].as<std::string>();
-        settings.white_balance = settings_["white_balance"].as<std::string>();
+        settings.exposure = settings_["exposure"].as<std::string>("auto");
+        settings.white_balance = settings_["white_balance"].as<std::string>("auto");
     }
 
     std::ostream &CameraConfig::serialize(std::ostream &os, int layer) const {
@@ -128,6 +133,9 @@ namespace vlue::settings {
     }
 
     void LoggingConfig::parseYAMLNode(const YAML::Node &config) {
+        if (!config) {
+            return;
+        }
         level = config["level"].as<std::string>("info");
         file = config["file"].as<std::string>("");
     }
@@ -139,11 +147,62 @@ namespace vlue::settings {
         return os;
     }
 
+    // Either a list of CPU ids or a cpuset-style string such as "0-3,8".
+    static std::vector<int> parseCpus(const YAML::Node &cpus) {
+        if (!cpus) {
+            return {};
+        }
+        if (cpus.IsSequence()) {
+            std::vector<int> ids;
+            for (const auto cpu: cpus) {
+                ids.push_back(cpu.as<int>());
+            }
+            return utils::parseCpuList(utils::formatCpuList(ids));
+        }
+        return utils::parseCpuList(cpus.as<std::string>());
+    }
+
+    static SchedulingConfig::ThreadGroup parseThreadGroup(const YAML::Node &group) {
+        SchedulingConfig::ThreadGroup threadGroup;
+        if (group) {
+            threadGroup.cpus = parseCpus(group["cpus"]);
+            threadGroup.priority = group["priority"].as<int>(0);
+        }
+        return threadGroup;
+    }
+
+    void SchedulingConfig::parseYAMLNode(const YAML::Node &config) {
+        if (!config) {
+            return;
+        }
+        enable = config["enable"].as<bool>(true);
+        numa_local = config["numa_local"].as<bool>(false);
+        capture = parseThreadGroup(config["capture"]);
+        matcher = parseThreadGroup(config["matcher"]);
+        sink = parseThreadGroup(config["sink"]);
+    }
+
+    std::ostream &SchedulingConfig::serialize(std::ostream &os, int layer) const {
+        os << indent(layer) << "SchedulingConfig:\n"
+                << indent(layer + 1) << "enable: " << (enable ? "true" : "false") << "\n"
+                << indent(layer + 1) << "numa_local: " << (numa_local ? "true" : "false") << "\n";
+        const std::pair<const char *, const ThreadGroup *> groups[] = {
+            {"capture", &capture}, {"matcher", &matcher}, {"sink", &sink}
+        };
+        for (const auto &[name, group]: groups) {
+            os << indent(layer + 1) << name << ":\n"
+                    << indent(layer + 2) << "cpus: " << utils::formatCpuList(group->cpus) << "\n"
+                    << indent(layer + 2) << "priority: " << group->priority << "\n";
+        }
+        return os;
+    }
+
     AppConfig::AppConfig() {
         ros_ = std::make_shared<ROSConfig>();
         camera_ = std::make_shared<CameraConfig>();
         capture_ = std::make_shared<CaptureConfig>();
         logging_ = std::make_shared<LoggingConfig>();
+        scheduling_ = std::make_shared<SchedulingConfig>();
     }
 
     AppConfig::AppConfig(const std::string &app_config) : AppConfig(utils::YAMLUtils::loadYamlConfig(app_config)) {
@@ -157,6 +216,7 @@ namespace vlue::settings {
         camera_ = std::make_shared<CameraConfig>(config["camera"]);
         capture_ = std::make_shared<CaptureConfig>(config["capture"]);
         logging_ = std::make_shared<LoggingConfig>(config["logging"]);
+        scheduling_ = std::make_shared<SchedulingConfig>(config["scheduling"]);
     }
 
     std::ostream &AppConfig::serialize(std::ostream &os, int layer) const {
@@ -165,6 +225,7 @@ namespace vlue::settings {
         camera_->serialize(os, layer + 1);
         capture_->serialize(os, layer + 1);
         logging_->serialize(os, layer + 1);
+        scheduling_->serialize(os, layer + 1);
         return os;
     }
 }
@@ -0,0 +1,190 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/capture/decode_pool.h"
+#include "vision/capture/frame_convert.h"
+#include "vision/helpers/thread_pool.h"
+#include "vision/helpers/memory_tracker.h"
+#include "vision/helpers/trace.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace vlue::capture {
+    DecodePool::DecodePool(std::shared_ptr<FrameSource> source, Options options)
+        : DecodePool(std::move(source), nullptr, options) {}
+
+    DecodePool::DecodePool(std::shared_ptr<FrameSource> left, std::shared_ptr<FrameSource> right, Options options)
+        : m_Left(std::move(left)), m_Right(std::move(right)), m_Options(options), m_Gray(options.gray) {
+        if (m_Left == nullptr) {
+            throw std::invalid_argument("DecodePool needs a frame source.");
+        }
+        if (m_Options.workers == 0) {
+            m_Options.workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        if (m_Options.maxInFlight <= 0) {
+            m_Options.maxInFlight = 2 * static_cast<int>(m_Options.workers);
+        }
+    }
+
+    DecodePool::~DecodePool() {
+        stop();
+    }
+
+    void DecodePool::start() {
+        stop();
+        m_Pool = std::make_unique<utils::ThreadPool>(m_Options.workers, m_Options.workerThreadInit);
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Slots.clear();
+            m_Submitted = m_Delivered = 0;
+            m_Error = nullptr;
+            m_Running = true;
+        }
+        m_Capture = std::thread(&DecodePool::capture_, this);
+    }
+
+    void DecodePool::stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running = false;
+        }
+        m_Space.notify_all();
+        m_Ready.notify_all();
+        if (m_Capture.joinable()) {
+            m_Capture.join();
+        }
+        // Finishes the decodes already posted before the slots go away.
+        m_Pool.reset();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Slots.clear();
+    }
+
+    void DecodePool::capture_() {
+        if (m_Options.captureThreadInit) {
+            m_Options.captureThreadInit();
+        }
+        const auto limit = static_cast<uint64_t>(m_Options.maxInFlight);
+        // A left frame whose right partner has not arrived yet.
+        RawFrame pending;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Space.wait(lock, [&] { return !m_Running || m_Submitted - m_Delivered < limit; });
+                if (!m_Running) {
+                    return;
+                }
+            }
+
+            RawFrame left, right;
+            try {
+                utils::TraceSpan span("capture.grab", "capture");
+                if (!pending.empty()) {
+                    left = std::move(pending);
+                    pending = RawFrame();
+                } else if (!m_Left->grab(left, m_Options.grabTimeout)) {
+                    continue;
+                }
+                if (m_Right != nullptr && !m_Right->grab(right, m_Options.grabTimeout)) {
+                    pending = std::move(left);
+                    continue;
+                }
+                span.setFrame(left.sequence);
+            } catch (const std::exception &e) {
+                std::cerr << "Error: frame capture failed: " << e.what() << std::endl;
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Error = std::current_exception();
+                m_Ready.notify_all();
+                return;
+            }
+            // Compressed payloads are cheap to copy; doing so returns the driver buffer immediately.
+            for (RawFrame *raw : {&left, &right}) {
+                if (!raw->empty() && raw->fourcc == FOURCC_MJPG) {
+                    const utils::ScopedMemoryRegion region(utils::MemoryTracker::regionOf<DecodePool>());
+                    raw->data = raw->data.clone();
+                    raw->lease.reset();
+                }
+            }
+
+            uint64_t index;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                index = m_Submitted++;
+                Slot &slot = m_Slots[index];
+                slot.pending = m_Right != nullptr ? 2 : 1;
+                slot.frame.sequence = left.sequence;
+                slot.frame.timestamp = left.timestamp;
+            }
+            m_Pool->post([this, index, left] { decode_(index, left, false); });
+            if (m_Right != nullptr) {
+                m_Pool->post([this, index, right] { decode_(index, right, true); });
+            }
+        }
+    }
+
+    void DecodePool::decode_(uint64_t index, const RawFrame &raw, bool right) {
+        utils::TraceSpan span(right ? "capture.decode.right" : "capture.decode", "capture");
+        span.setFrame(raw.sequence);
+        // Decoded frames waiting in the reorder buffer stay charged here until the consumer releases them.
+        const utils::ScopedMemoryRegion region(utils::MemoryTracker::regionOf<DecodePool>());
+        cv::Mat image;
+        bool ok;
+        try {
+            ok = convertRaw(raw.data, raw.fourcc, m_Gray, image);
+        } catch (const std::exception &e) {
+            std::cerr << "Error: frame decode failed: " << e.what() << std::endl;
+            ok = false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        const auto it = m_Slots.find(index);
+        if (it == m_Slots.end()) {
+            return;
+        }
+        Slot &slot = it->second;
+        if (!ok) {
+            slot.failed = true;
+            ++m_Failures;
+        } else if (right) {
+            slot.frame.right = image;
+        } else if (m_Right == nullptr && m_Options.width > 0 && image.cols == 2 * m_Options.width) {
+            slot.frame.left = image(cv::Rect(0, 0, m_Options.width, image.rows));
+            slot.frame.right = image(cv::Rect(m_Options.width, 0, m_Options.width, image.rows));
+        } else {
+            slot.frame.left = image;
+        }
+        if (--slot.pending == 0 && index == m_Delivered) {
+            m_Ready.notify_all();
+        }
+    }
+
+    bool DecodePool::next(StereoFrame &frame, std::chrono::milliseconds timeout) {
+        frame.release();
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        for (;;) {
+            const auto failed = [&] { return m_Error != nullptr && m_Delivered == m_Submitted; };
+            const bool ready = m_Ready.wait_until(lock, deadline, [&] {
+                const auto it = m_Slots.find(m_Delivered);
+                return !m_Running || failed() || (it != m_Slots.end() && it->second.pending == 0);
+            });
+            if (!ready || !m_Running) {
+                return false;
+            }
+            if (failed()) {
+                std::rethrow_exception(m_Error);
+            }
+            auto it = m_Slots.find(m_Delivered);
+            Slot slot = std::move(it->second);
+            m_Slots.erase(it);
+            ++m_Delivered;
+            m_Space.notify_one();
+            if (!slot.failed) {
+                frame = std::move(slot.frame);
+                return true;
+            }
+        }
+    }
+}
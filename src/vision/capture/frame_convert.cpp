@@ -0,0 +1,98 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/capture/frame_convert.h"
+#include "vision/capture/frame_source.h"
+
+#include <stdexcept>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace vlue::capture {
+    // dst[i] = src[2 * i + offset] for i in [0, count)
+    static void copyLuma(const uchar *src, uchar *dst, int count, bool lumaFirst) {
+        int x = 0;
+#if CV_SIMD128
+        for (; x <= count - 16; x += 16) {
+            cv::v_uint8x16 even, odd;
+            cv::v_load_deinterleave(src + 2 * x, even, odd);
+            cv::v_store(dst + x, lumaFirst ? even : odd);
+        }
+#endif
+        const int offset = lumaFirst ? 0 : 1;
+        for (; x < count; ++x) {
+            dst[x] = src[2 * x + offset];
+        }
+    }
+
+    static void checkPacked(const cv::Mat &packed) {
+        if (packed.empty() || packed.type() != CV_8UC2) {
+            throw std::invalid_argument("Expected a non-empty CV_8UC2 packed 4:2:2 frame.");
+        }
+    }
+
+    void extractLuma(const cv::Mat &packed, cv::Mat &gray, bool lumaFirst) {
+        checkPacked(packed);
+        gray.create(packed.size(), CV_8UC1);
+        cv::parallel_for_(cv::Range(0, packed.rows), [&](const cv::Range &range) {
+            for (int y = range.start; y < range.end; ++y) {
+                copyLuma(packed.ptr<uchar>(y), gray.ptr<uchar>(y), packed.cols, lumaFirst);
+            }
+        });
+    }
+
+    void extractLumaSplit(const cv::Mat &packed, cv::Mat &left, cv::Mat &right, int splitColumn, bool lumaFirst) {
+        checkPacked(packed);
+        if (splitColumn <= 0 || splitColumn >= packed.cols) {
+            throw std::invalid_argument("Split column must lie inside the frame.");
+        }
+        left.create(packed.rows, splitColumn, CV_8UC1);
+        right.create(packed.rows, packed.cols - splitColumn, CV_8UC1);
+        cv::parallel_for_(cv::Range(0, packed.rows), [&](const cv::Range &range) {
+            for (int y = range.start; y < range.end; ++y) {
+                const uchar *src = packed.ptr<uchar>(y);
+                copyLuma(src, left.ptr<uchar>(y), left.cols, lumaFirst);
+                copyLuma(src + 2 * splitColumn, right.ptr<uchar>(y), right.cols, lumaFirst);
+            }
+        });
+    }
+
+    bool decodeGray(const cv::Mat &compressed, cv::Mat &gray) {
+        if (compressed.empty()) {
+            return false;
+        }
+        // libjpeg skips chroma upsampling and colour conversion when asked for grayscale output.
+        gray = cv::imdecode(compressed, cv::IMREAD_GRAYSCALE);
+        return !gray.empty();
+    }
+
+    bool convertRaw(const cv::Mat &data, uint32_t fourcc, bool gray, cv::Mat &image) {
+        switch (fourcc) {
+            case FOURCC_YUYV:
+            case FOURCC_UYVY:
+                if (gray) {
+                    extractLuma(data, image, fourcc == FOURCC_YUYV);
+                } else {
+                    cv::cvtColor(data, image, fourcc == FOURCC_YUYV ? cv::COLOR_YUV2BGR_YUYV : cv::COLOR_YUV2BGR_UYVY);
+                }
+                return true;
+            case FOURCC_GREY:
+                if (gray) {
+                    image = data.clone();
+                } else {
+                    cv::cvtColor(data, image, cv::COLOR_GRAY2BGR);
+                }
+                return true;
+            case FOURCC_MJPG:
+                if (gray) {
+                    return decodeGray(data, image);
+                }
+                image = cv::imdecode(data, cv::IMREAD_COLOR);
+                return !image.empty();
+            default:
+                throw std::invalid_argument("Unsupported source pixel format.");
+        }
+    }
+}
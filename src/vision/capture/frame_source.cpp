@@ -0,0 +1,160 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/capture/frame_source.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vlue::capture {
+    struct FileFrameSource::Pool {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<std::vector<uchar>> buffers;
+        std::vector<int> free;
+        bool running = false;
+
+        // Frames as (offset, length) into the file contents.
+        std::vector<uchar> file;
+        std::vector<std::pair<size_t, size_t>> frames;
+        size_t next = 0;
+        uint64_t sequence = 0;
+
+        void requeue(int index) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                free.push_back(index);
+            }
+            cv.notify_one();
+        }
+    };
+
+    static size_t frameBytes(uint32_t fourcc, const cv::Size &size) {
+        if (fourcc == FOURCC_YUYV || fourcc == FOURCC_UYVY) {
+            return static_cast<size_t>(size.area()) * 2;
+        }
+        if (fourcc == FOURCC_GREY) {
+            return static_cast<size_t>(size.area());
+        }
+        return 0;
+    }
+
+    FileFrameSource::FileFrameSource(std::string path, int width, int height, uint32_t fourcc, int bufferCount, bool loop)
+        : m_Path(std::move(path)), m_Size(width, height), m_Fourcc(fourcc), m_BufferCount(bufferCount), m_Loop(loop) {
+        if (width <= 0 || height <= 0 || bufferCount <= 0) {
+            throw std::invalid_argument("FileFrameSource needs a positive size and buffer count.");
+        }
+        if (fourcc != FOURCC_MJPG && frameBytes(fourcc, m_Size) == 0) {
+            throw std::invalid_argument("FileFrameSource supports YUYV, UYVY, GREY and MJPG.");
+        }
+    }
+
+    FileFrameSource::~FileFrameSource() {
+        stop();
+    }
+
+    void FileFrameSource::start() {
+        std::ifstream file(m_Path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open frame file: " + m_Path);
+        }
+        auto pool = std::make_shared<Pool>();
+        pool->file.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        if (m_Fourcc == FOURCC_MJPG) {
+            // Split on SOI ... EOI markers.
+            const auto &bytes = pool->file;
+            size_t start = std::string::npos;
+            for (size_t i = 0; i + 1 < bytes.size(); ++i) {
+                if (bytes[i] != 0xFF) {
+                    continue;
+                }
+                if (bytes[i + 1] == 0xD8 && start == std::string::npos) {
+                    start = i;
+                } else if (bytes[i + 1] == 0xD9 && start != std::string::npos) {
+                    pool->frames.emplace_back(start, i + 2 - start);
+                    start = std::string::npos;
+                }
+            }
+        } else {
+            const size_t bytes = frameBytes(m_Fourcc, m_Size);
+            for (size_t offset = 0; offset + bytes <= pool->file.size(); offset += bytes) {
+                pool->frames.emplace_back(offset, bytes);
+            }
+        }
+        if (pool->frames.empty()) {
+            throw std::runtime_error("No complete frames in " + m_Path);
+        }
+
+        size_t largest = 0;
+        for (const auto &frame : pool->frames) {
+            largest = std::max(largest, frame.second);
+        }
+        pool->buffers.assign(m_BufferCount, std::vector<uchar>(largest));
+        for (int i = 0; i < m_BufferCount; ++i) {
+            pool->free.push_back(i);
+        }
+        pool->running = true;
+        m_Pool = std::move(pool);
+    }
+
+    void FileFrameSource::stop() {
+        if (!m_Pool) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_Pool->mutex);
+            m_Pool->running = false;
+        }
+        m_Pool->cv.notify_all();
+        // Outstanding leases keep the pool (and the pixels they view) alive.
+        m_Pool.reset();
+    }
+
+    bool FileFrameSource::grab(RawFrame &frame, std::chrono::milliseconds timeout) {
+        if (!m_Pool) {
+            throw std::logic_error("FileFrameSource::grab called before start().");
+        }
+        // Give back whatever the caller still holds from the previous grab before waiting for a buffer.
+        frame.release();
+        const auto pool = m_Pool;
+        std::unique_lock<std::mutex> lock(pool->mutex);
+        if (!pool->cv.wait_for(lock, timeout, [&] { return !pool->free.empty() || !pool->running; }) || !pool->running) {
+            return false;
+        }
+        if (pool->next >= pool->frames.size()) {
+            if (!m_Loop) {
+                return false;
+            }
+            pool->next = 0;
+        }
+
+        const int index = pool->free.back();
+        pool->free.pop_back();
+        const auto [offset, length] = pool->frames[pool->next++];
+        auto &buffer = pool->buffers[index];
+        std::copy_n(pool->file.begin() + static_cast<std::ptrdiff_t>(offset), length, buffer.begin());
+        const uint64_t sequence = pool->sequence++;
+        lock.unlock();
+
+        if (m_Fourcc == FOURCC_MJPG) {
+            frame.data = cv::Mat(1, static_cast<int>(length), CV_8UC1, buffer.data());
+        } else {
+            frame.data = cv::Mat(m_Size, m_Fourcc == FOURCC_GREY ? CV_8UC1 : CV_8UC2, buffer.data());
+        }
+        frame.fourcc = m_Fourcc;
+        frame.sequence = sequence;
+        frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch());
+        frame.dmabufFd = -1;
+        frame.lease = std::shared_ptr<void>(buffer.data(), [pool, index](void *) { pool->requeue(index); });
+        return true;
+    }
+}
@@ -3,9 +3,17 @@
 //
 
 #include "vision/capture/stereo_capture.h"
+#include "vision/capture/frame_convert.h"
+#include "vision/capture/frame_source.h"
+#include "vision/capture/decode_pool.h"
+#include "vision/helpers/memory_tracker.h"
+#include "vision/helpers/trace.h"
 
 #include <iostream>
+#include <utility>
 #include <opencv2/core/mat.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
 #include <opencv2/videoio.hpp>
 
 namespace vlue::capture {
@@ -59,6 +67,7 @@ namespace vlue::capture {
     }
 
     StereoCapture::StereoCapture(const std::string &source, int width, int height) {
+        cap_left_ = std::make_shared<cv::VideoCapture>(source);
         cap_init_(cap_left_, source, width, height, 2);
         cap_right_ = nullptr;
     }
@@ -73,7 +82,26 @@ namespace vlue::capture {
         setupCapRight(source_right, width, height);
     }
 
+    StereoCapture::StereoCapture(std::shared_ptr<FrameSource> source, int width, int height)
+        : width(width), height(height), source_(std::move(source)) {
+        if (source_ == nullptr) {
+            throw std::invalid_argument("StereoCapture needs a frame source.");
+        }
+        source_->start();
+        const cv::Size size = source_->getSize();
+        if (size.width != width && size.width != 2 * width) {
+            std::cerr << "Warning: source delivers " << size.width << "x" << size.height << ", using it as one view."
+                      << std::endl;
+            this->width = size.width;
+        }
+        this->height = size.height;
+    }
+
     StereoCapture::~StereoCapture() {
+        decode_pool_.reset();
+        if (source_ != nullptr) {
+            source_->stop();
+        }
         if (cap_left_ != nullptr) {
             cap_left_->release();
         }
@@ -83,15 +111,35 @@ namespace vlue::capture {
     }
 
     StereoCapture::CaptureFrameState_ StereoCapture::captureStereoFrame(cv::Mat &frame_left, cv::Mat &frame_right) const {
+        const utils::ScopedMemoryRegion region(utils::MemoryTracker::regionOf<StereoCapture>());
         cv::Mat frame, left, right;
 
+        if (source_ != nullptr) {
+            StereoFrame frame;
+            const auto state = captureStereoFrame(frame);
+            // The Mat-only interface has nowhere to keep the lease, so views into the source buffer are copied.
+            frame_left = frame.lease ? frame.left.clone() : frame.left;
+            frame_right = frame.lease ? frame.right.clone() : frame.right;
+            return state;
+        }
+
         // Check if the left camera is valid
         if (cap_left_ == nullptr) {
             return CaptureFrameState_::NoCapture;
         }
+        if (output_format_ == OutputFormat_::Gray) {
+            return captureGrayFrame_(frame_left, frame_right);
+        }
 
         // Read the frame from the left camera
-        *cap_left_ >> frame;
+        {
+            const utils::TraceSpan span("capture.grab", "capture");
+            cap_left_->grab();
+        }
+        {
+            const utils::TraceSpan span("capture.retrieve", "capture");
+            cap_left_->retrieve(frame);
+        }
         if (frame.empty()) {
             return CaptureFrameState_::NoFrame;
         }
@@ -104,6 +152,7 @@ namespace vlue::capture {
 
         frame_left = frame;
         if (cap_right_ != nullptr) {
+            const utils::TraceSpan span("capture.read.right", "capture");
             *cap_right_ >> frame_right;
             if (!frame_right.empty()) {
                 return CaptureFrameState_::HasRightFrame;
@@ -129,4 +178,151 @@ namespace vlue::capture {
         cap_right_ = std::make_shared<cv::VideoCapture>(source);
         cap_init_(cap_right_, source, width, height, frameWidthScale);
     }
+
+    StereoCapture::CaptureFrameState_ StereoCapture::captureStereoFrame(StereoFrame &frame,
+                                                                        std::chrono::milliseconds timeout) const {
+        const utils::ScopedMemoryRegion region(utils::MemoryTracker::regionOf<StereoCapture>());
+        frame.release();
+        if (source_ == nullptr) {
+            const auto state = captureStereoFrame(frame.left, frame.right);
+            frame.sequence = frame_count_++;
+            frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch());
+            return state;
+        }
+
+        if (decode_pool_ != nullptr) {
+            const utils::TraceSpan span("capture.wait", "capture");
+            if (!decode_pool_->next(frame, timeout)) {
+                return CaptureFrameState_::NoFrame;
+            }
+            return frame.right.empty() ? CaptureFrameState_::HasLeftFrame : CaptureFrameState_::HasRightFrame;
+        }
+
+        RawFrame raw;
+        {
+            utils::TraceSpan span("capture.grab", "capture");
+            if (!source_->grab(raw, timeout)) {
+                return CaptureFrameState_::NoFrame;
+            }
+            span.setFrame(raw.sequence);
+        }
+        frame.sequence = raw.sequence;
+        frame.timestamp = raw.timestamp;
+        const utils::TraceFrame tag(raw.sequence);
+        const utils::TraceSpan span("capture.convert", "capture");
+        return splitRaw_(raw, frame);
+    }
+
+    StereoCapture::CaptureFrameState_ StereoCapture::splitRaw_(const RawFrame &raw, StereoFrame &frame) const {
+        const bool gray = output_format_ == OutputFormat_::Gray;
+        cv::Mat image;
+        if (gray && raw.data.cols == 2 * this->width && (raw.fourcc == FOURCC_YUYV || raw.fourcc == FOURCC_UYVY)) {
+            extractLumaSplit(raw.data, frame.left, frame.right, this->width, raw.fourcc == FOURCC_YUYV);
+            return CaptureFrameState_::HasRightFrame;
+        }
+        if (gray && raw.fourcc == FOURCC_GREY) {
+            // Already what the matcher wants: hand out views and keep the buffer leased.
+            image = raw.data;
+            frame.lease = raw.lease;
+        } else if (!convertRaw(raw.data, raw.fourcc, gray, image)) {
+            return CaptureFrameState_::NoFrame;
+        }
+
+        if (image.empty()) {
+            return CaptureFrameState_::NoFrame;
+        }
+        if (image.cols == 2 * this->width) {
+            frame.left = image(cv::Rect(0, 0, this->width, image.rows));
+            frame.right = image(cv::Rect(this->width, 0, this->width, image.rows));
+            return CaptureFrameState_::HasRightFrame;
+        }
+        frame.left = image;
+        return CaptureFrameState_::HasLeftFrame;
+    }
+
+    void StereoCapture::setOutputFormat(OutputFormat_ format) {
+        const bool convert = format == OutputFormat_::BGR;
+        for (const auto &cap : {cap_left_, cap_right_}) {
+            if (cap != nullptr && !cap->set(cv::CAP_PROP_CONVERT_RGB, convert)) {
+                std::cerr << "Warning: backend ignored CAP_PROP_CONVERT_RGB, converting its output instead." << std::endl;
+            }
+        }
+        fourcc_left_ = cap_left_ != nullptr ? static_cast<int>(cap_left_->get(cv::CAP_PROP_FOURCC)) : 0;
+        fourcc_right_ = cap_right_ != nullptr ? static_cast<int>(cap_right_->get(cv::CAP_PROP_FOURCC)) : 0;
+        output_format_ = format;
+        if (decode_pool_ != nullptr) {
+            decode_pool_->setGray(format == OutputFormat_::Gray);
+        }
+    }
+
+    void StereoCapture::setDecodeWorkers(unsigned workers, int maxInFlight, std::function<void()> captureThreadInit,
+                                         std::function<void(unsigned)> workerThreadInit) {
+        decode_pool_.reset();
+        if (workers == 0) {
+            return;
+        }
+        if (source_ == nullptr) {
+            throw std::logic_error("Decode workers need a StereoCapture built on a FrameSource.");
+        }
+        DecodePool::Options options;
+        options.workers = workers;
+        options.maxInFlight = maxInFlight;
+        options.gray = output_format_ == OutputFormat_::Gray;
+        options.width = this->width;
+        options.captureThreadInit = std::move(captureThreadInit);
+        options.workerThreadInit = std::move(workerThreadInit);
+        decode_pool_ = std::make_shared<DecodePool>(source_, options);
+        decode_pool_->start();
+    }
+
+    bool StereoCapture::toGray_(const cv::Mat &raw, int fourcc, cv::Mat &gray) {
+        if (raw.type() == CV_8UC2) {
+            extractLuma(raw, gray, fourcc != static_cast<int>(FOURCC_UYVY));
+            return true;
+        }
+        // Compressed payloads come back as a single row of bytes.
+        if (raw.rows == 1 && raw.type() == CV_8UC1) {
+            return decodeGray(raw, gray);
+        }
+        if (raw.type() == CV_8UC1) {
+            gray = raw;
+            return true;
+        }
+        // The backend converted anyway; fall back to one colour conversion.
+        cv::cvtColor(raw, gray, raw.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+        return true;
+    }
+
+    StereoCapture::CaptureFrameState_ StereoCapture::captureGrayFrame_(cv::Mat &frame_left, cv::Mat &frame_right) const {
+        cv::Mat raw, gray;
+        {
+            const utils::TraceSpan span("capture.read", "capture");
+            if (!cap_left_->read(raw) || raw.empty()) {
+                return CaptureFrameState_::NoFrame;
+            }
+        }
+        const utils::TraceSpan span("capture.convert", "capture");
+
+        // Side-by-side YUYV: extract luma and split in one pass over the frame.
+        if (raw.type() == CV_8UC2 && raw.cols == 2 * this->width) {
+            extractLumaSplit(raw, frame_left, frame_right, this->width,
+                             fourcc_left_ != static_cast<int>(FOURCC_UYVY));
+            return CaptureFrameState_::HasRightFrame;
+        }
+        if (!toGray_(raw, fourcc_left_, gray)) {
+            return CaptureFrameState_::NoFrame;
+        }
+        if (gray.cols == 2 * this->width) {
+            frame_left = gray(cv::Rect(0, 0, this->width, this->height));
+            frame_right = gray(cv::Rect(this->width, 0, this->width, this->height));
+            return CaptureFrameState_::HasRightFrame;
+        }
+
+        frame_left = gray;
+        if (cap_right_ != nullptr && cap_right_->read(raw) && !raw.empty() && toGray_(raw, fourcc_right_, frame_right)) {
+            return CaptureFrameState_::HasRightFrame;
+        }
+        return CaptureFrameState_::HasLeftFrame;
+    }
 }
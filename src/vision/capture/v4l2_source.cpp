@@ -0,0 +1,245 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/capture/v4l2_source.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+
+namespace vlue::capture {
+    static int xioctl(int fd, unsigned long request, void *arg) {
+        int result;
+        do {
+            result = ioctl(fd, request, arg);
+        } while (result == -1 && errno == EINTR);
+        return result;
+    }
+
+    static std::runtime_error v4l2Error(const std::string &what, const std::string &device) {
+        return std::runtime_error(what + " failed on " + device + ": " + std::strerror(errno));
+    }
+
+    // Owns the device and the mappings. Leases hold a reference, so views stay valid after stop().
+    struct V4L2FrameSource::Queue {
+        struct Buffer {
+            void *start = MAP_FAILED;
+            size_t length = 0;
+            int dmabufFd = -1;
+        };
+
+        int fd = -1;
+        uint32_t bytesPerLine = 0;
+        std::vector<Buffer> buffers;
+        std::mutex mutex;
+        bool streaming = false;
+
+        ~Queue() {
+            for (auto &buffer : buffers) {
+                if (buffer.dmabufFd >= 0) {
+                    close(buffer.dmabufFd);
+                }
+                if (buffer.start != MAP_FAILED) {
+                    munmap(buffer.start, buffer.length);
+                }
+            }
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        void requeue(uint32_t index) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!streaming) {
+                return;
+            }
+            v4l2_buffer buf{};
+            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = V4L2_MEMORY_MMAP;
+            buf.index = index;
+            if (xioctl(fd, VIDIOC_QBUF, &buf) == -1) {
+                std::cerr << "Warning: VIDIOC_QBUF failed: " << std::strerror(errno) << std::endl;
+            }
+        }
+    };
+
+    V4L2FrameSource::V4L2FrameSource(Config config) : m_Config(std::move(config)) {
+        if (m_Config.width <= 0 || m_Config.height <= 0 || m_Config.bufferCount < 2) {
+            throw std::invalid_argument("V4L2 capture needs a positive size and at least two buffers.");
+        }
+    }
+
+    V4L2FrameSource::~V4L2FrameSource() {
+        stop();
+    }
+
+    void V4L2FrameSource::start() {
+        stop();
+        const std::string &device = m_Config.device;
+        auto queue = std::make_shared<Queue>();
+        queue->fd = open(device.c_str(), O_RDWR | O_NONBLOCK);
+        if (queue->fd == -1) {
+            throw v4l2Error("open", device);
+        }
+
+        v4l2_capability cap{};
+        if (xioctl(queue->fd, VIDIOC_QUERYCAP, &cap) == -1) {
+            throw v4l2Error("VIDIOC_QUERYCAP", device);
+        }
+        if (!(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) || !(cap.capabilities & V4L2_CAP_STREAMING)) {
+            throw std::runtime_error(device + " is not a streaming capture device.");
+        }
+
+        v4l2_format fmt{};
+        fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        fmt.fmt.pix.width = m_Config.width;
+        fmt.fmt.pix.height = m_Config.height;
+        fmt.fmt.pix.pixelformat = m_Config.fourcc;
+        fmt.fmt.pix.field = V4L2_FIELD_NONE;
+        if (xioctl(queue->fd, VIDIOC_S_FMT, &fmt) == -1) {
+            throw v4l2Error("VIDIOC_S_FMT", device);
+        }
+        m_Size = cv::Size(static_cast<int>(fmt.fmt.pix.width), static_cast<int>(fmt.fmt.pix.height));
+        m_Fourcc = fmt.fmt.pix.pixelformat;
+        queue->bytesPerLine = fmt.fmt.pix.bytesperline;
+        if (m_Size != cv::Size(m_Config.width, m_Config.height) || m_Fourcc != m_Config.fourcc) {
+            std::cerr << "Warning: " << device << " negotiated " << m_Size.width << "x" << m_Size.height
+                      << " instead of the requested format." << std::endl;
+        }
+
+        if (m_Config.fps > 0) {
+            v4l2_streamparm parm{};
+            parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            parm.parm.capture.timeperframe.numerator = 1;
+            parm.parm.capture.timeperframe.denominator = m_Config.fps;
+            if (xioctl(queue->fd, VIDIOC_S_PARM, &parm) == -1) {
+                std::cerr << "Warning: " << device << " rejected " << m_Config.fps << " fps." << std::endl;
+            }
+        }
+
+        v4l2_requestbuffers req{};
+        req.count = m_Config.bufferCount;
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_MMAP;
+        if (xioctl(queue->fd, VIDIOC_REQBUFS, &req) == -1) {
+            throw v4l2Error("VIDIOC_REQBUFS", device);
+        }
+        if (req.count < 2) {
+            throw std::runtime_error("Not enough buffer memory on " + device);
+        }
+
+        queue->buffers.resize(req.count);
+        for (uint32_t i = 0; i < req.count; ++i) {
+            v4l2_buffer buf{};
+            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = V4L2_MEMORY_MMAP;
+            buf.index = i;
+            if (xioctl(queue->fd, VIDIOC_QUERYBUF, &buf) == -1) {
+                throw v4l2Error("VIDIOC_QUERYBUF", device);
+            }
+            auto &buffer = queue->buffers[i];
+            buffer.length = buf.length;
+            buffer.start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, queue->fd, buf.m.offset);
+            if (buffer.start == MAP_FAILED) {
+                throw v4l2Error("mmap", device);
+            }
+            if (m_Config.exportDmabuf) {
+                v4l2_exportbuffer exp{};
+                exp.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                exp.index = i;
+                exp.flags = O_RDONLY | O_CLOEXEC;
+                if (xioctl(queue->fd, VIDIOC_EXPBUF, &exp) == -1) {
+                    throw v4l2Error("VIDIOC_EXPBUF", device);
+                }
+                buffer.dmabufFd = exp.fd;
+            }
+            if (xioctl(queue->fd, VIDIOC_QBUF, &buf) == -1) {
+                throw v4l2Error("VIDIOC_QBUF", device);
+            }
+        }
+
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (xioctl(queue->fd, VIDIOC_STREAMON, &type) == -1) {
+            throw v4l2Error("VIDIOC_STREAMON", device);
+        }
+        queue->streaming = true;
+        m_Queue = std::move(queue);
+    }
+
+    void V4L2FrameSource::stop() {
+        if (!m_Queue) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_Queue->mutex);
+            if (m_Queue->streaming) {
+                v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                xioctl(m_Queue->fd, VIDIOC_STREAMOFF, &type);
+                m_Queue->streaming = false;
+            }
+        }
+        m_Queue.reset();
+    }
+
+    bool V4L2FrameSource::grab(RawFrame &frame, std::chrono::milliseconds timeout) {
+        if (!m_Queue) {
+            throw std::logic_error("V4L2FrameSource::grab called before start().");
+        }
+        frame.release();
+        const auto queue = m_Queue;
+
+        pollfd pfd{queue->fd, POLLIN, 0};
+        int ready;
+        do {
+            ready = poll(&pfd, 1, static_cast<int>(timeout.count()));
+        } while (ready == -1 && errno == EINTR);
+        if (ready <= 0) {
+            return false;
+        }
+
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (xioctl(queue->fd, VIDIOC_DQBUF, &buf) == -1) {
+                if (errno == EAGAIN) {
+                    return false;
+                }
+                throw v4l2Error("VIDIOC_DQBUF", m_Config.device);
+            }
+        }
+
+        const uint32_t index = buf.index;
+        auto *start = static_cast<uchar *>(queue->buffers[index].start);
+        if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+            queue->requeue(index);
+            return false;
+        }
+
+        if (m_Fourcc == FOURCC_YUYV || m_Fourcc == FOURCC_UYVY) {
+            frame.data = cv::Mat(m_Size, CV_8UC2, start, queue->bytesPerLine);
+        } else if (m_Fourcc == FOURCC_GREY) {
+            frame.data = cv::Mat(m_Size, CV_8UC1, start, queue->bytesPerLine);
+        } else {
+            frame.data = cv::Mat(1, static_cast<int>(buf.bytesused), CV_8UC1, start);
+        }
+        frame.fourcc = m_Fourcc;
+        frame.sequence = buf.sequence;
+        frame.timestamp = std::chrono::seconds(buf.timestamp.tv_sec) + std::chrono::microseconds(buf.timestamp.tv_usec);
+        frame.dmabufFd = queue->buffers[index].dmabufFd;
+        frame.lease = std::shared_ptr<void>(start, [queue, index](void *) { queue->requeue(index); });
+        return true;
+    }
+}
@@ -0,0 +1,334 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/codec/disparity_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <opencv2/core.hpp>
+
+namespace vlue::codec {
+    namespace {
+        constexpr uint8_t MAGIC[4] = {'V', 'D', 'C', '1'};
+        // Token bytes. Anything below TOKEN_ZERO_RUN is a zigzagged residual on its own.
+        constexpr uint8_t TOKEN_ZERO_RUN = 0xFC;  // varint(n - 2): n pixels exactly on their prediction
+        constexpr uint8_t TOKEN_INVALID_RUN = 0xFD;  // varint(n - 1): n invalid pixels
+        constexpr uint8_t TOKEN_ESCAPE = 0xFE;  // varint(zigzag residual)
+        constexpr std::size_t MAX_PIXELS = std::size_t(1) << 28;
+
+        inline uint32_t zigzag(int value) { return (uint32_t(value) << 1) ^ uint32_t(value >> 31); }
+        inline int unzigzag(uint32_t value) { return int(value >> 1) ^ -int(value & 1); }
+
+        void putVarint(std::vector<uint8_t> &out, uint32_t value) {
+            while (value >= 0x80) {
+                out.push_back(uint8_t(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(uint8_t(value));
+        }
+
+        void put32(std::vector<uint8_t> &out, uint32_t value) {
+            for (int i = 0; i < 4; ++i) out.push_back(uint8_t(value >> (8 * i)));
+        }
+
+        void put64(std::vector<uint8_t> &out, uint64_t value) {
+            for (int i = 0; i < 8; ++i) out.push_back(uint8_t(value >> (8 * i)));
+        }
+
+        struct Reader {
+            const uint8_t *p, *end;
+
+            uint8_t byte() {
+                if (p == end) throw std::runtime_error("Disparity stream is truncated.");
+                return *p++;
+            }
+
+            uint32_t varint() {
+                uint32_t value = 0;
+                for (int shift = 0; shift < 35; shift += 7) {
+                    const uint8_t b = byte();
+                    value |= uint32_t(b & 0x7F) << shift;
+                    if (!(b & 0x80)) return value;
+                }
+                throw std::runtime_error("Disparity stream has a malformed varint.");
+            }
+
+            uint32_t u32() {
+                uint32_t value = 0;
+                for (int i = 0; i < 4; ++i) value |= uint32_t(byte()) << (8 * i);
+                return value;
+            }
+
+            uint64_t u64() {
+                uint64_t value = 0;
+                for (int i = 0; i < 8; ++i) value |= uint64_t(byte()) << (8 * i);
+                return value;
+            }
+        };
+
+        // LOCO-I median predictor over the valid neighbours; `fallback` is the last valid value of the stripe.
+        template<typename T>
+        inline int predict(const T *row, const T *above, int x, int invalid, int fallback) {
+            const bool hasA = x > 0 && row[x - 1] != invalid;
+            const bool hasB = above && above[x] != invalid;
+            if (hasA && hasB) {
+                const int a = row[x - 1], b = above[x];
+                if (above[x - 1] == invalid) return (a + b + 1) >> 1;
+                const int c = above[x - 1];
+                if (c >= std::max(a, b)) return std::min(a, b);
+                if (c <= std::min(a, b)) return std::max(a, b);
+                return a + b - c;
+            }
+            if (hasA) return row[x - 1];
+            if (hasB) return above[x];
+            return fallback;
+        }
+
+        template<typename T>
+        void encodeStripe(const cv::Mat &values, int rowBegin, int rowEnd, int invalid, std::vector<uint8_t> &out) {
+            out.reserve(std::size_t(rowEnd - rowBegin) * values.cols);
+            int fallback = 0;
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                const T *row = values.ptr<T>(y);
+                const T *above = y > rowBegin ? values.ptr<T>(y - 1) : nullptr;
+                uint32_t zeros = 0, invalids = 0;
+                const auto flushZeros = [&] {
+                    if (zeros == 1) {
+                        out.push_back(0);
+                    } else if (zeros > 1) {
+                        out.push_back(TOKEN_ZERO_RUN);
+                        putVarint(out, zeros - 2);
+                    }
+                    zeros = 0;
+                };
+                const auto flushInvalids = [&] {
+                    if (invalids) {
+                        out.push_back(TOKEN_INVALID_RUN);
+                        putVarint(out, invalids - 1);
+                    }
+                    invalids = 0;
+                };
+
+                for (int x = 0; x < values.cols; ++x) {
+                    const int v = row[x];
+                    if (v == invalid) {
+                        flushZeros();
+                        ++invalids;
+                        continue;
+                    }
+                    flushInvalids();
+                    const int residual = v - predict(row, above, x, invalid, fallback);
+                    fallback = v;
+                    if (residual == 0) {
+                        ++zeros;
+                        continue;
+                    }
+                    flushZeros();
+                    const uint32_t token = zigzag(residual);
+                    if (token < TOKEN_ZERO_RUN) {
+                        out.push_back(uint8_t(token));
+                    } else {
+                        out.push_back(TOKEN_ESCAPE);
+                        putVarint(out, token);
+                    }
+                }
+                flushZeros();
+                flushInvalids();
+            }
+        }
+
+        template<typename T>
+        void decodeStripe(Reader reader, cv::Mat &values, int rowBegin, int rowEnd, int invalid) {
+            int fallback = 0;
+            const auto store = [](int value) {
+                if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+                    throw std::runtime_error("Disparity stream decodes to an out-of-range value.");
+                }
+                return T(value);
+            };
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                T *row = values.ptr<T>(y);
+                const T *above = y > rowBegin ? values.ptr<T>(y - 1) : nullptr;
+                int x = 0;
+                while (x < values.cols) {
+                    const uint8_t token = reader.byte();
+                    if (token == TOKEN_INVALID_RUN || token == TOKEN_ZERO_RUN) {
+                        const uint32_t run = reader.varint() + (token == TOKEN_ZERO_RUN ? 2 : 1);
+                        if (run > uint32_t(values.cols - x)) {
+                            throw std::runtime_error("Disparity stream has a run past the end of a row.");
+                        }
+                        for (uint32_t i = 0; i < run; ++i, ++x) {
+                            if (token == TOKEN_INVALID_RUN) {
+                                row[x] = T(invalid);
+                            } else {
+                                row[x] = store(predict(row, above, x, invalid, fallback));
+                                fallback = row[x];
+                            }
+                        }
+                        continue;
+                    }
+                    int residual;
+                    if (token == TOKEN_ESCAPE) {
+                        residual = unzigzag(reader.varint());
+                    } else if (token < TOKEN_ZERO_RUN) {
+                        residual = unzigzag(token);
+                    } else {
+                        throw std::runtime_error("Disparity stream has an unknown token.");
+                    }
+                    row[x] = store(predict(row, above, x, invalid, fallback) + residual);
+                    fallback = row[x];
+                    ++x;
+                }
+            }
+            if (reader.p != reader.end) {
+                throw std::runtime_error("Disparity stream has trailing bytes in a stripe.");
+            }
+        }
+
+        template<typename T>
+        std::vector<uint8_t> encodeValues(const cv::Mat &values, DisparityCodecKind kind, int invalid, double step,
+                                          const DisparityCodec::Options &options) {
+            if (options.stripeRows <= 0) {
+                throw std::invalid_argument("DisparityCodec stripeRows must be positive.");
+            }
+            const int stripeRows = options.stripeRows;
+            const int stripes = values.rows ? (values.rows + stripeRows - 1) / stripeRows : 0;
+            std::vector<std::vector<uint8_t> > payloads(stripes);
+            cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range &range) {
+                for (int s = range.start; s < range.end; ++s) {
+                    encodeStripe<T>(values, s * stripeRows, std::min(values.rows, (s + 1) * stripeRows), invalid,
+                                    payloads[s]);
+                }
+            });
+
+            std::vector<uint8_t> out(std::begin(MAGIC), std::end(MAGIC));
+            out.push_back(uint8_t(kind));
+            put32(out, uint32_t(values.cols));
+            put32(out, uint32_t(values.rows));
+            put32(out, uint32_t(invalid));
+            if (kind == DisparityCodecKind::Depth) {
+                uint64_t bits;
+                std::memcpy(&bits, &step, sizeof(bits));
+                put64(out, bits);
+            }
+            put32(out, uint32_t(stripeRows));
+            std::size_t total = out.size() + 4 * std::size_t(stripes);
+            for (const auto &payload : payloads) {
+                put32(out, uint32_t(payload.size()));
+                total += payload.size();
+            }
+            out.reserve(total);
+            for (const auto &payload : payloads) {
+                out.insert(out.end(), payload.begin(), payload.end());
+            }
+            return out;
+        }
+    }
+
+    std::vector<uint8_t> DisparityCodec::encode(const cv::Mat &disparity, const Options &options) {
+        if (disparity.type() != CV_16SC1) {
+            throw std::invalid_argument("DisparityCodec::encode expects a CV_16SC1 disparity map.");
+        }
+        return encodeValues<short>(disparity, Kind_::Disparity, options.invalidValue, 0.0, options);
+    }
+
+    std::vector<uint8_t> DisparityCodec::encodeDepth(const cv::Mat &depth, double step, const Options &options) {
+        if (depth.type() != CV_32FC1) {
+            throw std::invalid_argument("DisparityCodec::encodeDepth expects a CV_32FC1 depth map.");
+        }
+        if (!(step > 0.0)) {
+            throw std::invalid_argument("DisparityCodec::encodeDepth step must be positive.");
+        }
+        cv::Mat quantized(depth.size(), CV_16UC1);
+        const double inverse = 1.0 / step;
+        cv::parallel_for_(cv::Range(0, depth.rows), [&](const cv::Range &range) {
+            for (int y = range.start; y < range.end; ++y) {
+                const float *src = depth.ptr<float>(y);
+                auto *dst = quantized.ptr<ushort>(y);
+                for (int x = 0; x < depth.cols; ++x) {
+                    const double d = src[x];
+                    // Keep a positive depth from rounding to the invalid code.
+                    dst[x] = std::isfinite(d) && d > 0.0 ? ushort(std::clamp(std::lround(d * inverse), 1L, 65535L)) : 0;
+                }
+            }
+        });
+        return encodeValues<ushort>(quantized, Kind_::Depth, 0, step, options);
+    }
+
+    void DisparityCodec::decode(const uint8_t *data, std::size_t size, cv::Mat &output) {
+        Reader reader{data, data + size};
+        for (const uint8_t expected : MAGIC) {
+            if (reader.byte() != expected) {
+                throw std::runtime_error("Not a disparity codec stream.");
+            }
+        }
+        const uint8_t kind = reader.byte();
+        if (kind != uint8_t(Kind_::Disparity) && kind != uint8_t(Kind_::Depth)) {
+            throw std::runtime_error("Unknown disparity codec stream kind " + std::to_string(kind) + ".");
+        }
+        const uint32_t width = reader.u32(), height = reader.u32();
+        const int invalid = int(reader.u32());
+        double step = 0.0;
+        if (kind == uint8_t(Kind_::Depth)) {
+            const uint64_t bits = reader.u64();
+            std::memcpy(&step, &bits, sizeof(step));
+        }
+        const uint32_t stripeRows = reader.u32();
+        if (width > MAX_PIXELS || height > MAX_PIXELS || std::size_t(width) * height > MAX_PIXELS || !stripeRows) {
+            throw std::runtime_error("Disparity stream has an invalid header.");
+        }
+
+        // Encoders may write more rows per stripe than the image has; a stripe never spans more than all of them.
+        const uint64_t rowsPerStripe = std::min<uint64_t>(stripeRows, std::max<uint32_t>(height, 1));
+        const int stripes = int((uint64_t(height) + rowsPerStripe - 1) / rowsPerStripe);
+        std::vector<Reader> readers(stripes);
+        std::vector<std::size_t> lengths(stripes);
+        for (auto &length : lengths) length = reader.u32();
+        for (int s = 0; s < stripes; ++s) {
+            if (lengths[s] > std::size_t(reader.end - reader.p)) {
+                throw std::runtime_error("Disparity stream is truncated.");
+            }
+            readers[s] = Reader{reader.p, reader.p + lengths[s]};
+            reader.p += lengths[s];
+        }
+        if (reader.p != reader.end) {
+            throw std::runtime_error("Disparity stream has trailing bytes.");
+        }
+
+        const bool depth = kind == uint8_t(Kind_::Depth);
+        cv::Mat values(int(height), int(width), depth ? CV_16UC1 : CV_16SC1);
+        std::vector<char> failed(stripes, 0);
+        std::vector<std::string> errors(stripes);
+        cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range &range) {
+            for (int s = range.start; s < range.end; ++s) {
+                const int rowBegin = int(s * rowsPerStripe);
+                const int rowEnd = int(std::min<uint64_t>(height, rowBegin + rowsPerStripe));
+                try {
+                    if (depth) {
+                        decodeStripe<ushort>(readers[s], values, rowBegin, rowEnd, invalid);
+                    } else {
+                        decodeStripe<short>(readers[s], values, rowBegin, rowEnd, invalid);
+                    }
+                } catch (const std::exception &e) {
+                    failed[s] = 1;
+                    errors[s] = e.what();
+                }
+            }
+        });
+        for (int s = 0; s < stripes; ++s) {
+            if (failed[s]) {
+                throw std::runtime_error(errors[s] + " (stripe " + std::to_string(s) + ")");
+            }
+        }
+
+        if (depth) {
+            values.convertTo(output, CV_32F, step);
+        } else {
+            output = values;
+        }
+    }
+}
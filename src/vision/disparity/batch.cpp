@@ -0,0 +1,124 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/batch.h"
+#include "vision/disparity/sgbm.h"
+#include "vision/helpers/thread_pool.h"
+#include "vision/helpers/trace.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <yaml-cpp/yaml.h>
+
+namespace vlue::disparity {
+    BatchStereoMatcher::BatchStereoMatcher(const MatcherFactory &factory, Options options) : m_Options(options) {
+        if (!factory) {
+            throw std::invalid_argument("BatchStereoMatcher needs a matcher factory.");
+        }
+        if (m_Options.workers == 0) {
+            m_Options.workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        if (m_Options.maxInFlight <= 0) {
+            m_Options.maxInFlight = 2 * static_cast<int>(m_Options.workers);
+        }
+        for (unsigned i = 0; i < m_Options.workers; ++i) {
+            auto matcher = factory();
+            if (matcher == nullptr) {
+                throw std::invalid_argument("BatchStereoMatcher factory returned no matcher.");
+            }
+            m_Idle.push_back(std::move(matcher));
+        }
+        m_Pool = std::make_unique<utils::ThreadPool>(m_Options.workers);
+    }
+
+    BatchStereoMatcher::BatchStereoMatcher(const YAML::Node &disparity_config, Options options)
+        : BatchStereoMatcher([disparity_config] { return std::make_unique<StereoSGBM>(disparity_config); },
+                             options) {}
+
+    BatchStereoMatcher::~BatchStereoMatcher() {
+        // Lets queued frames finish; nobody waits for their results any more.
+        m_Pool.reset();
+    }
+
+    uint64_t BatchStereoMatcher::submit(const cv::Mat &left, const cv::Mat &right) {
+        BatchResult frame;
+        frame.left = m_Options.copyInputs ? left.clone() : left;
+        frame.right = m_Options.copyInputs ? right.clone() : right;
+
+        uint64_t sequence;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Space.wait(lock, [&] {
+                return m_Submitted - m_Delivered < static_cast<uint64_t>(m_Options.maxInFlight);
+            });
+            sequence = m_Submitted++;
+        }
+        frame.sequence = sequence;
+        m_Pool->post([this, sequence, frame = std::move(frame)]() mutable { process_(sequence, std::move(frame)); });
+        return sequence;
+    }
+
+    void BatchStereoMatcher::process_(uint64_t sequence, BatchResult result) {
+        std::unique_ptr<StereoSGBM> matcher;
+        {
+            // There are as many matchers as workers, so one is always free here.
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            matcher = std::move(m_Idle.back());
+            m_Idle.pop_back();
+        }
+
+        std::exception_ptr error;
+        try {
+            const utils::TraceFrame tag(sequence);
+            matcher->computeDisparity(result.left, result.right, result.leftDisparity, result.rightDisparity,
+                                      m_Options.computeRight);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Idle.push_back(std::move(matcher));
+            m_Finished.emplace(sequence, Finished{std::move(result), error});
+        }
+        m_Ready.notify_all();
+    }
+
+    bool BatchStereoMatcher::next(BatchResult &result, std::chrono::milliseconds timeout) {
+        Finished finished;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            const auto ready = [&] { return m_Finished.count(m_Delivered) != 0; };
+            if (timeout == std::chrono::milliseconds::max()) {
+                if (m_Delivered == m_Submitted) {
+                    return false;
+                }
+                m_Ready.wait(lock, ready);
+            } else if (!m_Ready.wait_for(lock, timeout, ready)) {
+                return false;
+            }
+            const auto it = m_Finished.find(m_Delivered);
+            finished = std::move(it->second);
+            m_Finished.erase(it);
+            ++m_Delivered;
+        }
+        m_Space.notify_one();
+        if (finished.error) {
+            std::rethrow_exception(finished.error);
+        }
+        result = std::move(finished.result);
+        return true;
+    }
+
+    bool BatchStereoMatcher::full() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Submitted - m_Delivered >= static_cast<uint64_t>(m_Options.maxInFlight);
+    }
+
+    std::size_t BatchStereoMatcher::pending() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return static_cast<std::size_t>(m_Submitted - m_Delivered);
+    }
+}
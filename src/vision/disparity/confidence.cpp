@@ -0,0 +1,92 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/confidence.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace vlue::disparity {
+    DisparityConfidence::DisparityConfidence(const Parameters &params) : m_Params(params) {
+        if (params.lrTolerance <= 0.0 || params.sigma <= 0.0) {
+            throw std::invalid_argument("Confidence tolerance and sigma must be positive.");
+        }
+        if (params.radius < 0) {
+            throw std::invalid_argument("Confidence window radius must not be negative.");
+        }
+    }
+
+    void DisparityConfidence::compute(const cv::Mat &leftDisparity, const cv::Mat &rightDisparity,
+                                      cv::Mat &confidence) const {
+        if (leftDisparity.type() != CV_16SC1) {
+            throw std::invalid_argument("Confidence expects a CV_16SC1 disparity map.");
+        }
+        const bool useRight = !rightDisparity.empty();
+        if (useRight && (rightDisparity.type() != CV_16SC1 || rightDisparity.size() != leftDisparity.size())) {
+            throw std::invalid_argument("Right disparity must be CV_16SC1 and match the left disparity map.");
+        }
+        const int rows = leftDisparity.rows, cols = leftDisparity.cols;
+        const int minDisparity = m_Params.minDisparity;
+        const short lowest = static_cast<short>(minDisparity * DISP_SCALE);
+        // Search range of cv::ximgproc::createRightMatcher for the same parameters.
+        const int rightMinDisparity = 1 - minDisparity - m_Params.numDisparities;
+
+        // Disparity (in pixels), its square and the validity mask, zero where invalid, so the window sums of
+        // all three only count valid pixels.
+        cv::Mat value(rows, cols, CV_32F), square(rows, cols, CV_32F), valid(rows, cols, CV_32F);
+        cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range &range) {
+            for (int y = range.start; y < range.end; ++y) {
+                const auto *d = leftDisparity.ptr<short>(y);
+                auto *v = value.ptr<float>(y);
+                auto *s = square.ptr<float>(y);
+                auto *m = valid.ptr<float>(y);
+                for (int x = 0; x < cols; ++x) {
+                    const float mask = d[x] >= lowest ? 1.0f : 0.0f;
+                    v[x] = mask * (static_cast<float>(d[x]) * (1.0f / DISP_SCALE));
+                    s[x] = v[x] * v[x];
+                    m[x] = mask;
+                }
+            }
+        });
+        const cv::Size window(2 * m_Params.radius + 1, 2 * m_Params.radius + 1);
+        cv::boxFilter(value, value, CV_32F, window, cv::Point(-1, -1), false);
+        cv::boxFilter(square, square, CV_32F, window, cv::Point(-1, -1), false);
+        cv::boxFilter(valid, valid, CV_32F, window, cv::Point(-1, -1), false);
+
+        confidence.create(rows, cols, CV_32F);
+        const auto sigma2 = static_cast<float>(m_Params.sigma * m_Params.sigma);
+        const auto tolerance = static_cast<float>(m_Params.lrTolerance * DISP_SCALE);
+        cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range &range) {
+            for (int y = range.start; y < range.end; ++y) {
+                const auto *d = leftDisparity.ptr<short>(y);
+                const auto *rd = useRight ? rightDisparity.ptr<short>(y) : nullptr;
+                const auto *sum = value.ptr<float>(y);
+                const auto *sumSq = square.ptr<float>(y);
+                const auto *count = valid.ptr<float>(y);
+                auto *c = confidence.ptr<float>(y);
+                for (int x = 0; x < cols; ++x) {
+                    if (d[x] < lowest) {
+                        c[x] = 0.0f;
+                        continue;
+                    }
+                    // count >= 1: the centre itself is valid.
+                    const float mean = sum[x] / count[x];
+                    const float variance = std::max(0.0f, sumSq[x] / count[x] - mean * mean);
+                    float score = sigma2 / (sigma2 + variance);
+                    if (useRight) {
+                        const int xr = x - ((d[x] + DISP_SCALE / 2) >> DISP_SHIFT);
+                        const float error = xr >= 0 && xr < cols && isValidDisparity(rd[xr], rightMinDisparity)
+                                                ? static_cast<float>(std::abs(d[x] + rd[xr]))
+                                                : tolerance;
+                        score *= std::max(0.0f, 1.0f - error / tolerance);
+                    }
+                    c[x] = score;
+                }
+            }
+        });
+    }
+}
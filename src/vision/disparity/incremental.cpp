@@ -0,0 +1,214 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/incremental.h"
+#include "vision/disparity/sgbm.h"
+#include "vision/helpers/trace.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+namespace vlue::disparity {
+    // Sum of |a - b| over `count` bytes, 16 at a time.
+    static uint64_t sad(const uchar *a, const uchar *b, int count) {
+        uint64_t sum = 0;
+        int i = 0;
+#if CV_SIMD128
+        for (; i <= count - 16; i += 16) {
+            sum += cv::v_reduce_sad(cv::v_load(a + i), cv::v_load(b + i));
+        }
+#endif
+        for (; i < count; ++i) {
+            sum += static_cast<uint64_t>(std::abs(a[i] - b[i]));
+        }
+        return sum;
+    }
+
+    IncrementalStereoMatcher::IncrementalStereoMatcher(std::shared_ptr<const StereoSGBM> matcher, Options options)
+        : m_Matcher(std::move(matcher)), m_Options(options) {
+        if (m_Matcher == nullptr) {
+            throw std::invalid_argument("IncrementalStereoMatcher needs a matcher.");
+        }
+        if (options.tileSize < 8 || options.threshold < 0.0 || options.dilate < 0 || options.margin < 0) {
+            throw std::invalid_argument("Incremental matching needs tiles of at least 8 pixels and non-negative "
+                                        "threshold, dilation and margin.");
+        }
+    }
+
+    void IncrementalStereoMatcher::changedTiles_(const cv::Mat &image, const cv::Mat &reference,
+                                                 std::vector<uint8_t> &changed, int tilesX, int tilesY) const {
+        const int tile = m_Options.tileSize;
+        const int channels = image.channels();
+        const double threshold = m_Options.threshold;
+        cv::parallel_for_(cv::Range(0, tilesY), [&](const cv::Range &range) {
+            std::vector<uint64_t> sums(tilesX);
+            for (int ty = range.start; ty < range.end; ++ty) {
+                const int y0 = ty * tile, y1 = std::min(image.rows, y0 + tile);
+                std::fill(sums.begin(), sums.end(), 0);
+                for (int y = y0; y < y1; ++y) {
+                    const uchar *a = image.ptr<uchar>(y), *b = reference.ptr<uchar>(y);
+                    for (int tx = 0; tx < tilesX; ++tx) {
+                        const int x0 = tx * tile * channels;
+                        const int x1 = std::min(image.cols, (tx + 1) * tile) * channels;
+                        sums[tx] += sad(a + x0, b + x0, x1 - x0);
+                    }
+                }
+                for (int tx = 0; tx < tilesX; ++tx) {
+                    const int bytes = (y1 - y0) * (std::min(image.cols, (tx + 1) * tile) - tx * tile) * channels;
+                    changed[ty * tilesX + tx] = static_cast<double>(sums[tx]) > threshold * bytes;
+                }
+            }
+        });
+    }
+
+    IncrementalFrameInfo IncrementalStereoMatcher::compute(const cv::Mat &left, const cv::Mat &right,
+                                                           cv::Mat &disparity) {
+        if (left.empty() || left.size() != right.size() || left.type() != right.type() || left.depth() != CV_8U) {
+            throw std::invalid_argument("Incremental matching expects two 8-bit views of the same size and type.");
+        }
+        const int tile = m_Options.tileSize;
+        const int tilesX = (left.cols + tile - 1) / tile, tilesY = (left.rows + tile - 1) / tile;
+        IncrementalFrameInfo info;
+        info.totalTiles = tilesX * tilesY;
+
+        const bool sameGeometry = m_RefLeft.size() == left.size() && m_RefLeft.type() == left.type();
+        const bool keyframeDue = m_Options.keyframeInterval > 0 &&
+                                 m_SinceKeyframe + 1 >= static_cast<uint64_t>(m_Options.keyframeInterval);
+        auto fullFrame = [&] {
+            const utils::TraceSpan span("match.incremental.full", "matcher");
+            cv::Mat rightDisparity;
+            m_Matcher->computeDisparity(left, right, m_Disparity, rightDisparity);
+            left.copyTo(m_RefLeft);
+            right.copyTo(m_RefRight);
+            m_SinceKeyframe = 0;
+            m_ForceKeyframe = false;
+            info.keyframe = true;
+            info.changedTiles = info.recomputedTiles = info.totalTiles;
+            info.matchedArea = 1.0;
+            m_Disparity.copyTo(disparity);
+            return info;
+        };
+        if (m_ForceKeyframe || !sameGeometry || keyframeDue) {
+            return fullFrame();
+        }
+        ++m_SinceKeyframe;
+
+        std::vector<uint8_t> leftChanged(info.totalTiles), rightChanged(info.totalTiles);
+        {
+            const utils::TraceSpan span("match.incremental.diff", "matcher");
+            changedTiles_(left, m_RefLeft, leftChanged, tilesX, tilesY);
+            changedTiles_(right, m_RefRight, rightChanged, tilesX, tilesY);
+        }
+
+        // Left tiles to recompute: changed ones, the ones matching into a changed right tile (a right pixel at xr
+        // is seen from left pixels xr + minDisparity ... xr + minDisparity + numDisparities - 1), then dilated.
+        const auto params = m_Matcher->getParameters();
+        const int minDisparity = params.minDisparity;
+        const int maxDisparity = params.minDisparity + params.numDisparities - 1;
+        std::vector<uint8_t> affected(info.totalTiles, 0);
+        for (int ty = 0; ty < tilesY; ++ty) {
+            for (int tx = 0; tx < tilesX; ++tx) {
+                const int index = ty * tilesX + tx;
+                info.changedTiles += leftChanged[index] || rightChanged[index];
+                if (leftChanged[index]) {
+                    affected[index] = 1;
+                }
+                if (rightChanged[index]) {
+                    const int first = std::max(0, (tx * tile + minDisparity) / tile);
+                    const int last = std::min(tilesX - 1, (std::min(left.cols, (tx + 1) * tile) - 1 + maxDisparity) / tile);
+                    for (int t = first; t <= last; ++t) {
+                        affected[ty * tilesX + t] = 1;
+                    }
+                }
+            }
+        }
+        if (info.changedTiles == 0) {
+            info.matchedArea = 0.0;
+            m_Disparity.copyTo(disparity);
+            return info;
+        }
+
+        std::vector<uint8_t> recompute(info.totalTiles, 0);
+        const int dilate = m_Options.dilate;
+        for (int ty = 0; ty < tilesY; ++ty) {
+            for (int tx = 0; tx < tilesX; ++tx) {
+                if (!affected[ty * tilesX + tx]) {
+                    continue;
+                }
+                for (int y = std::max(0, ty - dilate); y <= std::min(tilesY - 1, ty + dilate); ++y) {
+                    for (int x = std::max(0, tx - dilate); x <= std::min(tilesX - 1, tx + dilate); ++x) {
+                        recompute[y * tilesX + x] = 1;
+                    }
+                }
+            }
+        }
+        info.recomputedTiles = static_cast<int>(std::count(recompute.begin(), recompute.end(), 1));
+        if (info.recomputedTiles > m_Options.fullFraction * info.totalTiles) {
+            const int changed = info.changedTiles, recomputed = info.recomputedTiles;
+            fullFrame();
+            info.changedTiles = changed;
+            info.recomputedTiles = recomputed;
+            return info;
+        }
+
+        // Greedy rectangle cover: grow right along the row, then down while the whole span stays marked.
+        const utils::TraceSpan span("match.incremental.tiles", "matcher");
+        const int reach = std::max(0, maxDisparity) + m_Options.margin;
+        const int verticalMargin = m_Options.margin + params.blockSize / 2;
+        const int align = std::max(1, params.downscale);
+        double matchedPixels = 0.0;
+        for (int ty = 0; ty < tilesY; ++ty) {
+            for (int tx = 0; tx < tilesX; ++tx) {
+                if (!recompute[ty * tilesX + tx]) {
+                    continue;
+                }
+                int tx1 = tx + 1;
+                while (tx1 < tilesX && recompute[ty * tilesX + tx1]) {
+                    ++tx1;
+                }
+                int ty1 = ty + 1;
+                while (ty1 < tilesY && std::all_of(recompute.begin() + ty1 * tilesX + tx,
+                                                   recompute.begin() + ty1 * tilesX + tx1,
+                                                   [](uint8_t r) { return r != 0; })) {
+                    ++ty1;
+                }
+                for (int y = ty; y < ty1; ++y) {
+                    std::fill(recompute.begin() + y * tilesX + tx, recompute.begin() + y * tilesX + tx1, 0);
+                }
+
+                const cv::Rect target(tx * tile, ty * tile, std::min(left.cols, tx1 * tile) - tx * tile,
+                                      std::min(left.rows, ty1 * tile) - ty * tile);
+                // Crop origin aligned to the matcher's downscale factor so its pyramid lines up with the frame's.
+                const int xs = std::max(0, target.x - reach) / align * align;
+                const int ys = std::max(0, target.y - verticalMargin) / align * align;
+                const int xe = std::min(left.cols, target.x + target.width + m_Options.margin);
+                const int ye = std::min(left.rows, target.y + target.height + verticalMargin);
+                const cv::Rect crop(xs, ys, xe - xs, ye - ys);
+
+                cv::Mat cropDisparity, cropRightDisparity;
+                m_Matcher->computeDisparity(left(crop), right(crop), cropDisparity, cropRightDisparity);
+                cropDisparity(target - crop.tl()).copyTo(m_Disparity(target));
+                left(target).copyTo(m_RefLeft(target));
+                matchedPixels += crop.area();
+            }
+        }
+
+        // Right reference tiles are refreshed once everything that matches into them has been recomputed.
+        for (int ty = 0; ty < tilesY; ++ty) {
+            for (int tx = 0; tx < tilesX; ++tx) {
+                if (rightChanged[ty * tilesX + tx]) {
+                    const cv::Rect region(tx * tile, ty * tile, std::min(left.cols, (tx + 1) * tile) - tx * tile,
+                                          std::min(left.rows, (ty + 1) * tile) - ty * tile);
+                    right(region).copyTo(m_RefRight(region));
+                }
+            }
+        }
+
+        info.matchedArea = matchedPixels / static_cast<double>(left.total());
+        m_Disparity.copyTo(disparity);
+        return info;
+    }
+}
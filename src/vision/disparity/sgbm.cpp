@@ -3,9 +3,20 @@
 //
 
 #include "vision/disparity/sgbm.h"
+#include "vision/disparity/upsampling.h"
+#include "vision/disparity/confidence.h"
 #include "vision/pipeline/pipeline.h"
+#include "vision/pipeline/pointwise.h"
+#include "vision/pipeline/pipeline_factory.h"
 #include "vision/helpers/yaml.h"
+#include "vision/helpers/file_watcher.h"
+#include "vision/helpers/memory_tracker.h"
+#include "vision/helpers/trace.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <opencv2/imgproc.hpp>
 #include <opencv2/ximgproc/disparity_filter.hpp>
 
 using namespace vlue::utils;
@@ -14,37 +25,173 @@ using namespace vlue::processing;
 namespace vlue::disparity {
     StereoSGBM::StereoSGBM(const std::string &disparity_param_path) : StereoSGBM(YAMLUtils::loadYamlConfig(disparity_param_path)) {}
 
-    StereoSGBM::StereoSGBM(const YAML::Node &disparity_config) {
-        int minDisparity = disparity_config["minDisparity"].as<int>(0);
-        int numDisparities = disparity_config["numDisparities"].as<int>(16);
-        int blockSize = disparity_config["blockSize"].as<int>(3);
-        int P1 = disparity_config["P1"].as<int>(0);
-        int P2 = disparity_config["P2"].as<int>(0);
-        int disp12MaxDiff = disparity_config["disp12MaxDiff"].as<int>(0);
-        int preFilterCap = disparity_config["preFilterCap"].as<int>(0);
-        int uniquenessRatio = disparity_config["uniquenessRatio"].as<int>(0);
-        int speckleWindowSize = disparity_config["speckleWindowSize"].as<int>(0);
-        int speckleRange = disparity_config["speckleRange"].as<int>(0);
-        int mode = disparity_config["mode"].as<int>(MODE_SGBM);
+    StereoSGBM::StereoSGBM(const YAML::Node &disparity_config) : StereoSGBM(parseParameters(disparity_config)) {
+        for (const auto &pipeline : PipelineFactory::createAll(disparity_config["preprocess"])) {
+            registerPreprocessPipeline(pipeline);
+        }
+        for (const auto &pipeline : PipelineFactory::createAll(disparity_config["postprocess"])) {
+            registerPostprocessPipeline(pipeline);
+        }
+    }
+
+    StereoSGBM::StereoSGBM(const Parameters &params) : m_Matchers(createMatchers_(params)) {}
+
+    StereoSGBM::StereoSGBM(int minDisparity, int numDisparities, int blockSize, int P1, int P2, int disp12MaxDiff, int preFilterCap, int uniquenessRatio, int speckleWindowSize, int speckleRange, int mode)
+        : StereoSGBM(Parameters{minDisparity, numDisparities, blockSize, P1, P2, disp12MaxDiff, preFilterCap, uniquenessRatio, speckleWindowSize, speckleRange, mode}) {}
+
+    StereoSGBM::Parameters StereoSGBM::parseParameters(const YAML::Node &disparity_config) {
+        Parameters params;
+        params.minDisparity = disparity_config["minDisparity"].as<int>(0);
+        params.numDisparities = disparity_config["numDisparities"].as<int>(16);
+        params.blockSize = disparity_config["blockSize"].as<int>(3);
+        params.P1 = disparity_config["P1"].as<int>(0);
+        params.P2 = disparity_config["P2"].as<int>(0);
+        params.disp12MaxDiff = disparity_config["disp12MaxDiff"].as<int>(0);
+        params.preFilterCap = disparity_config["preFilterCap"].as<int>(0);
+        params.uniquenessRatio = disparity_config["uniquenessRatio"].as<int>(0);
+        params.speckleWindowSize = disparity_config["speckleWindowSize"].as<int>(0);
+        params.speckleRange = disparity_config["speckleRange"].as<int>(0);
+        params.mode = disparity_config["mode"].as<int>(MODE_SGBM);
+        params.downscale = disparity_config["downscale"].as<int>(1);
+        if (const auto confidence = disparity_config["confidence"]) {
+            params.confidenceTolerance = confidence["tolerance"].as<double>(params.confidenceTolerance);
+            params.confidenceRadius = confidence["radius"].as<int>(params.confidenceRadius);
+            params.confidenceSigma = confidence["sigma"].as<double>(params.confidenceSigma);
+        }
+        return params;
+    }
+
+    std::shared_ptr<const StereoSGBM::MatcherSet> StereoSGBM::createMatchers_(const Parameters &params) {
+        const int f = params.downscale;
+        if (f != 1 && f != 2 && f != 4) {
+            throw std::invalid_argument("Disparity downscale factor must be 1, 2 or 4. Got: " + std::to_string(f));
+        }
+
+        // At 1/f resolution every disparity shrinks by f, so the search range does too. SGBM needs
+        // numDisparities to stay a positive multiple of 16.
+        const int minDisparity = static_cast<int>(std::floor(static_cast<double>(params.minDisparity) / f));
+        const int numDisparities = std::max(16, (params.numDisparities / f + 15) / 16 * 16);
+        const int disp12MaxDiff = params.disp12MaxDiff > 0 ? std::max(1, params.disp12MaxDiff / f) : params.disp12MaxDiff;
+        const int speckleWindowSize = params.speckleWindowSize / (f * f);
+        const int speckleRange = params.speckleRange > 0 ? std::max(1, params.speckleRange / f) : 0;
+
+        auto matchers = std::make_shared<MatcherSet>();
+        matchers->params = params;
+        matchers->left = cv::StereoSGBM::create(minDisparity, numDisparities, params.blockSize, params.P1, params.P2, disp12MaxDiff, params.preFilterCap, params.uniquenessRatio, speckleWindowSize, speckleRange, params.mode);
+        matchers->right = cv::ximgproc::createRightMatcher(cv::Ptr(matchers->left)).dynamicCast<cv::StereoSGBM>();
+        if (f > 1) {
+            matchers->upsampler = std::make_shared<DisparityUpsampler>();
+        }
+
+        // The right map's invalid value follows the right matcher's range, scaled back up when downscaling.
+        DisparityConfidence::Parameters confidence;
+        confidence.minDisparity = params.minDisparity;
+        confidence.numDisparities = 1 - params.minDisparity - matchers->right->getMinDisparity() * f;
+        confidence.lrTolerance = params.confidenceTolerance;
+        confidence.radius = params.confidenceRadius;
+        confidence.sigma = params.confidenceSigma;
+        matchers->confidence = std::make_shared<DisparityConfidence>(confidence);
+        return matchers;
+    }
+
+    StereoSGBM::StereoSGBM(const StereoSGBM &other)
+        : m_Preprocess(other.m_Preprocess), m_PostProcess(other.m_PostProcess),
+          m_PreprocessPlan(other.m_PreprocessPlan), m_PostProcessPlan(other.m_PostProcessPlan),
+          m_Matchers(other.m_Matchers) {}
+
+    StereoSGBM &StereoSGBM::operator=(const StereoSGBM &other) {
+        if (this != &other) {
+            // This instance now mirrors `other`; whatever file it was following no longer describes it.
+            m_Watcher.reset();
+            m_Preprocess = other.m_Preprocess;
+            m_PostProcess = other.m_PostProcess;
+            m_PreprocessPlan = other.m_PreprocessPlan;
+            m_PostProcessPlan = other.m_PostProcessPlan;
+            m_Matchers = other.m_Matchers;
+        }
+        return *this;
+    }
+
+    StereoSGBM::Parameters StereoSGBM::getParameters() const {
+        return m_Matchers.load()->params;
+    }
+
+    void StereoSGBM::setDownscale(int factor) {
+        Parameters params = getParameters();
+        params.downscale = factor;
+        updateParameters(params);
+    }
+
+    void StereoSGBM::updateParameters(const Parameters &params) {
+        m_Matchers.store(createMatchers_(params));
+    }
+
+    void StereoSGBM::updateParameters(const YAML::Node &disparity_config) {
+        updateParameters(parseParameters(disparity_config));
+        updateStages_(m_Preprocess, disparity_config["preprocess"], "preprocess");
+        updateStages_(m_PostProcess, disparity_config["postprocess"], "postprocess");
+    }
 
-        m_MatcherLeft = cv::StereoSGBM::create(minDisparity, numDisparities, blockSize, P1, P2, disp12MaxDiff, preFilterCap, uniquenessRatio, speckleWindowSize, speckleRange, mode);
-        m_MatcherRight = cv::ximgproc::createRightMatcher(cv::Ptr(m_MatcherLeft)).dynamicCast<cv::StereoSGBM>();
+    void StereoSGBM::updateStages_(const std::vector<PipelinePtr> &stages, const YAML::Node &config,
+                                   const char *section) {
+        const std::size_t entries = config && config.IsSequence() ? config.size() : 0;
+        if (entries != stages.size()) {
+            std::cerr << "Warning: the " << section << " chain changed shape (" << stages.size() << " stages, "
+                      << entries << " entries); its stages keep their parameters until restart." << std::endl;
+            return;
+        }
+        for (std::size_t i = 0; i < entries; ++i) {
+            PipelineFactory::update(*stages[i], config[i]);
+        }
+    }
+
+    void StereoSGBM::watchParameterFile(const std::string &disparity_param_path, std::chrono::milliseconds interval) {
+        m_Watcher.reset();
+        m_Watcher = std::make_shared<FileWatcher>(disparity_param_path, [this](const std::string &path) {
+            updateParameters(YAMLUtils::loadYamlConfig(path));
+            std::cout << "Info: reloaded disparity parameters from " << path << std::endl;
+        }, interval);
     }
 
-    StereoSGBM::StereoSGBM(int minDisparity, int numDisparities, int blockSize, int P1, int P2, int disp12MaxDiff, int preFilterCap, int uniquenessRatio, int speckleWindowSize, int speckleRange, int mode) {
-        m_MatcherLeft = cv::StereoSGBM::create(minDisparity, numDisparities, blockSize, P1, P2, disp12MaxDiff, preFilterCap, uniquenessRatio, speckleWindowSize, speckleRange, mode);
-        m_MatcherRight = cv::ximgproc::createRightMatcher(cv::Ptr(m_MatcherLeft)).dynamicCast<cv::StereoSGBM>();
+    void StereoSGBM::stopWatchingParameterFile() {
+        m_Watcher.reset();
+    }
+
+    std::vector<StereoSGBM::PlannedStage> StereoSGBM::plan_(const std::vector<PipelinePtr> &pipelines) {
+        std::vector<PlannedStage> plan;
+        for (auto &pipeline : FusedPointwisePipeline::fuse(pipelines)) {
+            const char *traceName = Tracer::intern(typeid(*pipeline));
+            MemoryTracker::Region *memoryRegion = MemoryTracker::instance().region(typeid(*pipeline));
+            plan.push_back({std::move(pipeline), traceName, memoryRegion});
+        }
+        return plan;
     }
 
     void StereoSGBM::registerPreprocessPipeline(const PipelinePtr &pipeline) {
         m_Preprocess.push_back(pipeline);
+        m_PreprocessPlan = plan_(m_Preprocess);
     }
 
     void StereoSGBM::registerPostprocessPipeline(const PipelinePtr &pipeline) {
         m_PostProcess.push_back(pipeline);
+        m_PostProcessPlan = plan_(m_PostProcess);
     }
 
     void StereoSGBM::computeDisparity(const cv::Mat &left, const cv::Mat& right, cv::Mat &leftDisparity, cv::Mat &rightDisparity, bool computeRight) const {
+        preprocessAndMatch_(left, right, leftDisparity, rightDisparity);
+        postprocess(leftDisparity, left, rightDisparity, right, computeRight);
+    }
+
+    void StereoSGBM::computeDisparity(const cv::Mat &left, const cv::Mat &right, cv::Mat &leftDisparity,
+                                      cv::Mat &rightDisparity, cv::Mat &confidence, bool computeRight) const {
+        // Score with the snapshot the frame was matched with, whatever updateParameters() did meanwhile.
+        const auto matchers = preprocessAndMatch_(left, right, leftDisparity, rightDisparity);
+        postprocess(leftDisparity, left, rightDisparity, right, computeRight);
+        const TraceSpan span("match.confidence", "matcher");
+        matchers->confidence->compute(leftDisparity, rightDisparity, confidence);
+    }
+
+    std::shared_ptr<const StereoSGBM::MatcherSet> StereoSGBM::preprocessAndMatch_(const cv::Mat &left, const cv::Mat &right, cv::Mat &leftDisparity, cv::Mat &rightDisparity) const {
         cv::Mat m_Left = left.clone();
         cv::Mat m_Right = right.clone();
         if (left.empty() || right.empty()) {
@@ -55,15 +202,53 @@ namespace vlue::disparity {
                                          + std::to_string(left.rows) + "x" + std::to_string(left.cols)
                                          + ", right: " + std::to_string(right.rows) + "x" + std::to_string(right.cols));
         }
+        // One snapshot per frame: a concurrent updateParameters() cannot mix old and new matchers.
+        const std::shared_ptr<const MatcherSet> matchers = m_Matchers.load();
         preprocess(m_Left, m_Right);
-        m_MatcherLeft->compute(m_Left, m_Right, leftDisparity);
-        if (!right.empty()) {
-            m_MatcherRight->compute(m_Right, m_Left, rightDisparity);
+        match_(*matchers, m_Left, m_Right, leftDisparity, rightDisparity);
+        return matchers;
+    }
+
+    void StereoSGBM::match_(const MatcherSet &matchers, const cv::Mat &left, const cv::Mat &right, cv::Mat &leftDisparity, cv::Mat &rightDisparity) {
+        const ScopedMemoryRegion region(MemoryTracker::regionOf<StereoSGBM>());
+        const int f = matchers.params.downscale;
+        if (f == 1) {
+            {
+                const TraceSpan span("match.left", "matcher");
+                matchers.left->compute(left, right, leftDisparity);
+            }
+            if (!right.empty()) {
+                const TraceSpan span("match.right", "matcher");
+                matchers.right->compute(right, left, rightDisparity);
+            }
+            return;
+        }
+
+        cv::Mat smallLeft, smallRight, smallLeftDisparity, smallRightDisparity;
+        const cv::Size smallSize(left.cols / f, left.rows / f);
+        cv::resize(left, smallLeft, smallSize, 0, 0, cv::INTER_AREA);
+        cv::resize(right, smallRight, smallSize, 0, 0, cv::INTER_AREA);
+
+        {
+            const TraceSpan span("match.left", "matcher");
+            matchers.left->compute(smallLeft, smallRight, smallLeftDisparity);
         }
+        {
+            const TraceSpan span("match.upsample.left", "matcher");
+            matchers.upsampler->upsample(smallLeftDisparity, left, leftDisparity, f, matchers.left->getMinDisparity(), matchers.params.minDisparity);
+        }
+        {
+            const TraceSpan span("match.right", "matcher");
+            matchers.right->compute(smallRight, smallLeft, smallRightDisparity);
+        }
+        const TraceSpan span("match.upsample.right", "matcher");
+        matchers.upsampler->upsample(smallRightDisparity, right, rightDisparity, f, matchers.right->getMinDisparity(), matchers.right->getMinDisparity() * f);
     }
 
     void StereoSGBM::preprocess(cv::Mat &left, cv::Mat &right) const {
-        for (const auto &pipeline : m_Preprocess) {
+        for (const auto &[pipeline, traceName, memoryRegion] : m_PreprocessPlan) {
+            const ScopedMemoryRegion region(memoryRegion);
+            const TraceSpan span(traceName, "preprocess");
             left = pipeline->process(left);
             right = pipeline->process(right);
         }
@@ -71,13 +256,26 @@ namespace vlue::disparity {
 
     void StereoSGBM::postprocess(cv::Mat &leftDisparity, const cv::Mat &leftView, cv::Mat &rightDisparity,
         const cv::Mat &rightView, bool filterRight) const {
-        for (const auto &pipeline : m_PostProcess) {
+        for (const auto &[pipeline, traceName, memoryRegion] : m_PostProcessPlan) {
+            const ScopedMemoryRegion region(memoryRegion);
+            const TraceSpan span(traceName, "postprocess");
+            if (pipeline->getType() == PipelineType::Pointwise) {
+                try {
+                    leftDisparity = pipeline->process(leftDisparity);
+                    if (filterRight) {
+                        rightDisparity = pipeline->process(rightDisparity);
+                    }
+                } catch (const std::exception &e) {
+                    std::cerr << "Error in pointwise processing pipeline: " << e.what() << std::endl;
+                }
+                continue;
+            }
             if (pipeline->getType() != PipelineType::DisparityMap) {
                 continue;
             }
             if (auto m_Pipeline = std::dynamic_pointer_cast<DisparityFilterPipeline>(pipeline)) { // Check successful cast
                 try {
-                    leftDisparity = m_Pipeline->process(leftDisparity, leftView, leftView, rightView);
+                    leftDisparity = m_Pipeline->process(leftDisparity, leftView, rightDisparity, rightView);
                     if (filterRight) {
                         rightDisparity = m_Pipeline->process(rightDisparity, rightView, leftDisparity, leftView);
                     }
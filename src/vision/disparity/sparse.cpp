@@ -0,0 +1,191 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/sparse.h"
+#include "vision/helpers/memory_tracker.h"
+#include "vision/helpers/trace.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+namespace vlue::disparity {
+    struct SparseStereoMatcher::Workspace {
+        std::vector<uint16_t> sad;
+        std::vector<int> costs;
+        std::vector<uint32_t> leftCensus, rightCensus;
+    };
+
+    // 5x5 census without the centre: bit set where the neighbour is darker than the centre.
+    static constexpr int CENSUS_RADIUS = 2;
+
+    static uint32_t census(const cv::Mat &image, int x, int y) {
+        const uchar centre = image.ptr<uchar>(y)[x];
+        uint32_t bits = 0;
+        for (int dy = -CENSUS_RADIUS; dy <= CENSUS_RADIUS; ++dy) {
+            const uchar *row = image.ptr<uchar>(y + dy);
+            for (int dx = -CENSUS_RADIUS; dx <= CENSUS_RADIUS; ++dx) {
+                if (dx != 0 || dy != 0) {
+                    bits = (bits << 1) | static_cast<uint32_t>(row[x + dx] < centre);
+                }
+            }
+        }
+        return bits;
+    }
+
+    SparseStereoMatcher::SparseStereoMatcher(const Parameters &params, const cv::Mat &Q) : m_Params(params) {
+        if (params.numDisparities <= 0) {
+            throw std::invalid_argument("numDisparities must be positive.");
+        }
+        if (params.blockSize < 1 || params.blockSize > 15 || params.blockSize % 2 == 0) {
+            throw std::invalid_argument("blockSize must be odd and within [1, 15].");
+        }
+        setQ(Q);
+    }
+
+    void SparseStereoMatcher::setQ(const cv::Mat &Q) {
+        if (Q.empty()) {
+            m_Q.release();
+            return;
+        }
+        if (Q.rows != 4 || Q.cols != 4) {
+            throw std::invalid_argument("Q must be a 4x4 reprojection matrix.");
+        }
+        Q.convertTo(m_Q, CV_64F);
+    }
+
+    void SparseStereoMatcher::match(const cv::Mat &left, const cv::Mat &right, const std::vector<cv::Point2f> &points,
+                                    std::vector<SparseMatch> &matches) const {
+        if (left.type() != CV_8UC1 || right.type() != CV_8UC1) {
+            throw std::invalid_argument("Sparse matching expects rectified CV_8UC1 images.");
+        }
+        if (left.size() != right.size()) {
+            throw std::invalid_argument("Left and right images must have the same size.");
+        }
+        const utils::ScopedMemoryRegion region(utils::MemoryTracker::regionOf<SparseStereoMatcher>());
+        const utils::TraceSpan span("match.sparse", "matcher");
+        matches.assign(points.size(), SparseMatch());
+        cv::parallel_for_(cv::Range(0, static_cast<int>(points.size())), [&](const cv::Range &range) {
+            Workspace workspace;
+            for (int i = range.start; i < range.end; ++i) {
+                matches[i] = matchPoint_(left, right, points[i], workspace);
+            }
+        });
+    }
+
+    SparseMatch SparseStereoMatcher::matchPoint_(const cv::Mat &left, const cv::Mat &right, const cv::Point2f &point,
+                                                 Workspace &ws) const {
+        SparseMatch result;
+        const bool useCensus = m_Params.cost == Cost_::Census;
+        const int r = m_Params.blockSize / 2;
+        const int margin = r + (useCensus ? CENSUS_RADIUS : 0);
+        const int x = cvRound(point.x), y = cvRound(point.y);
+        const int cols = left.cols;
+        if (y - margin < 0 || y + margin >= left.rows || x - margin < 0 || x + margin >= cols) {
+            return result;
+        }
+
+        // Candidates whose right window stays inside the image, searched as k = dMax - d.
+        const int dMax = std::min(m_Params.minDisparity + m_Params.numDisparities - 1, x - margin);
+        const int dMin = std::max(m_Params.minDisparity, x + margin - cols + 1);
+        const int n = dMax - dMin + 1;
+        if (n <= 0) {
+            return result;
+        }
+        const int width = 2 * r + 1;
+        ws.costs.assign(n, 0);
+
+        if (!useCensus) {
+            // costs[k] += |L(x - r + i, y + j) - R(x - r + i - dMax + k, y + j)|, 16 disparities per step.
+            ws.sad.assign(n, 0);
+            uint16_t *acc = ws.sad.data();
+            for (int j = -r; j <= r; ++j) {
+                const uchar *l = left.ptr<uchar>(y + j) + x - r;
+                const uchar *rowR = right.ptr<uchar>(y + j) + x - r - dMax;
+                for (int i = 0; i < width; ++i) {
+                    const uchar *s = rowR + i;
+                    int k = 0;
+#if CV_SIMD128
+                    const cv::v_uint8x16 lv = cv::v_setall_u8(l[i]);
+                    for (; k <= n - 16; k += 16) {
+                        cv::v_uint16x8 lo, hi;
+                        cv::v_expand(cv::v_absdiff(lv, cv::v_load(s + k)), lo, hi);
+                        cv::v_store(acc + k, cv::v_load(acc + k) + lo);
+                        cv::v_store(acc + k + 8, cv::v_load(acc + k + 8) + hi);
+                    }
+#endif
+                    for (; k < n; ++k) {
+                        acc[k] = static_cast<uint16_t>(acc[k] + std::abs(l[i] - s[k]));
+                    }
+                }
+            }
+            std::copy(ws.sad.begin(), ws.sad.end(), ws.costs.begin());
+        } else {
+            // Census only over the strip the search touches: the left window and n + 2r right columns per row.
+            const int strip = n + 2 * r;
+            ws.leftCensus.resize(width * width);
+            ws.rightCensus.resize(width * strip);
+            for (int j = 0; j < width; ++j) {
+                for (int i = 0; i < width; ++i) {
+                    ws.leftCensus[j * width + i] = census(left, x - r + i, y - r + j);
+                }
+                for (int i = 0; i < strip; ++i) {
+                    ws.rightCensus[j * strip + i] = census(right, x - r - dMax + i, y - r + j);
+                }
+            }
+            for (int j = 0; j < width; ++j) {
+                const uint32_t *cl = ws.leftCensus.data() + j * width;
+                const uint32_t *cr = ws.rightCensus.data() + j * strip;
+                for (int i = 0; i < width; ++i) {
+                    for (int k = 0; k < n; ++k) {
+                        ws.costs[k] += static_cast<int>(std::bitset<32>(cl[i] ^ cr[i + k]).count());
+                    }
+                }
+            }
+        }
+
+        const auto &costs = ws.costs;
+        const int best = static_cast<int>(std::min_element(costs.begin(), costs.end()) - costs.begin());
+        int second = std::numeric_limits<int>::max();
+        for (int k = 0; k < n; ++k) {
+            if (std::abs(k - best) > 1) {
+                second = std::min(second, costs[k]);
+            }
+        }
+        result.confidence = second == std::numeric_limits<int>::max() || second == 0
+                                ? 0.0f
+                                : static_cast<float>(second - costs[best]) / static_cast<float>(second);
+        if (result.confidence < m_Params.uniquenessRatio) {
+            return result;
+        }
+
+        float disparity = static_cast<float>(dMax - best);
+        if (m_Params.subpixel && best > 0 && best < n - 1) {
+            const int curvature = costs[best - 1] - 2 * costs[best] + costs[best + 1];
+            if (curvature > 0) {
+                disparity -= static_cast<float>(costs[best - 1] - costs[best + 1]) / (2.0f * static_cast<float>(curvature));
+            }
+        }
+        result.valid = true;
+        result.disparity = disparity;
+
+        if (!m_Q.empty()) {
+            const auto *q = m_Q.ptr<double>();
+            const double v[4] = {point.x, point.y, disparity, 1.0};
+            double out[4];
+            for (int row = 0; row < 4; ++row) {
+                out[row] = q[4 * row] * v[0] + q[4 * row + 1] * v[1] + q[4 * row + 2] * v[2] + q[4 * row + 3] * v[3];
+            }
+            if (out[3] != 0.0) {
+                result.point = cv::Point3f(static_cast<float>(out[0] / out[3]), static_cast<float>(out[1] / out[3]),
+                                           static_cast<float>(out[2] / out[3]));
+                result.depth = result.point.z;
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,113 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/upsampling.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace vlue::disparity {
+    DisparityUpsampler::DisparityUpsampler(int radius, double sigmaColor, double sigmaSpatial)
+        : m_Radius(radius), m_SigmaColor(sigmaColor), m_SigmaSpatial(sigmaSpatial) {
+        if (radius < 1 || sigmaColor <= 0.0 || sigmaSpatial <= 0.0) {
+            throw std::invalid_argument("Upsampler radius and sigmas must be positive.");
+        }
+    }
+
+    void DisparityUpsampler::upsample(const cv::Mat &lowDisparity, const cv::Mat &guide, cv::Mat &dst, int factor,
+                                      int lowMinDisparity, int dstMinDisparity) const {
+        if (lowDisparity.type() != CV_16SC1) {
+            throw std::invalid_argument("Upsampler expects a CV_16SC1 disparity map.");
+        }
+        if (factor < 1) {
+            throw std::invalid_argument("Upsampling factor must be at least 1.");
+        }
+
+        cv::Mat gray;
+        if (guide.channels() == 3) {
+            cv::cvtColor(guide, gray, cv::COLOR_BGR2GRAY);
+        } else if (guide.channels() == 4) {
+            cv::cvtColor(guide, gray, cv::COLOR_BGRA2GRAY);
+        } else if (guide.depth() != CV_8U) {
+            guide.convertTo(gray, CV_8U);
+        } else {
+            gray = guide;
+        }
+
+        const int r = m_Radius, taps = 2 * r + 1;
+        const int rows = gray.rows, cols = gray.cols;
+        const int lowRows = lowDisparity.rows, lowCols = lowDisparity.cols;
+
+        // A full-resolution pixel k * factor + m always sits next to low-resolution sample k, so the spatial
+        // weights only depend on m and are tabulated once per call.
+        std::vector<float> spatial(static_cast<size_t>(factor) * taps);
+        const double spatialDenom = 2.0 * m_SigmaSpatial * m_SigmaSpatial;
+        for (int m = 0; m < factor; ++m) {
+            const double centre = (m + 0.5) / factor - 0.5;
+            for (int i = -r; i <= r; ++i) {
+                const double dist = i - centre;
+                spatial[m * taps + i + r] = static_cast<float>(std::exp(-dist * dist / spatialDenom));
+            }
+        }
+        float range[256];
+        const double colorDenom = 2.0 * m_SigmaColor * m_SigmaColor;
+        for (int i = 0; i < 256; ++i) {
+            range[i] = static_cast<float>(std::exp(-i * i / colorDenom));
+        }
+
+        const short lowValid = static_cast<short>(lowMinDisparity * DISP_SCALE);
+        const short invalid = invalidDisparity(dstMinDisparity);
+        // The low-resolution range is floored, so scaled-up values can undershoot the full-resolution minimum.
+        const short dstValid = static_cast<short>(dstMinDisparity * DISP_SCALE);
+        const int half = factor / 2;
+        dst.create(rows, cols, CV_16SC1);
+
+        cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range &rowRange) {
+            std::vector<const uchar *> guideRows(taps);
+            for (int y = rowRange.start; y < rowRange.end; ++y) {
+                const uchar *g = gray.ptr<uchar>(y);
+                auto *out = dst.ptr<short>(y);
+                const int ky = y / factor;
+                const float *wy = spatial.data() + (y % factor) * taps;
+                for (int j = 0; j < taps; ++j) {
+                    const int qy = ky + j - r;
+                    guideRows[j] = qy >= 0 && qy < lowRows ? gray.ptr<uchar>(std::min(qy * factor + half, rows - 1))
+                                                           : nullptr;
+                }
+
+                for (int x = 0; x < cols; ++x) {
+                    const int kx = x / factor;
+                    const float *wx = spatial.data() + (x % factor) * taps;
+                    const int gp = g[x];
+                    float sumWeight = 0.0f, sumDisparity = 0.0f;
+                    for (int j = 0; j < taps; ++j) {
+                        if (!guideRows[j]) {
+                            continue;
+                        }
+                        const auto *low = lowDisparity.ptr<short>(ky + j - r);
+                        for (int i = 0; i < taps; ++i) {
+                            const int qx = kx + i - r;
+                            if (qx < 0 || qx >= lowCols || low[qx] < lowValid) {
+                                continue;
+                            }
+                            const int gq = guideRows[j][std::min(qx * factor + half, cols - 1)];
+                            const float w = wx[i] * wy[j] * range[std::abs(gp - gq)];
+                            sumWeight += w;
+                            sumDisparity += w * low[qx];
+                        }
+                    }
+                    out[x] = sumWeight > 1e-6f
+                                 ? std::max(dstValid, cv::saturate_cast<short>(sumDisparity / sumWeight *
+                                                                               static_cast<float>(factor)))
+                                 : invalid;
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,229 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/evaluation/dataset.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <opencv2/imgcodecs.hpp>
+
+namespace fs = std::filesystem;
+
+namespace vlue::evaluation {
+    StereoDataset::StereoDataset(std::vector<StereoSample> samples) : m_Samples(std::move(samples)) {
+        std::sort(m_Samples.begin(), m_Samples.end(),
+                  [](const StereoSample &a, const StereoSample &b) { return a.name < b.name; });
+    }
+
+    bool StereoDataset::hasGroundTruth() const {
+        return std::any_of(m_Samples.begin(), m_Samples.end(),
+                           [](const StereoSample &sample) { return !sample.groundTruth.empty(); });
+    }
+
+    cv::Mat readScaledDisparity(const std::string &path, double scale) {
+        if (!fs::exists(path)) {
+            return {};
+        }
+        const cv::Mat raw = cv::imread(path, cv::IMREAD_ANYDEPTH | cv::IMREAD_GRAYSCALE);
+        if (raw.empty()) {
+            throw std::runtime_error("Failed to read disparity image: " + path);
+        }
+        cv::Mat disparity;
+        raw.convertTo(disparity, CV_32F, 1.0 / scale);
+        return disparity;
+    }
+
+    cv::Mat readPfm(const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return {};
+        }
+        std::string magic;
+        int width = 0, height = 0;
+        double scale = 0.0;
+        file >> magic >> width >> height >> scale;
+        file.get(); // the single whitespace byte ending the header
+        if (!file || width <= 0 || height <= 0) {
+            throw std::runtime_error("Malformed PFM header: " + path);
+        }
+        if (magic != "Pf") {
+            throw std::runtime_error("Only single-channel PFM files are supported: " + path);
+        }
+
+        // Rows are stored bottom to top; a negative scale means little-endian samples.
+        cv::Mat disparity(height, width, CV_32F);
+        const uint16_t probe = 1;
+        const bool hostLittleEndian = *reinterpret_cast<const uint8_t *>(&probe) == 1;
+        const bool swap = (scale < 0.0) != hostLittleEndian;
+        for (int y = height - 1; y >= 0; --y) {
+            auto *row = disparity.ptr<float>(y);
+            file.read(reinterpret_cast<char *>(row), static_cast<std::streamsize>(width * sizeof(float)));
+            if (swap) {
+                for (int x = 0; x < width; ++x) {
+                    uint32_t bits;
+                    std::memcpy(&bits, row + x, sizeof(bits));
+                    bits = (bits >> 24) | ((bits >> 8) & 0xff00u) | ((bits << 8) & 0xff0000u) | (bits << 24);
+                    std::memcpy(row + x, &bits, sizeof(bits));
+                }
+            }
+        }
+        if (!file) {
+            throw std::runtime_error("Truncated PFM file: " + path);
+        }
+        return disparity;
+    }
+
+    cv::Mat readDisparity(const std::string &path) {
+        if (fs::path(path).extension() == ".pfm") {
+            return readPfm(path);
+        }
+        return readScaledDisparity(path);
+    }
+
+    static cv::Mat readImage(const fs::path &path, bool grayscale) {
+        return cv::imread(path.string(), grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+    }
+
+    static cv::Mat firstDisparity(const std::vector<fs::path> &candidates) {
+        for (const auto &candidate : candidates) {
+            if (fs::exists(candidate)) {
+                return readDisparity(candidate.string());
+            }
+        }
+        return {};
+    }
+
+    static fs::path firstDirectory(const fs::path &root, std::initializer_list<const char *> names) {
+        for (const char *name : names) {
+            if (fs::is_directory(root / name)) {
+                return root / name;
+            }
+        }
+        return {};
+    }
+
+    static bool addSample(std::vector<StereoSample> &samples, StereoSample sample) {
+        if (sample.left.empty() || sample.right.empty()) {
+            std::cerr << "Warning: failed to decode " << sample.name << ", skipping." << std::endl;
+            return false;
+        }
+        if (!sample.groundTruth.empty() && sample.groundTruth.size() != sample.left.size()) {
+            std::cerr << "Warning: ground truth of " << sample.name << " does not match the image size, ignoring it."
+                      << std::endl;
+            sample.groundTruth.release();
+        }
+        samples.push_back(std::move(sample));
+        return true;
+    }
+
+    StereoDataset::Layout_ StereoDataset::detectLayout(const std::string &root) {
+        if (fs::is_directory(fs::path(root) / "left")) {
+            return Layout_::Directory;
+        }
+        if (!firstDirectory(root, {"image_2", "image_0"}).empty()) {
+            return Layout_::Kitti;
+        }
+        return Layout_::Middlebury;
+    }
+
+    StereoDataset StereoDataset::load(const std::string &root, Layout_ layout, bool grayscale) {
+        if (layout == Layout_::Auto) {
+            layout = detectLayout(root);
+        }
+        switch (layout) {
+            case Layout_::Directory: return loadDirectory(root, grayscale);
+            case Layout_::Middlebury: return loadMiddlebury(root, grayscale);
+            case Layout_::Kitti: return loadKitti(root, grayscale);
+            default: throw std::invalid_argument("Unknown dataset layout.");
+        }
+    }
+
+    StereoDataset StereoDataset::loadDirectory(const std::string &root, bool grayscale) {
+        const fs::path leftDir = fs::path(root) / "left";
+        const fs::path rightDir = fs::path(root) / "right";
+        const fs::path gtDir = fs::path(root) / "disparity";
+        if (!fs::is_directory(leftDir) || !fs::is_directory(rightDir)) {
+            throw std::invalid_argument("Dataset directory must contain 'left' and 'right' folders: " + root);
+        }
+
+        std::vector<StereoSample> samples;
+        for (const auto &entry : fs::directory_iterator(leftDir)) {
+            if (!entry.is_regular_file()) {
+                continue;
+            }
+            const fs::path &leftPath = entry.path();
+            const fs::path rightPath = rightDir / leftPath.filename();
+            if (!fs::exists(rightPath)) {
+                std::cerr << "Warning: no right image for " << leftPath << ", skipping." << std::endl;
+                continue;
+            }
+            StereoSample sample;
+            sample.name = leftPath.stem().string();
+            sample.left = readImage(leftPath, grayscale);
+            sample.right = readImage(rightPath, grayscale);
+            sample.groundTruth = firstDisparity({gtDir / (sample.name + ".pfm"), gtDir / (sample.name + ".png")});
+            addSample(samples, std::move(sample));
+        }
+        return StereoDataset(std::move(samples));
+    }
+
+    StereoDataset StereoDataset::loadMiddlebury(const std::string &root, bool grayscale) {
+        if (!fs::is_directory(root)) {
+            throw std::invalid_argument("Middlebury root is not a directory: " + root);
+        }
+        std::vector<StereoSample> samples;
+        for (const auto &entry : fs::directory_iterator(root)) {
+            const fs::path scene = entry.path();
+            if (!entry.is_directory() || !fs::exists(scene / "im0.png") || !fs::exists(scene / "im1.png")) {
+                continue;
+            }
+            StereoSample sample;
+            sample.name = scene.filename().string();
+            sample.left = readImage(scene / "im0.png", grayscale);
+            sample.right = readImage(scene / "im1.png", grayscale);
+            sample.groundTruth = firstDisparity({scene / "disp0GT.pfm", scene / "disp0.pfm"});
+            addSample(samples, std::move(sample));
+        }
+        return StereoDataset(std::move(samples));
+    }
+
+    StereoDataset StereoDataset::loadKitti(const std::string &root, bool grayscale) {
+        // KITTI 2015 stores colour pairs in image_2/3, KITTI 2012 grayscale pairs in image_0/1.
+        const fs::path leftDir = firstDirectory(root, {"image_2", "image_0"});
+        const fs::path rightDir = firstDirectory(root, {"image_3", "image_1"});
+        const fs::path gtDir = firstDirectory(root, {"disp_occ_0", "disp_noc_0", "disp_occ", "disp_noc"});
+        if (leftDir.empty() || rightDir.empty()) {
+            throw std::invalid_argument("KITTI root must contain image_2/image_3 or image_0/image_1: " + root);
+        }
+
+        std::vector<StereoSample> samples;
+        for (const auto &entry : fs::directory_iterator(leftDir)) {
+            const fs::path &leftPath = entry.path();
+            // Only the _10 frame of each pair has ground truth; _11 is the next frame for scene flow.
+            const std::string stem = leftPath.stem().string();
+            if (!entry.is_regular_file() || stem.size() < 3 || stem.compare(stem.size() - 3, 3, "_10") != 0) {
+                continue;
+            }
+            const fs::path rightPath = rightDir / leftPath.filename();
+            if (!fs::exists(rightPath)) {
+                continue;
+            }
+            StereoSample sample;
+            sample.name = stem;
+            sample.left = readImage(leftPath, grayscale);
+            sample.right = readImage(rightPath, grayscale);
+            if (!gtDir.empty()) {
+                sample.groundTruth = readScaledDisparity((gtDir / leftPath.filename()).string());
+            }
+            addSample(samples, std::move(sample));
+        }
+        return StereoDataset(std::move(samples));
+    }
+}
@@ -0,0 +1,171 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/evaluation/metrics.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <opencv2/core.hpp>
+
+using namespace vlue::disparity;
+
+namespace vlue::evaluation {
+    static void checkDisparity(const cv::Mat &disparity) {
+        if (disparity.empty() || disparity.type() != CV_16SC1) {
+            throw std::invalid_argument("Disparity metrics expect a non-empty CV_16SC1 disparity map.");
+        }
+    }
+
+    double disparityDensity(const cv::Mat &disparity, int minDisparity) {
+        checkDisparity(disparity);
+        std::atomic<long long> valid{0};
+        cv::parallel_for_(cv::Range(0, disparity.rows), [&](const cv::Range &range) {
+            long long count = 0;
+            for (int y = range.start; y < range.end; ++y) {
+                const auto *d = disparity.ptr<short>(y);
+                for (int x = 0; x < disparity.cols; ++x) {
+                    count += isValidDisparity(d[x], minDisparity);
+                }
+            }
+            valid += count;
+        });
+        return static_cast<double>(valid.load()) / static_cast<double>(disparity.total());
+    }
+
+    double leftRightConsistency(const cv::Mat &leftDisparity, const cv::Mat &rightDisparity, int minDisparity,
+                                int numDisparities, int threshold) {
+        checkDisparity(leftDisparity);
+        checkDisparity(rightDisparity);
+        if (leftDisparity.size() != rightDisparity.size()) {
+            throw std::invalid_argument("Left and right disparity maps must have the same size.");
+        }
+        if (numDisparities <= 0) {
+            throw std::invalid_argument("Number of disparities must be positive.");
+        }
+        const int cols = leftDisparity.cols;
+        const int limit = threshold * DISP_SCALE;
+        // The right matcher searches [1 - minDisparity - numDisparities, 1 - minDisparity); below that is unmatched.
+        const int rightMinDisparity = 1 - minDisparity - numDisparities;
+        std::atomic<long long> valid{0}, consistent{0};
+        cv::parallel_for_(cv::Range(0, leftDisparity.rows), [&](const cv::Range &range) {
+            long long v = 0, c = 0;
+            for (int y = range.start; y < range.end; ++y) {
+                const auto *d = leftDisparity.ptr<short>(y);
+                const auto *rd = rightDisparity.ptr<short>(y);
+                for (int x = 0; x < cols; ++x) {
+                    if (!isValidDisparity(d[x], minDisparity)) {
+                        continue;
+                    }
+                    ++v;
+                    const int xr = x - ((d[x] + DISP_SCALE / 2) >> DISP_SHIFT);
+                    c += xr >= 0 && xr < cols && isValidDisparity(rd[xr], rightMinDisparity) &&
+                         std::abs(d[x] + rd[xr]) <= limit;
+                }
+            }
+            valid += v;
+            consistent += c;
+        });
+        return valid.load() == 0 ? 0.0 : static_cast<double>(consistent.load()) / static_cast<double>(valid.load());
+    }
+
+    void groundTruthError(const cv::Mat &disparity, const cv::Mat &groundTruth, double badThreshold,
+                          double &badPixelRate, double &endPointError, int minDisparity) {
+        checkDisparity(disparity);
+        if (groundTruth.type() != CV_32FC1 || groundTruth.size() != disparity.size()) {
+            throw std::invalid_argument("Ground truth must be CV_32FC1 and the size of the disparity map.");
+        }
+        std::mutex mutex;
+        long long known = 0, bad = 0, matched = 0;
+        double errorSum = 0.0;
+        cv::parallel_for_(cv::Range(0, disparity.rows), [&](const cv::Range &range) {
+            long long k = 0, b = 0, m = 0;
+            double sum = 0.0;
+            for (int y = range.start; y < range.end; ++y) {
+                const auto *d = disparity.ptr<short>(y);
+                const auto *gt = groundTruth.ptr<float>(y);
+                for (int x = 0; x < disparity.cols; ++x) {
+                    if (!std::isfinite(gt[x]) || gt[x] <= 0.0f) {
+                        continue;
+                    }
+                    ++k;
+                    if (!isValidDisparity(d[x], minDisparity)) {
+                        ++b;
+                        continue;
+                    }
+                    const double error = std::abs(d[x] / static_cast<double>(DISP_SCALE) - gt[x]);
+                    b += error > badThreshold;
+                    sum += error;
+                    ++m;
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            known += k;
+            bad += b;
+            matched += m;
+            errorSum += sum;
+        });
+        badPixelRate = known == 0 ? 0.0 : static_cast<double>(bad) / static_cast<double>(known);
+        endPointError = matched == 0 ? 0.0 : errorSum / static_cast<double>(matched);
+    }
+
+    std::vector<double> badPixelRates(const cv::Mat &disparity, const cv::Mat &groundTruth,
+                                      const std::vector<double> &thresholds, int minDisparity) {
+        checkDisparity(disparity);
+        if (groundTruth.type() != CV_32FC1 || groundTruth.size() != disparity.size()) {
+            throw std::invalid_argument("Ground truth must be CV_32FC1 and the size of the disparity map.");
+        }
+        const std::size_t n = thresholds.size();
+        std::mutex mutex;
+        long long known = 0;
+        std::vector<long long> bad(n, 0);
+        cv::parallel_for_(cv::Range(0, disparity.rows), [&](const cv::Range &range) {
+            long long k = 0;
+            std::vector<long long> b(n, 0);
+            for (int y = range.start; y < range.end; ++y) {
+                const auto *d = disparity.ptr<short>(y);
+                const auto *gt = groundTruth.ptr<float>(y);
+                for (int x = 0; x < disparity.cols; ++x) {
+                    if (!std::isfinite(gt[x]) || gt[x] <= 0.0f) {
+                        continue;
+                    }
+                    ++k;
+                    const bool valid = isValidDisparity(d[x], minDisparity);
+                    const double error = valid ? std::abs(d[x] / static_cast<double>(DISP_SCALE) - gt[x]) : 0.0;
+                    for (std::size_t i = 0; i < n; ++i) {
+                        b[i] += !valid || error > thresholds[i];
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            known += k;
+            for (std::size_t i = 0; i < n; ++i) {
+                bad[i] += b[i];
+            }
+        });
+        std::vector<double> rates(n, 0.0);
+        for (std::size_t i = 0; i < n && known > 0; ++i) {
+            rates[i] = static_cast<double>(bad[i]) / static_cast<double>(known);
+        }
+        return rates;
+    }
+
+    DisparityMetrics evaluateDisparity(const cv::Mat &leftDisparity, const cv::Mat &rightDisparity,
+                                       const cv::Mat &groundTruth, int minDisparity, int numDisparities,
+                                       double badThreshold) {
+        DisparityMetrics metrics;
+        metrics.density = disparityDensity(leftDisparity, minDisparity);
+        if (!rightDisparity.empty()) {
+            metrics.lrConsistency = leftRightConsistency(leftDisparity, rightDisparity, minDisparity, numDisparities);
+        }
+        if (!groundTruth.empty()) {
+            metrics.hasGroundTruth = true;
+            groundTruthError(leftDisparity, groundTruth, badThreshold, metrics.badPixelRate, metrics.endPointError,
+                             minDisparity);
+        }
+        return metrics;
+    }
+}
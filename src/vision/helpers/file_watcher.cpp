@@ -0,0 +1,58 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/helpers/file_watcher.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace vlue::utils {
+    static std::filesystem::file_time_type lastWriteTime(const std::string &path) {
+        std::error_code ec;
+        auto time = std::filesystem::last_write_time(path, ec);
+        return ec ? std::filesystem::file_time_type::min() : time;
+    }
+
+    FileWatcher::FileWatcher(std::string path, Callback callback, std::chrono::milliseconds interval)
+        : m_Path(std::move(path)), m_Callback(std::move(callback)), m_Interval(interval) {
+        if (!m_Callback) {
+            throw std::invalid_argument("FileWatcher requires a callback.");
+        }
+        m_LastWrite = lastWriteTime(m_Path);
+        m_Thread = std::thread(&FileWatcher::run_, this);
+    }
+
+    FileWatcher::~FileWatcher() {
+        stop();
+    }
+
+    void FileWatcher::stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_Cv.notify_all();
+        if (m_Thread.joinable()) {
+            m_Thread.join();
+        }
+    }
+
+    void FileWatcher::run_() {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        while (!m_Cv.wait_for(lock, m_Interval, [this] { return m_Stop; })) {
+            const auto current = lastWriteTime(m_Path);
+            if (current == m_LastWrite || current == std::filesystem::file_time_type::min()) {
+                continue;
+            }
+            m_LastWrite = current;
+            lock.unlock();
+            try {
+                m_Callback(m_Path);
+            } catch (const std::exception &e) {
+                std::cerr << "Error: reloading " << m_Path << " failed: " << e.what() << std::endl;
+            }
+            lock.lock();
+        }
+    }
+}
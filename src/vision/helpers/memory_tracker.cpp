@@ -0,0 +1,276 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/helpers/memory_tracker.h"
+#include "vision/helpers/type_name.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <typeindex>
+#include <unordered_map>
+#include <opencv2/core.hpp>
+
+namespace vlue::utils {
+    struct MemoryTracker::Region {
+        std::string name;
+        std::atomic<int64_t> current{0};
+        std::atomic<int64_t> peak{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> deallocations{0};
+        // Scopes currently open on this region, across threads.
+        std::atomic<int> open{0};
+
+        explicit Region(std::string name) : name(std::move(name)) {}
+
+        void charge(int64_t bytes) {
+            const int64_t now = current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            int64_t high = peak.load(std::memory_order_relaxed);
+            while (now > high && !peak.compare_exchange_weak(high, now, std::memory_order_relaxed)) {}
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void credit(int64_t bytes) {
+            current.fetch_sub(bytes, std::memory_order_relaxed);
+            deallocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] MemoryStats stats() const {
+            return {name, current.load(), peak.load(), allocations.load(), deallocations.load()};
+        }
+    };
+
+    namespace {
+        std::atomic<bool> trackingEnabled{false};
+        thread_local MemoryTracker::Region *threadRegion = nullptr;
+        // Region of the newest open scope on any thread.
+        std::atomic<MemoryTracker::Region *> fallbackRegion{nullptr};
+
+        // Wraps OpenCV's standard allocator; the region is kept in UMatData::userdata, which it leaves unused.
+        class TrackingAllocator final : public cv::MatAllocator {
+        public:
+            const cv::MatAllocator *inner{nullptr};
+            MemoryTracker::Region *unscoped{nullptr};
+
+            cv::UMatData *allocate(int dims, const int *sizes, int type, void *data, size_t *step,
+                                   cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+                cv::UMatData *u = inner->allocate(dims, sizes, type, data, step, flags, usageFlags);
+                if (u == nullptr) {
+                    return u;
+                }
+                // Route the release back through us.
+                u->prevAllocator = u->currAllocator = this;
+                if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+                    MemoryTracker::Region *region = threadRegion;
+                    if (region == nullptr) region = fallbackRegion.load(std::memory_order_relaxed);
+                    if (region == nullptr) region = unscoped;
+                    region->charge(static_cast<int64_t>(u->size));
+                    u->userdata = region;
+                }
+                return u;
+            }
+
+            bool allocate(cv::UMatData *data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override {
+                return inner->allocate(data, accessFlags, usageFlags);
+            }
+
+            void deallocate(cv::UMatData *u) const override {
+                if (u == nullptr) {
+                    return;
+                }
+                if (auto *region = static_cast<MemoryTracker::Region *>(u->userdata)) {
+                    region->credit(static_cast<int64_t>(u->size));
+                    u->userdata = nullptr;
+                }
+                inner->deallocate(u);
+            }
+        };
+    }
+
+    struct MemoryTracker::Impl {
+        mutable std::mutex mutex;
+        std::map<std::string, std::unique_ptr<Region>> regions;
+        std::unordered_map<std::type_index, Region *> typeRegions;
+        TrackingAllocator allocator;
+        cv::MatAllocator *previous{nullptr};
+
+        std::mutex dumpMutex;
+        std::condition_variable dumpCv;
+        bool dumpStop{false};
+        std::thread dumpThread;
+
+        Region *region(const std::string &name) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto &slot = regions[name];
+            if (!slot) {
+                slot = std::make_unique<Region>(name);
+            }
+            return slot.get();
+        }
+    };
+
+    MemoryTracker::MemoryTracker() : m_Impl(std::make_unique<Impl>()) {
+        m_Impl->allocator.unscoped = m_Impl->region("unscoped");
+    }
+
+    MemoryTracker::~MemoryTracker() {
+        stopPeriodicDump();
+    }
+
+    MemoryTracker &MemoryTracker::instance() {
+        static auto *tracker = new MemoryTracker();
+        return *tracker;
+    }
+
+    void MemoryTracker::install() {
+        std::lock_guard<std::mutex> lock(m_Impl->mutex);
+        if (trackingEnabled) {
+            return;
+        }
+        m_Impl->allocator.inner = cv::Mat::getStdAllocator();
+        m_Impl->previous = cv::Mat::getDefaultAllocator();
+        cv::Mat::setDefaultAllocator(&m_Impl->allocator);
+        trackingEnabled = true;
+    }
+
+    void MemoryTracker::uninstall() {
+        std::lock_guard<std::mutex> lock(m_Impl->mutex);
+        if (!trackingEnabled) {
+            return;
+        }
+        cv::Mat::setDefaultAllocator(m_Impl->previous);
+        trackingEnabled = false;
+    }
+
+    bool MemoryTracker::isInstalled() const {
+        return trackingEnabled;
+    }
+
+    MemoryTracker::Region *MemoryTracker::region(const std::string &name) {
+        return m_Impl->region(name);
+    }
+
+    MemoryTracker::Region *MemoryTracker::region(const std::type_info &type) {
+        {
+            std::lock_guard<std::mutex> lock(m_Impl->mutex);
+            const auto it = m_Impl->typeRegions.find(std::type_index(type));
+            if (it != m_Impl->typeRegions.end()) {
+                return it->second;
+            }
+        }
+        Region *named = m_Impl->region(shortTypeName(type));
+        std::lock_guard<std::mutex> lock(m_Impl->mutex);
+        m_Impl->typeRegions.emplace(std::type_index(type), named);
+        return named;
+    }
+
+    std::vector<MemoryStats> MemoryTracker::snapshot() const {
+        std::lock_guard<std::mutex> lock(m_Impl->mutex);
+        std::vector<MemoryStats> stats;
+        stats.reserve(m_Impl->regions.size());
+        for (const auto &[name, region] : m_Impl->regions) {
+            stats.push_back(region->stats());
+        }
+        return stats;
+    }
+
+    MemoryStats MemoryTracker::stats(const std::string &name) const {
+        std::lock_guard<std::mutex> lock(m_Impl->mutex);
+        const auto it = m_Impl->regions.find(name);
+        if (it == m_Impl->regions.end()) {
+            MemoryStats empty;
+            empty.region = name;
+            return empty;
+        }
+        return it->second->stats();
+    }
+
+    void MemoryTracker::resetPeaks() {
+        std::lock_guard<std::mutex> lock(m_Impl->mutex);
+        for (auto &[name, region] : m_Impl->regions) {
+            region->peak.store(region->current.load());
+        }
+    }
+
+    void MemoryTracker::dump(std::ostream &os) const {
+        auto stats = snapshot();
+        std::sort(stats.begin(), stats.end(), [](const MemoryStats &a, const MemoryStats &b) {
+            return a.peakBytes > b.peakBytes;
+        });
+        constexpr double MiB = 1024.0 * 1024.0;
+        os << "Info: cv::Mat memory by region (MiB current / peak, allocations):\n";
+        for (const auto &s : stats) {
+            if (s.allocations == 0) {
+                continue;
+            }
+            os << "  " << std::left << std::setw(32) << s.region << std::right << std::fixed << std::setprecision(2)
+               << std::setw(10) << double(s.currentBytes) / MiB << " / " << std::setw(10)
+               << double(s.peakBytes) / MiB << ", " << s.allocations << "\n";
+        }
+        os.flush();
+    }
+
+    void MemoryTracker::startPeriodicDump(std::chrono::milliseconds interval, std::ostream &os) {
+        stopPeriodicDump();
+        m_Impl->dumpStop = false;
+        m_Impl->dumpThread = std::thread([this, interval, &os] {
+            std::unique_lock<std::mutex> lock(m_Impl->dumpMutex);
+            while (!m_Impl->dumpCv.wait_for(lock, interval, [this] { return m_Impl->dumpStop; })) {
+                dump(os);
+            }
+        });
+    }
+
+    void MemoryTracker::stopPeriodicDump() {
+        {
+            std::lock_guard<std::mutex> lock(m_Impl->dumpMutex);
+            m_Impl->dumpStop = true;
+        }
+        m_Impl->dumpCv.notify_all();
+        if (m_Impl->dumpThread.joinable()) {
+            m_Impl->dumpThread.join();
+        }
+    }
+
+    ScopedMemoryRegion::ScopedMemoryRegion(MemoryTracker::Region *region) {
+        if (trackingEnabled.load(std::memory_order_relaxed)) {
+            enter_(region);
+        }
+    }
+
+    ScopedMemoryRegion::ScopedMemoryRegion(const char *name) {
+        if (trackingEnabled.load(std::memory_order_relaxed)) {
+            enter_(MemoryTracker::instance().region(name));
+        }
+    }
+
+    void ScopedMemoryRegion::enter_(MemoryTracker::Region *region) {
+        m_Region = region;
+        m_Previous = threadRegion;
+        threadRegion = region;
+        region->open.fetch_add(1, std::memory_order_relaxed);
+        m_PreviousFallback = fallbackRegion.exchange(region, std::memory_order_relaxed);
+    }
+
+    ScopedMemoryRegion::~ScopedMemoryRegion() {
+        if (m_Region == nullptr) {
+            return;
+        }
+        threadRegion = m_Previous;
+        if (m_Region->open.fetch_sub(1, std::memory_order_relaxed) > 1) {
+            return; // still open in another scope, so still a fine fallback
+        }
+        // Scopes on different threads close in any order. Only the newest one hands the fallback back, to the
+        // region it replaced if that is still open; a newer scope that opened meanwhile keeps its own.
+        MemoryTracker::Region *expected = m_Region;
+        MemoryTracker::Region *restore = m_PreviousFallback;
+        if (restore != nullptr && restore->open.load(std::memory_order_relaxed) == 0) {
+            restore = nullptr;
+        }
+        fallbackRegion.compare_exchange_strong(expected, restore, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,237 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/helpers/thread_affinity.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace vlue::utils {
+    namespace {
+        std::mutex registryMutex;
+        std::vector<ThreadPlacement> registry;
+
+        void appendError(std::string &errors, const std::string &error) {
+            errors += errors.empty() ? error : "; " + error;
+        }
+
+#if defined(__linux__)
+        // MPOL_PREFERRED_MANY needs Linux 5.15; MPOL_PREFERRED with the first node is the fallback.
+        constexpr int MPOL_PREFERRED_ = 1;
+        constexpr int MPOL_PREFERRED_MANY_ = 5;
+
+        bool preferNodes(const std::vector<int> &nodes, std::string &error) {
+            if (nodes.empty()) {
+                error = "NUMA topology unavailable";
+                return false;
+            }
+            constexpr int maxNode = 1024;
+            unsigned long mask[maxNode / (8 * sizeof(unsigned long))] = {};
+            for (const int node : nodes) {
+                if (node >= 0 && node < maxNode) {
+                    mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+                }
+            }
+            if (syscall(SYS_set_mempolicy, MPOL_PREFERRED_MANY_, mask, maxNode + 1) == 0) {
+                return true;
+            }
+            unsigned long first[maxNode / (8 * sizeof(unsigned long))] = {};
+            first[nodes.front() / (8 * sizeof(unsigned long))] = 1UL << (nodes.front() % (8 * sizeof(unsigned long)));
+            if (syscall(SYS_set_mempolicy, MPOL_PREFERRED_, first, maxNode + 1) == 0) {
+                return true;
+            }
+            error = std::string("set_mempolicy failed: ") + std::strerror(errno);
+            return false;
+        }
+#endif
+    }
+
+    std::vector<int> parseCpuList(const std::string &list) {
+        std::vector<int> cpus;
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            item.erase(std::remove_if(item.begin(), item.end(), [](unsigned char c) { return std::isspace(c); }),
+                       item.end());
+            if (item.empty()) {
+                continue;
+            }
+            try {
+                std::size_t used = 0;
+                const auto dash = item.find('-');
+                const int first = std::stoi(item.substr(0, dash), &used);
+                if (used != (dash == std::string::npos ? item.size() : dash)) {
+                    throw std::invalid_argument(item);
+                }
+                int last = first;
+                if (dash != std::string::npos) {
+                    last = std::stoi(item.substr(dash + 1), &used);
+                    if (used != item.size() - dash - 1) {
+                        throw std::invalid_argument(item);
+                    }
+                }
+                if (first < 0 || last < first) {
+                    throw std::invalid_argument(item);
+                }
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            } catch (const std::logic_error &) {
+                throw std::invalid_argument("Malformed CPU list '" + list + "'");
+            }
+        }
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+        return cpus;
+    }
+
+    std::string formatCpuList(const std::vector<int> &cpus) {
+        std::string list;
+        for (std::size_t i = 0; i < cpus.size();) {
+            std::size_t j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+                ++j;
+            }
+            if (!list.empty()) list += ",";
+            list += std::to_string(cpus[i]);
+            if (j > i) list += "-" + std::to_string(cpus[j]);
+            i = j + 1;
+        }
+        return list;
+    }
+
+    std::vector<int> currentThreadAffinity() {
+        std::vector<int> cpus;
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+            }
+        }
+#else
+        for (unsigned cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu) cpus.push_back(int(cpu));
+#endif
+        return cpus;
+    }
+
+    int numaNodeOfCpu(int cpu) {
+#if defined(__linux__)
+        const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        if (DIR *dir = opendir(path.c_str())) {
+            int node = -1;
+            while (const dirent *entry = readdir(dir)) {
+                if (std::strncmp(entry->d_name, "node", 4) == 0 && std::isdigit(static_cast<unsigned char>(entry->d_name[4]))) {
+                    node = std::atoi(entry->d_name + 4);
+                    break;
+                }
+            }
+            closedir(dir);
+            return node;
+        }
+#else
+        (void) cpu;
+#endif
+        return -1;
+    }
+
+    ThreadPlacement placeCurrentThread(const std::string &role, const std::vector<int> &cpus, int priority,
+                                       bool numaLocal) {
+        ThreadPlacement placement;
+        placement.role = role;
+        placement.requestedCpus = cpus;
+#if defined(__linux__)
+        if (!cpus.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (const int cpu : cpus) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+            }
+            if (const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); rc != 0) {
+                appendError(placement.error, std::string("affinity: ") + std::strerror(rc));
+            }
+        }
+        if (priority > 0) {
+            sched_param param{};
+            param.sched_priority = std::clamp(priority, sched_get_priority_min(SCHED_FIFO),
+                                              sched_get_priority_max(SCHED_FIFO));
+            if (const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param); rc != 0) {
+                appendError(placement.error, std::string("SCHED_FIFO: ") + std::strerror(rc));
+            } else {
+                placement.priority = param.sched_priority;
+            }
+        }
+#else
+        if (!cpus.empty() || priority > 0) {
+            appendError(placement.error, "thread placement is not supported on this platform");
+        }
+#endif
+        placement.cpus = currentThreadAffinity();
+        for (const int cpu : placement.cpus) {
+            const int node = numaNodeOfCpu(cpu);
+            if (node >= 0 && std::find(placement.numaNodes.begin(), placement.numaNodes.end(), node) ==
+                             placement.numaNodes.end()) {
+                placement.numaNodes.push_back(node);
+            }
+        }
+        std::sort(placement.numaNodes.begin(), placement.numaNodes.end());
+        if (numaLocal) {
+#if defined(__linux__)
+            std::string error;
+            placement.numaLocal = preferNodes(placement.numaNodes, error);
+            if (!placement.numaLocal) {
+                appendError(placement.error, "NUMA: " + error);
+            }
+#else
+            appendError(placement.error, "NUMA placement is not supported on this platform");
+#endif
+        }
+        if (!placement.error.empty()) {
+            std::cerr << "Warning: Placement of " << role << " thread incomplete (" << placement.error << ")."
+                      << std::endl;
+        }
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(placement);
+        return placement;
+    }
+
+    std::vector<ThreadPlacement> placementReport() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        return registry;
+    }
+
+    void printPlacementReport(std::ostream &os) {
+        const auto placements = placementReport();
+        os << "Info: Thread placement (" << placements.size() << " threads):\n";
+        for (const auto &placement : placements) {
+            os << "  " << placement.role << ": cpus " << formatCpuList(placement.cpus);
+            if (!placement.numaNodes.empty()) {
+                os << ", numa " << formatCpuList(placement.numaNodes) << (placement.numaLocal ? " (local alloc)" : "");
+            }
+            os << ", " << (placement.priority > 0 ? "SCHED_FIFO " + std::to_string(placement.priority) : "SCHED_OTHER");
+            if (!placement.error.empty()) {
+                os << ", failed: " << placement.error;
+            }
+            os << "\n";
+        }
+        os.flush();
+    }
+}
@@ -0,0 +1,56 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/helpers/thread_pool.h"
+
+#include <algorithm>
+
+namespace vlue::utils {
+    ThreadPool::ThreadPool(unsigned threads, std::function<void(unsigned)> onStart) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        m_Workers.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            m_Workers.emplace_back(&ThreadPool::run_, this, i, onStart);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_Cv.notify_all();
+        for (auto &worker : m_Workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Tasks.push_back(std::move(task));
+        }
+        m_Cv.notify_one();
+    }
+
+    void ThreadPool::run_(unsigned index, const std::function<void(unsigned)> &onStart) {
+        if (onStart) {
+            onStart(index);
+        }
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Cv.wait(lock, [this] { return m_Stop || !m_Tasks.empty(); });
+                if (m_Tasks.empty()) {
+                    return;
+                }
+                task = std::move(m_Tasks.front());
+                m_Tasks.pop_front();
+            }
+            task();
+        }
+    }
+}
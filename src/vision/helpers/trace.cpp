@@ -0,0 +1,236 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/helpers/trace.h"
+#include "vision/helpers/type_name.h"
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace vlue::utils {
+    namespace {
+        struct Event {
+            const char *name;
+            const char *category;
+            int64_t begin;
+            int64_t end;
+            uint64_t frame;
+        };
+
+        constexpr std::size_t CHUNK_EVENTS = 4096;
+
+        // Entries below `count` are immutable once published; only the owning thread appends.
+        struct Chunk {
+            Event events[CHUNK_EVENTS];
+            std::atomic<std::size_t> count{0};
+            std::atomic<Chunk *> next{nullptr};
+        };
+
+        struct ThreadBuffer {
+            uint64_t tid{0};
+            std::string name;  // guarded by Registry::mutex
+            Chunk head;
+            Chunk *tail{&head};  // owner only
+
+            ~ThreadBuffer() {
+                for (Chunk *chunk = head.next.load(); chunk != nullptr;) {
+                    Chunk *next = chunk->next.load();
+                    delete chunk;
+                    chunk = next;
+                }
+            }
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            uint64_t nextTid{1};
+            std::set<std::string> names;
+            std::unordered_map<std::type_index, const char *> typeNames;
+            std::atomic<int64_t> origin{0};
+        };
+
+        // Leaked so threads exiting during static destruction can still drop their buffers.
+        Registry &registry() {
+            static auto *instance = new Registry();
+            return *instance;
+        }
+
+        std::shared_ptr<ThreadBuffer> registerThread() {
+            auto buffer = std::make_shared<ThreadBuffer>();
+            auto &reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            buffer->tid = reg.nextTid++;
+            buffer->name = "thread-" + std::to_string(buffer->tid);
+            reg.buffers.push_back(buffer);
+            return buffer;
+        }
+
+        // Registered on first use, so threads that never trace cost nothing.
+        ThreadBuffer &threadBuffer() {
+            thread_local std::shared_ptr<ThreadBuffer> buffer = registerThread();
+            return *buffer;
+        }
+
+        void writeEscaped(std::ostream &os, const std::string &text) {
+            os << '"';
+            for (const char c : text) {
+                if (c == '"' || c == '\\') {
+                    os << '\\' << c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    os << ' ';
+                } else {
+                    os << c;
+                }
+            }
+            os << '"';
+        }
+
+        // Microseconds with nanosecond digits, without going through floating point.
+        void writeMicros(std::ostream &os, int64_t ns) {
+            if (ns < 0) {
+                os << '-';
+                ns = -ns;
+            }
+            const int64_t fraction = ns % 1000;
+            os << ns / 1000 << '.' << (fraction < 100 ? fraction < 10 ? "00" : "0" : "") << fraction;
+        }
+    }
+
+    void Tracer::start() {
+        int64_t unset = 0;
+        registry().origin.compare_exchange_strong(unset, now());
+        s_Enabled.store(true, std::memory_order_relaxed);
+    }
+
+    void Tracer::stop() {
+        s_Enabled.store(false, std::memory_order_relaxed);
+    }
+
+    void Tracer::clear() {
+        auto &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto &buffer : reg.buffers) {
+            for (Chunk *chunk = buffer->head.next.exchange(nullptr); chunk != nullptr;) {
+                Chunk *next = chunk->next.load();
+                delete chunk;
+                chunk = next;
+            }
+            buffer->head.count.store(0);
+            buffer->tail = &buffer->head;
+        }
+        reg.origin.store(isEnabled() ? now() : 0);
+    }
+
+    void Tracer::setThreadName(const std::string &name) {
+        ThreadBuffer &buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        buffer.name = name;
+    }
+
+    int64_t Tracer::now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void Tracer::record(const char *name, const char *category, int64_t begin, int64_t end, uint64_t frame) {
+        ThreadBuffer &buffer = threadBuffer();
+        Chunk *chunk = buffer.tail;
+        std::size_t count = chunk->count.load(std::memory_order_relaxed);
+        if (count == CHUNK_EVENTS) {
+            auto *next = new Chunk();
+            chunk->next.store(next, std::memory_order_release);
+            buffer.tail = chunk = next;
+            count = 0;
+        }
+        chunk->events[count] = Event{name, category, begin, end, frame};
+        chunk->count.store(count + 1, std::memory_order_release);
+    }
+
+    const char *Tracer::intern(const std::type_info &type) {
+        auto &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        const auto it = reg.typeNames.find(std::type_index(type));
+        if (it != reg.typeNames.end()) {
+            return it->second;
+        }
+        const char *name = reg.names.insert(shortTypeName(type)).first->c_str();
+        reg.typeNames.emplace(std::type_index(type), name);
+        return name;
+    }
+
+    std::size_t Tracer::spanCount() {
+        auto &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        std::size_t total = 0;
+        for (const auto &buffer : reg.buffers) {
+            for (const Chunk *chunk = &buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire)) {
+                total += chunk->count.load(std::memory_order_acquire);
+            }
+        }
+        return total;
+    }
+
+    void Tracer::writeChromeTrace(std::ostream &os) {
+#if defined(__unix__) || defined(__APPLE__)
+        const long pid = static_cast<long>(getpid());
+#else
+        const long pid = 1;
+#endif
+        auto &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        const int64_t origin = reg.origin.load();
+
+        os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        const auto separator = [&] {
+            os << (first ? "\n" : ",\n");
+            first = false;
+        };
+        for (const auto &buffer : reg.buffers) {
+            separator();
+            os << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+               << ",\"args\":{\"name\":";
+            writeEscaped(os, buffer->name);
+            os << "}}";
+            for (const Chunk *chunk = &buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire)) {
+                const std::size_t count = chunk->count.load(std::memory_order_acquire);
+                for (std::size_t i = 0; i < count; ++i) {
+                    const Event &event = chunk->events[i];
+                    separator();
+                    os << "{\"ph\":\"X\",\"name\":";
+                    writeEscaped(os, event.name);
+                    os << ",\"cat\":";
+                    writeEscaped(os, event.category);
+                    os << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid << ",\"ts\":";
+                    writeMicros(os, event.begin - origin);
+                    os << ",\"dur\":";
+                    writeMicros(os, event.end - event.begin);
+                    if (event.frame != NO_FRAME) {
+                        os << ",\"args\":{\"frame\":" << event.frame << "}";
+                    }
+                    os << "}";
+                }
+            }
+        }
+        os << "\n]}\n";
+    }
+
+    bool Tracer::writeChromeTrace(const std::string &path) {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+        writeChromeTrace(file);
+        return static_cast<bool>(file);
+    }
+}
@@ -1,5 +1,4 @@
 #include "vision/helpers/yaml.h"
-#include "vision/exceptions/exceptions.h"
 #include <opencv2/core/mat.hpp>
 #include <stdexcept>
 
@@ -7,11 +6,11 @@ namespace vlue::utils {
     YAML::Node YAMLUtils::loadYamlConfig(const std::string &yaml_path) {
         YAML::Node config;
         try {
-            config = YAML::Node(yaml_path);
-        } catch ([[maybe_unused]] const exceptions::BadFile &e) {
+            config = YAML::LoadFile(yaml_path);
+        } catch ([[maybe_unused]] const YAML::BadFile &e) {
             throw std::runtime_error("Failed to open YAML configuration file: " + yaml_path);
         }
-        catch (const exceptions::ParserException &e) {
+        catch (const YAML::ParserException &e) {
             throw std::runtime_error("Failed to parse YAML file: " + yaml_path + "\n" + e.what());
         }
         return config;
@@ -0,0 +1,178 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/guided_filter.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+using namespace vlue::disparity;
+
+namespace vlue::processing {
+    // Minimum fraction of valid pixels in a window for its coefficients to be trusted.
+    static constexpr float MIN_SUPPORT = 1e-3f;
+
+    static cv::Mat normalisedGuide(const cv::Mat &view) {
+        cv::Mat gray, guide;
+        if (view.channels() == 3) {
+            cv::cvtColor(view, gray, cv::COLOR_BGR2GRAY);
+        } else if (view.channels() == 4) {
+            cv::cvtColor(view, gray, cv::COLOR_BGRA2GRAY);
+        } else {
+            gray = view;
+        }
+        const double scale = gray.depth() == CV_8U ? 1.0 / 255.0 : gray.depth() == CV_16U ? 1.0 / 65535.0 : 1.0;
+        gray.convertTo(guide, CV_32F, scale);
+        return guide;
+    }
+
+    DisparityFastGuidedFilterPipeline::DisparityFastGuidedFilterPipeline(int radius, double eps, int subsample,
+                                                                         int minDisparity, bool fillHoles, bool enable)
+        : m_MinDisparity(minDisparity), m_FillHoles(fillHoles) {
+        setRadius(radius);
+        setEps(eps);
+        setSubsample(subsample);
+        m_Enabled = enable;
+    }
+
+    void DisparityFastGuidedFilterPipeline::setRadius(int radius) {
+        if (radius < 1) {
+            throw std::invalid_argument("Guided filter radius must be positive.");
+        }
+        m_Radius = radius;
+    }
+
+    void DisparityFastGuidedFilterPipeline::setEps(double eps) {
+        if (eps <= 0.0) {
+            throw std::invalid_argument("Guided filter eps must be positive.");
+        }
+        m_Eps = eps;
+    }
+
+    void DisparityFastGuidedFilterPipeline::setSubsample(int subsample) {
+        if (subsample < 1) {
+            throw std::invalid_argument("Guided filter subsample factor must be at least 1.");
+        }
+        m_Subsample = subsample;
+    }
+
+    cv::Mat DisparityFastGuidedFilterPipeline::filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+        const cv::Mat &rightDisparity, const cv::Mat &rightView) const {
+        return apply(leftDisparity, leftView, rightDisparity, rightView);
+    }
+
+    cv::Mat DisparityFastGuidedFilterPipeline::apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                                       [[maybe_unused]] const cv::Mat &rightDisparity,
+                                                       [[maybe_unused]] const cv::Mat &rightView) const {
+        if (leftDisparity.type() != CV_16SC1) {
+            throw std::invalid_argument("Guided filter expects a CV_16SC1 disparity map.");
+        }
+        if (leftDisparity.size() != leftView.size()) {
+            throw std::invalid_argument("Disparity map and guide image must have the same size.");
+        }
+
+        const short invalid = invalidDisparity(m_MinDisparity);
+        const cv::Size fullSize = leftDisparity.size();
+        const cv::Mat guide = normalisedGuide(leftView);
+
+        // Masked input: p * m and m, so every window mean below is a weighted mean over valid pixels only.
+        cv::Mat validMask = leftDisparity >= m_MinDisparity * DISP_SCALE;
+        cv::Mat weight, weightedDisparity;
+        validMask.convertTo(weight, CV_32F, 1.0 / 255.0);
+        leftDisparity.convertTo(weightedDisparity, CV_32F);
+        weightedDisparity = weightedDisparity.mul(weight);
+
+        const int s = m_Subsample;
+        const cv::Size smallSize((fullSize.width + s - 1) / s, (fullSize.height + s - 1) / s);
+        cv::Mat I, p, m;
+        if (s > 1) {
+            cv::resize(guide, I, smallSize, 0, 0, cv::INTER_AREA);
+            cv::resize(weightedDisparity, p, smallSize, 0, 0, cv::INTER_AREA);
+            cv::resize(weight, m, smallSize, 0, 0, cv::INTER_AREA);
+        } else {
+            I = guide;
+            p = weightedDisparity;
+            m = weight;
+        }
+
+        const int r = std::max(1, m_Radius / s);
+        const cv::Size window(2 * r + 1, 2 * r + 1);
+        auto box = [&window](const cv::Mat &src) {
+            cv::Mat dst;
+            cv::boxFilter(src, dst, CV_32F, window, cv::Point(-1, -1), true, cv::BORDER_REFLECT);
+            return dst;
+        };
+
+        const cv::Mat Im = I.mul(m);
+        const cv::Mat meanM = box(m);
+        const cv::Mat meanI = box(Im);
+        const cv::Mat meanP = box(p);
+        const cv::Mat meanIp = box(I.mul(p));
+        const cv::Mat meanII = box(I.mul(Im));
+
+        // Per-window linear model q = a * I + b, weighted by support so empty windows do not contribute.
+        cv::Mat aw(smallSize, CV_32F), bw(smallSize, CV_32F), w(smallSize, CV_32F);
+        const auto eps = static_cast<float>(m_Eps);
+        cv::parallel_for_(cv::Range(0, smallSize.height), [&](const cv::Range &range) {
+            for (int y = range.start; y < range.end; ++y) {
+                const auto *pm = meanM.ptr<float>(y);
+                const auto *pi = meanI.ptr<float>(y);
+                const auto *pp = meanP.ptr<float>(y);
+                const auto *pip = meanIp.ptr<float>(y);
+                const auto *pii = meanII.ptr<float>(y);
+                auto *pa = aw.ptr<float>(y);
+                auto *pb = bw.ptr<float>(y);
+                auto *pw = w.ptr<float>(y);
+                for (int x = 0; x < smallSize.width; ++x) {
+                    const float support = pm[x];
+                    const float valid = support > MIN_SUPPORT ? 1.0f : 0.0f;
+                    const float inv = valid / std::max(support, MIN_SUPPORT);
+                    const float muI = pi[x] * inv;
+                    const float muP = pp[x] * inv;
+                    const float cov = pip[x] * inv - muI * muP;
+                    const float var = pii[x] * inv - muI * muI;
+                    const float a = cov / (var + eps);
+                    pa[x] = a * valid;
+                    pb[x] = (muP - a * muI) * valid;
+                    pw[x] = valid;
+                }
+            }
+        });
+
+        cv::Mat meanA = box(aw), meanB = box(bw), meanW = box(w);
+        if (s > 1) {
+            cv::resize(meanA, meanA, fullSize, 0, 0, cv::INTER_LINEAR);
+            cv::resize(meanB, meanB, fullSize, 0, 0, cv::INTER_LINEAR);
+            cv::resize(meanW, meanW, fullSize, 0, 0, cv::INTER_LINEAR);
+        }
+
+        cv::Mat filteredDisparityMap(fullSize, CV_16SC1);
+        const bool fillHoles = m_FillHoles;
+        cv::parallel_for_(cv::Range(0, fullSize.height), [&](const cv::Range &range) {
+            for (int y = range.start; y < range.end; ++y) {
+                const auto *src = leftDisparity.ptr<short>(y);
+                const auto *g = guide.ptr<float>(y);
+                const auto *pa = meanA.ptr<float>(y);
+                const auto *pb = meanB.ptr<float>(y);
+                const auto *pw = meanW.ptr<float>(y);
+                auto *dst = filteredDisparityMap.ptr<short>(y);
+                for (int x = 0; x < fullSize.width; ++x) {
+                    const float support = pw[x];
+                    const bool valid = isValidDisparity(src[x], m_MinDisparity);
+                    if (support > MIN_SUPPORT && (valid || fillHoles)) {
+                        const float q = (pa[x] * g[x] + pb[x]) / support;
+                        dst[x] = cv::saturate_cast<short>(q);
+                    } else {
+                        // Too little valid support around this pixel to trust the model: pass the input through.
+                        dst[x] = valid ? src[x] : invalid;
+                    }
+                }
+            }
+        });
+
+        return filteredDisparityMap;
+    }
+}
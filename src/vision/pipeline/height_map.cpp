@@ -0,0 +1,176 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/height_map.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <opencv2/core.hpp>
+
+using namespace vlue::disparity;
+
+namespace vlue::processing {
+    // Per-task accumulator. Heights start at -inf so the merge is a plain max.
+    struct PartialGrid {
+        std::vector<float> height;
+        std::vector<int> count;
+    };
+
+    static cv::Matx44d toMatx(const cv::Mat &Q) {
+        if (Q.rows != 4 || Q.cols != 4) {
+            throw std::invalid_argument("Q must be a 4x4 reprojection matrix.");
+        }
+        cv::Mat q;
+        Q.convertTo(q, CV_64F);
+        cv::Matx44d m;
+        for (int r = 0; r < 4; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                m(r, c) = q.at<double>(r, c);
+            }
+        }
+        return m;
+    }
+
+    static void validate(const HeightMapPipeline::Parameters &params) {
+        if (params.resolution <= 0.0f || params.xMax <= params.xMin || params.yMax <= params.yMin) {
+            throw std::invalid_argument("Height map needs a positive resolution and a non-empty extent.");
+        }
+        if (params.maxHeight <= params.minHeight || params.pixelStep < 1 || params.minPoints < 1) {
+            throw std::invalid_argument("Height band must be non-empty, pixelStep and minPoints positive.");
+        }
+    }
+
+    HeightMapPipeline::HeightMapPipeline(const Parameters &params, const cv::Mat &Q, Callback callback, bool enable)
+        : m_Params(params), m_Q(toMatx(Q)), m_Callback(std::move(callback)) {
+        validate(params);
+        m_Enabled = enable;
+    }
+
+    cv::Matx44d HeightMapPipeline::cameraToGround(double height, double pitch) {
+        // Ground x = forward, y = left, z = up. A camera pitched down by `pitch` looks along
+        // (cos, 0, -sin) in the ground frame; its y axis (down in the image) is (-sin, 0, -cos).
+        const double s = std::sin(pitch), c = std::cos(pitch);
+        return {0, -s, c, 0,
+                -1, 0, 0, 0,
+                0, -c, -s, height,
+                0, 0, 0, 1};
+    }
+
+    HeightMap HeightMapPipeline::build(const cv::Mat &disparity, const cv::Mat &Q, const Parameters &params) {
+        validate(params);
+        return build_(disparity, toMatx(Q), params);
+    }
+
+    HeightMap HeightMapPipeline::build_(const cv::Mat &disparity, const cv::Matx44d &Q, const Parameters &params) {
+        if (disparity.type() != CV_16SC1) {
+            throw std::invalid_argument("Height map expects a CV_16SC1 disparity map.");
+        }
+        const float res = params.resolution;
+        const int gridCols = static_cast<int>(std::ceil((params.xMax - params.xMin) / res));
+        const int gridRows = static_cast<int>(std::ceil((params.yMax - params.yMin) / res));
+        const size_t cells = static_cast<size_t>(gridRows) * gridCols;
+
+        // Pixel (u, v, d) maps to M * (u, v, d, 1); only rows 0..2 of M and its last row (w) are needed.
+        const cv::Matx44d M = params.cameraToGround * Q;
+        const int step = params.pixelStep;
+        const int sampledRows = (disparity.rows + step - 1) / step;
+
+        // A fixed number of row stripes, each with its own grid: the merge cost is bounded by the stripe
+        // count, not the thread pool's chunking.
+        const int stripes = std::max(1, std::min(sampledRows, cv::getNumThreads()));
+        std::vector<PartialGrid> partials(stripes);
+        cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range &range) {
+            for (int s = range.start; s < range.end; ++s) {
+                PartialGrid &grid = partials[s];
+                grid.height.assign(cells, -std::numeric_limits<float>::infinity());
+                grid.count.assign(cells, 0);
+                const int r0 = sampledRows * s / stripes, r1 = sampledRows * (s + 1) / stripes;
+                for (int r = r0; r < r1; ++r) {
+                    const int v = r * step;
+                    const short *row = disparity.ptr<short>(v);
+                    // Row-constant part, then the u and d terms per pixel.
+                    double base[4];
+                    for (int k = 0; k < 4; ++k) {
+                        base[k] = M(k, 1) * v + M(k, 3);
+                    }
+                    for (int u = 0; u < disparity.cols; u += step) {
+                        if (!isValidDisparity(row[u], params.minDisparity)) {
+                            continue;
+                        }
+                        const double d = static_cast<double>(row[u]) / DISP_SCALE;
+                        const double w = base[3] + M(3, 0) * u + M(3, 2) * d;
+                        if (w <= 1e-9) {
+                            continue;
+                        }
+                        const double inv = 1.0 / w;
+                        const auto x = static_cast<float>((base[0] + M(0, 0) * u + M(0, 2) * d) * inv);
+                        const auto y = static_cast<float>((base[1] + M(1, 0) * u + M(1, 2) * d) * inv);
+                        const auto z = static_cast<float>((base[2] + M(2, 0) * u + M(2, 2) * d) * inv);
+                        if (z < params.minHeight || z > params.maxHeight) {
+                            continue;
+                        }
+                        const int col = static_cast<int>(std::floor((x - params.xMin) / res));
+                        const int cell = static_cast<int>(std::floor((y - params.yMin) / res));
+                        if (col < 0 || col >= gridCols || cell < 0 || cell >= gridRows) {
+                            continue;
+                        }
+                        const size_t index = static_cast<size_t>(cell) * gridCols + col;
+                        grid.height[index] = std::max(grid.height[index], z);
+                        ++grid.count[index];
+                    }
+                }
+            }
+        });
+
+        HeightMap map;
+        map.resolution = res;
+        map.xMin = params.xMin;
+        map.yMin = params.yMin;
+        map.height.create(gridRows, gridCols, CV_32F);
+        map.count.create(gridRows, gridCols, CV_32S);
+        map.occupancy.create(gridRows, gridCols, CV_8S);
+
+        // Merge and classify, one grid row per task.
+        cv::parallel_for_(cv::Range(0, gridRows), [&](const cv::Range &range) {
+            for (int r = range.start; r < range.end; ++r) {
+                auto *height = map.height.ptr<float>(r);
+                auto *count = map.count.ptr<int>(r);
+                auto *occupancy = map.occupancy.ptr<signed char>(r);
+                const size_t offset = static_cast<size_t>(r) * gridCols;
+                for (int c = 0; c < gridCols; ++c) {
+                    float h = -std::numeric_limits<float>::infinity();
+                    int n = 0;
+                    for (const auto &grid : partials) {
+                        h = std::max(h, grid.height[offset + c]);
+                        n += grid.count[offset + c];
+                    }
+                    count[c] = n;
+                    height[c] = n > 0 ? h : std::numeric_limits<float>::quiet_NaN();
+                    occupancy[c] = static_cast<signed char>(n < params.minPoints ? -1
+                                                            : h > params.obstacleHeight ? 100 : 0);
+                }
+            }
+        });
+        return map;
+    }
+
+    cv::Mat HeightMapPipeline::filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+        const cv::Mat &rightDisparity, const cv::Mat &rightView) const {
+        return apply(leftDisparity, leftView, rightDisparity, rightView);
+    }
+
+    cv::Mat HeightMapPipeline::apply(const cv::Mat &leftDisparity, [[maybe_unused]] const cv::Mat &leftView,
+                                     [[maybe_unused]] const cv::Mat &rightDisparity,
+                                     [[maybe_unused]] const cv::Mat &rightView) const {
+        const HeightMap map = build_(leftDisparity, m_Q, m_Params);
+        if (m_Callback) {
+            m_Callback(map);
+        }
+        return leftDisparity;
+    }
+}
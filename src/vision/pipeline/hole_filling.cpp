@@ -0,0 +1,75 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/hole_filling.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <opencv2/core.hpp>
+
+using namespace vlue::disparity;
+
+namespace vlue::processing {
+    HoleFillingPipeline::HoleFillingPipeline(Mode mode, int maxHoleWidth, int minDisparity, bool enable)
+        : m_Mode(mode), m_MaxHoleWidth(maxHoleWidth), m_MinDisparity(minDisparity) {
+        if (maxHoleWidth < 0) {
+            throw std::invalid_argument("Maximum hole width must not be negative.");
+        }
+        m_Enabled = enable;
+    }
+
+    cv::Mat HoleFillingPipeline::filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+        const cv::Mat &rightDisparity, const cv::Mat &rightView) const {
+        return apply(leftDisparity, leftView, rightDisparity, rightView);
+    }
+
+    cv::Mat HoleFillingPipeline::apply(const cv::Mat &leftDisparity, [[maybe_unused]] const cv::Mat &leftView,
+                                         [[maybe_unused]] const cv::Mat &rightDisparity,
+                                         [[maybe_unused]] const cv::Mat &rightView) const {
+        if (leftDisparity.type() != CV_16SC1) {
+            throw std::invalid_argument("Hole filling expects a CV_16SC1 disparity map.");
+        }
+
+        cv::Mat disparity = leftDisparity;
+        const int cols = disparity.cols;
+        const int minDisparity = m_MinDisparity;
+        const int maxHoleWidth = m_MaxHoleWidth > 0 ? m_MaxHoleWidth : cols;
+        const bool interpolate = m_Mode == Mode::Interpolate;
+
+        cv::parallel_for_(cv::Range(0, disparity.rows), [&](const cv::Range &range) {
+            for (int y = range.start; y < range.end; ++y) {
+                auto *d = disparity.ptr<short>(y);
+                int x = 0;
+                while (x < cols) {
+                    if (isValidDisparity(d[x], minDisparity)) {
+                        ++x;
+                        continue;
+                    }
+                    const int start = x;
+                    while (x < cols && !isValidDisparity(d[x], minDisparity)) {
+                        ++x;
+                    }
+                    const int end = x; // first valid pixel after the run, or cols
+                    if (end - start > maxHoleWidth || (start == 0 && end == cols)) {
+                        continue;
+                    }
+
+                    const bool hasLeft = start > 0, hasRight = end < cols;
+                    const short left = hasLeft ? d[start - 1] : d[end];
+                    const short right = hasRight ? d[end] : d[start - 1];
+                    if (interpolate && hasLeft && hasRight) {
+                        const float step = static_cast<float>(right - left) / static_cast<float>(end - start + 1);
+                        for (int i = start; i < end; ++i) {
+                            d[i] = cv::saturate_cast<short>(left + step * static_cast<float>(i - start + 1));
+                        }
+                    } else {
+                        std::fill(d + start, d + end, std::min(left, right));
+                    }
+                }
+            }
+        });
+
+        return disparity;
+    }
+}
@@ -0,0 +1,157 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/lr_check.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <climits>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <opencv2/imgproc.hpp>
+
+using namespace vlue::disparity;
+
+namespace vlue::processing {
+    static cv::Mat grayView(const cv::Mat &view) {
+        if (view.type() == CV_8UC1) {
+            return view;
+        }
+        cv::Mat gray;
+        if (view.channels() == 3) {
+            cv::cvtColor(view, gray, cv::COLOR_BGR2GRAY);
+        } else if (view.channels() == 4) {
+            cv::cvtColor(view, gray, cv::COLOR_BGRA2GRAY);
+        } else {
+            view.convertTo(gray, CV_8U);
+        }
+        return gray;
+    }
+
+    // SAD costs at d - 1, d and d + 1 for the window centred at (x, y). Bounds are checked by the caller.
+    static void blockCosts(const cv::Mat &left, const cv::Mat &right, int x, int y, int d, int radius,
+                           int &costPrev, int &cost, int &costNext) {
+        const int width = 2 * radius + 1;
+        costPrev = cost = costNext = 0;
+        for (int j = -radius; j <= radius; ++j) {
+            const uchar *l = left.ptr<uchar>(y + j) + x - radius;
+            const uchar *r = right.ptr<uchar>(y + j) + x - radius - d;
+            for (int i = 0; i < width; ++i) {
+                const int lv = l[i];
+                costPrev += std::abs(lv - r[i + 1]);
+                cost += std::abs(lv - r[i]);
+                costNext += std::abs(lv - r[i - 1]);
+            }
+        }
+    }
+
+    DisparityLRCheckPipeline::DisparityLRCheckPipeline(int threshold, bool subpixel, int subpixelRadius,
+                                                       int minDisparity, int numDisparities, bool enable)
+        : m_Threshold(threshold), m_Subpixel(subpixel), m_SubpixelRadius(subpixelRadius),
+          m_MinDisparity(minDisparity), m_NumDisparities(numDisparities) {
+        if (threshold < 0) {
+            throw std::invalid_argument("Left-right check threshold must not be negative.");
+        }
+        if (subpixelRadius < 0) {
+            throw std::invalid_argument("Subpixel window radius must not be negative.");
+        }
+        if (numDisparities < 0) {
+            throw std::invalid_argument("Number of disparities must not be negative.");
+        }
+        m_Enabled = enable;
+    }
+
+    cv::Mat DisparityLRCheckPipeline::filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+        const cv::Mat &rightDisparity, const cv::Mat &rightView) const {
+        return apply(leftDisparity, leftView, rightDisparity, rightView);
+    }
+
+    cv::Mat DisparityLRCheckPipeline::apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+                                              const cv::Mat &rightDisparity, const cv::Mat &rightView) const {
+        if (leftDisparity.type() != CV_16SC1 || rightDisparity.type() != CV_16SC1) {
+            throw std::invalid_argument("Left-right check expects CV_16SC1 left and right disparity maps.");
+        }
+        if (leftDisparity.size() != rightDisparity.size()) {
+            throw std::invalid_argument("Left and right disparity maps must have the same size.");
+        }
+
+        cv::Mat leftGray, rightGray;
+        const bool subpixel = m_Subpixel;
+        if (subpixel) {
+            if (leftView.size() != leftDisparity.size() || rightView.size() != leftDisparity.size()) {
+                throw std::invalid_argument("Subpixel refinement needs views of the disparity map size.");
+            }
+            leftGray = grayView(leftView);
+            rightGray = grayView(rightView);
+        }
+
+        cv::Mat disparity = leftDisparity.clone();
+        const short invalid = invalidDisparity(m_MinDisparity);
+        const int minDisparity = m_MinDisparity;
+        const int threshold = m_Threshold * DISP_SCALE;
+        // Mirrored right values from here on are the right matcher's invalid value (or beyond).
+        const int unmatched = m_NumDisparities > 0 ? (m_MinDisparity + m_NumDisparities) * DISP_SCALE : INT_MAX;
+        const int radius = m_SubpixelRadius;
+        const int cols = disparity.cols, rows = disparity.rows;
+
+        cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range &range) {
+            std::vector<short> mirrored(cols);
+            for (int y = range.start; y < range.end; ++y) {
+                auto *d = disparity.ptr<short>(y);
+                const auto *rd = rightDisparity.ptr<short>(y);
+                // Gather the mirrored right disparity each left pixel lands on. Pixels landing outside the image
+                // or on an unmatched right pixel get SHRT_MIN, which no valid left disparity agrees with.
+                for (int x = 0; x < cols; ++x) {
+                    const int xr = x - ((d[x] + DISP_SCALE / 2) >> DISP_SHIFT);
+                    const int dr = xr >= 0 && xr < cols ? -rd[xr] : INT_MAX;
+                    mirrored[x] = dr < unmatched && dr <= SHRT_MAX ? static_cast<short>(dr) : SHRT_MIN;
+                }
+
+                // Compare and invalidate, 8 pixels per step.
+                int x = 0;
+#if CV_SIMD128
+                const cv::v_int16x8 lowest = cv::v_setall_s16(static_cast<short>(minDisparity * DISP_SCALE));
+                const cv::v_int16x8 invalids = cv::v_setall_s16(invalid);
+                const cv::v_uint16x8 limit = cv::v_setall_u16(cv::saturate_cast<ushort>(threshold));
+                for (; x <= cols - 8; x += 8) {
+                    const cv::v_int16x8 dl = cv::v_load(d + x);
+                    const cv::v_uint16x8 diff = cv::v_absdiff(dl, cv::v_load(mirrored.data() + x));
+                    const cv::v_int16x8 reject = (dl >= lowest) & cv::v_reinterpret_as_s16(diff > limit);
+                    cv::v_store(d + x, cv::v_select(reject, invalids, dl));
+                }
+#endif
+                for (; x < cols; ++x) {
+                    if (isValidDisparity(d[x], minDisparity) && std::abs(d[x] - mirrored[x]) > threshold) {
+                        d[x] = invalid;
+                    }
+                }
+
+                if (!subpixel || y < radius || y >= rows - radius) {
+                    continue;
+                }
+                for (int x = radius; x < cols - radius; ++x) {
+                    if (!isValidDisparity(d[x], minDisparity)) {
+                        continue;
+                    }
+                    const int di = (d[x] + DISP_SCALE / 2) >> DISP_SHIFT;
+                    if (x - radius - di - 1 < 0 || x + radius - di + 1 >= cols) {
+                        continue;
+                    }
+                    int costPrev, cost, costNext;
+                    blockCosts(leftGray, rightGray, x, y, di, radius, costPrev, cost, costNext);
+                    const int curvature = costPrev - 2 * cost + costNext;
+                    if (curvature <= 0) {
+                        continue; // d is not a strict local minimum, keep the matcher's estimate
+                    }
+                    float offset = static_cast<float>(costPrev - costNext) / static_cast<float>(2 * curvature);
+                    offset = offset > 0.5f ? 0.5f : offset < -0.5f ? -0.5f : offset;
+                    d[x] = cv::saturate_cast<short>((static_cast<float>(di) + offset) * DISP_SCALE);
+                }
+            }
+        });
+
+        return disparity;
+    }
+}
@@ -17,18 +17,36 @@ namespace vlue::processing {
     }
 
     DisparityWLSFilterPipeline::DisparityWLSFilterPipeline(double lambda, double sigmaColor, int LRCThresh, int discRadius, bool enable) {
-        m_Filter = cv::ximgproc::createDisparityWLSFilterGeneric(true);
-        m_Filter->setLambda(lambda);
-        m_Filter->setSigmaColor(sigmaColor);
-        m_Filter->setLRCthresh(LRCThresh);
-        m_Filter->setDepthDiscontinuityRadius(discRadius);
+        updateParameters(lambda, sigmaColor, LRCThresh, discRadius);
         m_Enabled = enable;
     }
 
+    void DisparityWLSFilterPipeline::updateParameters(double lambda, double sigmaColor, int LRCThresh, int discRadius) {
+        std::shared_ptr<cv::ximgproc::DisparityWLSFilter> filter = cv::ximgproc::createDisparityWLSFilterGeneric(true);
+        filter->setLambda(lambda);
+        filter->setSigmaColor(sigmaColor);
+        filter->setLRCthresh(LRCThresh);
+        filter->setDepthDiscontinuityRadius(discRadius);
+        m_Filter.store(filter);
+    }
+
+    double DisparityWLSFilterPipeline::getLambda() const {
+        return m_Filter.load()->getLambda();
+    }
+
+    double DisparityWLSFilterPipeline::getSigmaColor() const {
+        return m_Filter.load()->getSigmaColor();
+    }
+
     cv::Mat DisparityWLSFilterPipeline::filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+        const cv::Mat &rightDisparity, const cv::Mat &rightView) const {
+        return apply(leftDisparity, leftView, rightDisparity, rightView);
+    }
+
+    cv::Mat DisparityWLSFilterPipeline::apply(const cv::Mat &leftDisparity, const cv::Mat &leftView,
         const cv::Mat &rightDisparity, const cv::Mat &rightView) const {
         cv::Mat filteredDisparityMap;
-        m_Filter->filter(leftDisparity, leftView, filteredDisparityMap, rightDisparity, cv::Rect(), rightView);
+        m_Filter.load()->filter(leftDisparity, leftView, filteredDisparityMap, rightDisparity, cv::Rect(), rightView);
 
         return filteredDisparityMap;
     }
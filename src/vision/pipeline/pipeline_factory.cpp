@@ -0,0 +1,134 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/pipeline_factory.h"
+#include "vision/pipeline/pipeline.h"
+#include "vision/pipeline/guided_filter.h"
+#include "vision/pipeline/lr_check.h"
+#include "vision/pipeline/speckle_filter.h"
+#include "vision/pipeline/hole_filling.h"
+#include "vision/pipeline/pointwise.h"
+#include "vision/helpers/yaml.h"
+
+#include <stdexcept>
+#include <string>
+#include <opencv2/core.hpp>
+
+namespace vlue::processing {
+    static int parseDepth(const std::string &depth) {
+        if (depth == "8U") return CV_8U;
+        if (depth == "8S") return CV_8S;
+        if (depth == "16U") return CV_16U;
+        if (depth == "16S") return CV_16S;
+        if (depth == "32S") return CV_32S;
+        if (depth == "32F") return CV_32F;
+        if (depth == "64F") return CV_64F;
+        throw std::invalid_argument("Unknown matrix depth: " + depth);
+    }
+
+    static ThresholdMode parseThresholdMode(const std::string &mode) {
+        if (mode == "binary") return ThresholdMode::Binary;
+        if (mode == "binary_inv") return ThresholdMode::BinaryInv;
+        if (mode == "trunc") return ThresholdMode::Trunc;
+        if (mode == "to_zero") return ThresholdMode::ToZero;
+        if (mode == "to_zero_inv") return ThresholdMode::ToZeroInv;
+        throw std::invalid_argument("Unknown threshold mode: " + mode);
+    }
+
+    struct WlsConfig {
+        double lambda, sigmaColor;
+        int LRCThresh, discRadius;
+    };
+
+    static WlsConfig parseWls(const YAML::Node &config) {
+        return {config["lambda"].as<double>(8000.0), config["sigmaColor"].as<double>(1.5),
+                config["LRCThresh"].as<int>(24), config["discRadius"].as<int>(3)};
+    }
+
+    PipelinePtr PipelineFactory::create(const YAML::Node &config) {
+        if (!config || !config.IsMap()) {
+            throw std::invalid_argument("Pipeline configuration must be a map with a 'type' key.");
+        }
+        const auto type = config["type"].as<std::string>("");
+        const bool enable = config["enable"].as<bool>(true);
+        const int minDisparity = config["minDisparity"].as<int>(0);
+
+        if (type == "wls") {
+            const WlsConfig wls = parseWls(config);
+            return std::make_shared<DisparityWLSFilterPipeline>(wls.lambda, wls.sigmaColor, wls.LRCThresh,
+                                                                wls.discRadius, enable);
+        }
+        if (type == "guided") {
+            return std::make_shared<DisparityFastGuidedFilterPipeline>(config["radius"].as<int>(8),
+                                                                       config["eps"].as<double>(1e-3),
+                                                                       config["subsample"].as<int>(2),
+                                                                       minDisparity,
+                                                                       config["fillHoles"].as<bool>(false), enable);
+        }
+        if (type == "lr_check") {
+            return std::make_shared<DisparityLRCheckPipeline>(config["threshold"].as<int>(1),
+                                                              config["subpixel"].as<bool>(false),
+                                                              config["subpixelRadius"].as<int>(2),
+                                                              minDisparity, config["numDisparities"].as<int>(0),
+                                                              enable);
+        }
+        if (type == "speckle") {
+            return std::make_shared<SpeckleFilterPipeline>(config["maxSpeckleSize"].as<int>(100),
+                                                           config["speckleRange"].as<int>(2),
+                                                           minDisparity, enable);
+        }
+        if (type == "hole_filling") {
+            const auto mode = config["mode"].as<std::string>("background");
+            if (mode != "background" && mode != "interpolate") {
+                throw std::invalid_argument("Unknown hole filling mode: " + mode);
+            }
+            return std::make_shared<HoleFillingPipeline>(mode == "interpolate" ? HoleFillingMode::Interpolate
+                                                                                : HoleFillingMode::Background,
+                                                         config["maxHoleWidth"].as<int>(0), minDisparity, enable);
+        }
+        if (type == "scale") {
+            return std::make_shared<ScalePipeline>(config["alpha"].as<double>(1.0), config["beta"].as<double>(0.0),
+                                                   enable);
+        }
+        if (type == "threshold") {
+            return std::make_shared<ThresholdPipeline>(config["threshold"].as<double>(),
+                                                       config["maxValue"].as<double>(255.0),
+                                                       parseThresholdMode(config["mode"].as<std::string>("binary")),
+                                                       enable);
+        }
+        if (type == "clamp") {
+            return std::make_shared<ClampPipeline>(config["low"].as<double>(), config["high"].as<double>(), enable);
+        }
+        if (type == "convert") {
+            return std::make_shared<ConvertPipeline>(parseDepth(config["depth"].as<std::string>()), enable);
+        }
+        throw std::invalid_argument("Unknown pipeline type: '" + type + "'");
+    }
+
+    std::vector<PipelinePtr> PipelineFactory::createAll(const YAML::Node &config) {
+        std::vector<PipelinePtr> pipelines;
+        if (!config) {
+            return pipelines;
+        }
+        if (!config.IsSequence()) {
+            throw std::invalid_argument("Pipeline chain must be a YAML sequence.");
+        }
+        for (const auto &entry : config) {
+            pipelines.push_back(create(entry));
+        }
+        return pipelines;
+    }
+
+    bool PipelineFactory::update(Pipeline &pipeline, const YAML::Node &config) {
+        if (!config || !config.IsMap()) {
+            throw std::invalid_argument("Pipeline configuration must be a map with a 'type' key.");
+        }
+        const auto type = config["type"].as<std::string>("");
+        if (auto *filter = dynamic_cast<DisparityWLSFilterPipeline *>(&pipeline); filter != nullptr && type == "wls") {
+            const WlsConfig wls = parseWls(config);
+            filter->updateParameters(wls.lambda, wls.sigmaColor, wls.LRCThresh, wls.discRadius);
+            return true;
+        }
+        return false;
+    }
+}
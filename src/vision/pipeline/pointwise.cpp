@@ -0,0 +1,229 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/pointwise.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <opencv2/core.hpp>
+
+namespace vlue::processing {
+    // Samples per tile: small enough to stay in L1 across the whole kernel chain.
+    static constexpr int TILE_SAMPLES = 1024;
+
+    template<typename Tp>
+    static void loadTile(const cv::Mat &src, int y, int offset, float *tile, int count) {
+        const Tp *row = src.ptr<Tp>(y) + offset;
+        for (int i = 0; i < count; ++i) {
+            tile[i] = static_cast<float>(row[i]);
+        }
+    }
+
+    template<typename Tp>
+    static void storeTile(const float *tile, cv::Mat &dst, int y, int offset, int count) {
+        Tp *row = dst.ptr<Tp>(y) + offset;
+        for (int i = 0; i < count; ++i) {
+            row[i] = cv::saturate_cast<Tp>(tile[i]);
+        }
+    }
+
+    static void load(const cv::Mat &src, int y, int offset, float *tile, int count) {
+        switch (src.depth()) {
+            case CV_8U: loadTile<uchar>(src, y, offset, tile, count); break;
+            case CV_8S: loadTile<schar>(src, y, offset, tile, count); break;
+            case CV_16U: loadTile<ushort>(src, y, offset, tile, count); break;
+            case CV_16S: loadTile<short>(src, y, offset, tile, count); break;
+            case CV_32F: loadTile<float>(src, y, offset, tile, count); break;
+            default: throw std::invalid_argument("Unsupported matrix depth for pointwise pipeline.");
+        }
+    }
+
+    static void store(const float *tile, cv::Mat &dst, int y, int offset, int count) {
+        switch (dst.depth()) {
+            case CV_8U: storeTile<uchar>(tile, dst, y, offset, count); break;
+            case CV_8S: storeTile<schar>(tile, dst, y, offset, count); break;
+            case CV_16U: storeTile<ushort>(tile, dst, y, offset, count); break;
+            case CV_16S: storeTile<short>(tile, dst, y, offset, count); break;
+            case CV_32F: storeTile<float>(tile, dst, y, offset, count); break;
+            default: throw std::invalid_argument("Unsupported matrix depth for pointwise pipeline.");
+        }
+    }
+
+    static void checkDepth(int depth) {
+        if (depth == CV_32S || depth == CV_64F) {
+            throw std::invalid_argument("Pointwise pipelines compute in float and cannot hold 32S or 64F exactly.");
+        }
+    }
+
+    // Round and saturate the way storing into `depth` would; float streams are left alone.
+    static void quantize(float *data, int count, int depth) {
+        float low, high;
+        switch (depth) {
+            case CV_8U: low = 0.0f; high = 255.0f; break;
+            case CV_8S: low = -128.0f; high = 127.0f; break;
+            case CV_16U: low = 0.0f; high = 65535.0f; break;
+            case CV_16S: low = -32768.0f; high = 32767.0f; break;
+            default: return;
+        }
+        for (int i = 0; i < count; ++i) {
+            data[i] = std::min(std::max(std::nearbyint(data[i]), low), high);
+        }
+    }
+
+    cv::Mat PointwisePipeline::process(const cv::Mat &inputImage) const {
+        const PointwisePipeline *self = this;
+        return FusedPointwisePipeline::run(inputImage, &self, 1);
+    }
+
+    ScalePipeline::ScalePipeline(double alpha, double beta, bool enable)
+        : m_Alpha(static_cast<float>(alpha)), m_Beta(static_cast<float>(beta)) {
+        m_Enabled = enable;
+    }
+
+    void ScalePipeline::apply(float *data, int count) const {
+        const float alpha = m_Alpha, beta = m_Beta;
+        for (int i = 0; i < count; ++i) {
+            data[i] = data[i] * alpha + beta;
+        }
+    }
+
+    ThresholdPipeline::ThresholdPipeline(double threshold, double maxValue, Mode mode, bool enable)
+        : m_Threshold(static_cast<float>(threshold)), m_MaxValue(static_cast<float>(maxValue)), m_Mode(mode) {
+        m_Enabled = enable;
+    }
+
+    void ThresholdPipeline::apply(float *data, int count) const {
+        const float t = m_Threshold, maxValue = m_MaxValue;
+        switch (m_Mode) {
+            case Mode::Binary:
+                for (int i = 0; i < count; ++i) data[i] = data[i] > t ? maxValue : 0.0f;
+                break;
+            case Mode::BinaryInv:
+                for (int i = 0; i < count; ++i) data[i] = data[i] > t ? 0.0f : maxValue;
+                break;
+            case Mode::Trunc:
+                for (int i = 0; i < count; ++i) data[i] = data[i] > t ? t : data[i];
+                break;
+            case Mode::ToZero:
+                for (int i = 0; i < count; ++i) data[i] = data[i] > t ? data[i] : 0.0f;
+                break;
+            case Mode::ToZeroInv:
+                for (int i = 0; i < count; ++i) data[i] = data[i] > t ? 0.0f : data[i];
+                break;
+        }
+    }
+
+    ClampPipeline::ClampPipeline(double low, double high, bool enable)
+        : m_Low(static_cast<float>(low)), m_High(static_cast<float>(high)) {
+        if (low > high) {
+            throw std::invalid_argument("Clamp lower bound must not exceed the upper bound.");
+        }
+        m_Enabled = enable;
+    }
+
+    void ClampPipeline::apply(float *data, int count) const {
+        const float low = m_Low, high = m_High;
+        for (int i = 0; i < count; ++i) {
+            data[i] = std::min(std::max(data[i], low), high);
+        }
+    }
+
+    ConvertPipeline::ConvertPipeline(int depth, bool enable) : m_Depth(depth) {
+        if (depth < CV_8U || depth > CV_64F) {
+            throw std::invalid_argument("Unsupported target depth for ConvertPipeline.");
+        }
+        checkDepth(depth);
+        m_Enabled = enable;
+    }
+
+    void ConvertPipeline::apply(float *data, int count) const {
+        quantize(data, count, m_Depth);
+    }
+
+    FusedPointwisePipeline::FusedPointwisePipeline(std::vector<std::shared_ptr<PointwisePipeline>> stages)
+        : m_Stages(std::move(stages)) {
+        m_Type = Type::Pointwise;
+        for (const auto &stage : m_Stages) {
+            m_Kernels.push_back(stage.get());
+        }
+    }
+
+    cv::Mat FusedPointwisePipeline::process(const cv::Mat &inputImage) const {
+        return run(inputImage, m_Kernels);
+    }
+
+    std::vector<std::shared_ptr<Pipeline>> FusedPointwisePipeline::fuse(const std::vector<std::shared_ptr<Pipeline>> &pipelines) {
+        std::vector<std::shared_ptr<Pipeline>> plan;
+        std::vector<std::shared_ptr<PointwisePipeline>> group;
+        auto flush = [&plan, &group]() {
+            if (group.size() == 1) {
+                plan.push_back(group.front());
+            } else if (group.size() > 1) {
+                plan.push_back(std::make_shared<FusedPointwisePipeline>(group));
+            }
+            group.clear();
+        };
+        for (const auto &pipeline : pipelines) {
+            if (auto pointwise = std::dynamic_pointer_cast<PointwisePipeline>(pipeline)) {
+                group.push_back(pointwise);
+            } else {
+                flush();
+                plan.push_back(pipeline);
+            }
+        }
+        flush();
+        return plan;
+    }
+
+    cv::Mat FusedPointwisePipeline::run(const cv::Mat &src, const std::vector<const PointwisePipeline *> &stages) {
+        return run(src, stages.data(), stages.size());
+    }
+
+    cv::Mat FusedPointwisePipeline::run(const cv::Mat &src, const PointwisePipeline *const *stages, size_t count) {
+        int depth = src.depth();
+        const PointwisePipeline *last = nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            if (stages[i]->isEnabled()) {
+                last = stages[i];
+                if (stages[i]->outputDepth() >= 0) {
+                    depth = stages[i]->outputDepth();
+                }
+            }
+        }
+        if (last == nullptr || src.empty()) {
+            return src;
+        }
+        checkDepth(src.depth());
+
+        cv::Mat dst(src.size(), CV_MAKETYPE(depth, src.channels()));
+        const int rowSamples = src.cols * src.channels();
+        cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range &range) {
+            alignas(64) float tile[TILE_SAMPLES];
+            for (int y = range.start; y < range.end; ++y) {
+                for (int offset = 0; offset < rowSamples; offset += TILE_SAMPLES) {
+                    const int samples = std::min(TILE_SAMPLES, rowSamples - offset);
+                    load(src, y, offset, tile, samples);
+                    int streamDepth = src.depth();
+                    for (size_t i = 0; i < count; ++i) {
+                        const PointwisePipeline *stage = stages[i];
+                        if (!stage->isEnabled()) {
+                            continue;
+                        }
+                        stage->apply(tile, samples);
+                        if (stage->outputDepth() >= 0) {
+                            streamDepth = stage->outputDepth();
+                        }
+                        // The store below rounds after the last stage.
+                        if (stage != last) {
+                            quantize(tile, samples, streamDepth);
+                        }
+                    }
+                    store(tile, dst, y, offset, samples);
+                }
+            }
+        });
+        return dst;
+    }
+}
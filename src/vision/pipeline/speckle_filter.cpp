@@ -0,0 +1,170 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/speckle_filter.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <opencv2/core.hpp>
+
+using namespace vlue::disparity;
+
+namespace vlue::processing {
+    // Union-find over pixel indices. The root of a set is its smallest index, so a set that lies inside one
+    // stripe is rooted inside that stripe and stripes can be labelled concurrently.
+    static int findRoot(int *parent, int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    static void unite(int *parent, int a, int b) {
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        if (a < b) {
+            parent[b] = a;
+        } else if (b < a) {
+            parent[a] = b;
+        }
+    }
+
+    // Labelling buffers, grown on demand and reused across frames. One set per calling thread, so matchers that
+    // share a stage across threads never see each other's labels.
+    struct SpeckleScratch {
+        std::vector<int> parent, labels;
+        std::unique_ptr<std::atomic<int>[]> sizes;
+        int capacity{0};
+    };
+
+    static SpeckleScratch &scratchFor(int total) {
+        thread_local SpeckleScratch scratch;
+        if (scratch.capacity < total) {
+            scratch.parent.resize(total);
+            scratch.labels.resize(total);
+            scratch.sizes.reset(new std::atomic<int>[total]);
+            scratch.capacity = total;
+        }
+        return scratch;
+    }
+
+    SpeckleFilterPipeline::SpeckleFilterPipeline(int maxSpeckleSize, int speckleRange, int minDisparity, bool enable)
+        : m_MaxSpeckleSize(maxSpeckleSize), m_SpeckleRange(speckleRange), m_MinDisparity(minDisparity) {
+        if (maxSpeckleSize < 0 || speckleRange < 0) {
+            throw std::invalid_argument("Speckle size and range must not be negative.");
+        }
+        m_Enabled = enable;
+    }
+
+    cv::Mat SpeckleFilterPipeline::filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+        const cv::Mat &rightDisparity, const cv::Mat &rightView) const {
+        return apply(leftDisparity, leftView, rightDisparity, rightView);
+    }
+
+    cv::Mat SpeckleFilterPipeline::apply(const cv::Mat &leftDisparity, [[maybe_unused]] const cv::Mat &leftView,
+                                           [[maybe_unused]] const cv::Mat &rightDisparity,
+                                           [[maybe_unused]] const cv::Mat &rightView) const {
+        if (leftDisparity.type() != CV_16SC1) {
+            throw std::invalid_argument("Speckle filter expects a CV_16SC1 disparity map.");
+        }
+        cv::Mat disparity = leftDisparity;
+        if (m_MaxSpeckleSize == 0 || disparity.empty()) {
+            return disparity;
+        }
+
+        const int rows = disparity.rows, cols = disparity.cols;
+        const int total = rows * cols;
+        const int maxDiff = m_SpeckleRange * DISP_SCALE;
+        const int minDisparity = m_MinDisparity;
+        const int maxSpeckleSize = m_MaxSpeckleSize;
+        const short invalid = invalidDisparity(minDisparity);
+
+        const int stripes = std::min(rows, std::max(1, cv::getNumThreads()) * 4);
+        auto stripeStart = [rows, stripes](int stripe) { return static_cast<int>(static_cast<int64_t>(rows) * stripe / stripes); };
+
+        SpeckleScratch &scratch = scratchFor(total);
+        int *p = scratch.parent.data();
+        int *labels = scratch.labels.data();
+        std::atomic<int> *sizes = scratch.sizes.get();
+
+        auto connected = [&](const short *a, const short *b) {
+            return isValidDisparity(*b, minDisparity) && std::abs(*a - *b) <= maxDiff;
+        };
+
+        // Label each stripe independently.
+        cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range &range) {
+            for (int stripe = range.start; stripe < range.end; ++stripe) {
+                const int y0 = stripeStart(stripe), y1 = stripeStart(stripe + 1);
+                for (int y = y0; y < y1; ++y) {
+                    const auto *d = disparity.ptr<short>(y);
+                    const auto *up = y > y0 ? disparity.ptr<short>(y - 1) : nullptr;
+                    for (int x = 0, idx = y * cols; x < cols; ++x, ++idx) {
+                        p[idx] = idx;
+                        sizes[idx].store(0, std::memory_order_relaxed);
+                        if (!isValidDisparity(d[x], minDisparity)) {
+                            continue;
+                        }
+                        if (x > 0 && connected(d + x, d + x - 1)) {
+                            unite(p, idx, idx - 1);
+                        }
+                        if (up && connected(d + x, up + x)) {
+                            unite(p, idx, idx - cols);
+                        }
+                    }
+                }
+            }
+        });
+
+        // Merge labels across stripe seams.
+        for (int stripe = 1; stripe < stripes; ++stripe) {
+            const int y = stripeStart(stripe);
+            if (y <= 0 || y >= rows) {
+                continue;
+            }
+            const auto *d = disparity.ptr<short>(y);
+            const auto *up = disparity.ptr<short>(y - 1);
+            for (int x = 0, idx = y * cols; x < cols; ++x, ++idx) {
+                if (isValidDisparity(d[x], minDisparity) && connected(d + x, up + x)) {
+                    unite(p, idx, idx - cols);
+                }
+            }
+        }
+
+        // Resolve roots read-only and count component sizes.
+        cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range &range) {
+            for (int stripe = range.start; stripe < range.end; ++stripe) {
+                const int i0 = stripeStart(stripe) * cols, i1 = stripeStart(stripe + 1) * cols;
+                for (int idx = i0; idx < i1; ++idx) {
+                    int root = idx;
+                    while (p[root] != root) {
+                        root = p[root];
+                    }
+                    labels[idx] = root;
+                    sizes[root].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range &range) {
+            for (int y = range.start; y < range.end; ++y) {
+                auto *d = disparity.ptr<short>(y);
+                const int *label = labels + y * cols;
+                for (int x = 0; x < cols; ++x) {
+                    if (isValidDisparity(d[x], minDisparity) &&
+                        sizes[label[x]].load(std::memory_order_relaxed) < maxSpeckleSize) {
+                        d[x] = invalid;
+                    }
+                }
+            }
+        });
+
+        return disparity;
+    }
+}
@@ -0,0 +1,242 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/uv_disparity.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <opencv2/core.hpp>
+
+using namespace vlue::disparity;
+
+namespace vlue::processing {
+    // Histogram bin of a fixed-point disparity, or -1 when invalid or outside the range.
+    static inline int binOf(short value, int minDisparity, int numDisparities) {
+        if (!isValidDisparity(value, minDisparity)) {
+            return -1;
+        }
+        const int bin = ((value + DISP_SCALE / 2) >> DISP_SHIFT) - minDisparity;
+        return bin < numDisparities ? bin : -1;
+    }
+
+    // binOf for a run of pixels. Branch-free so the compiler vectorizes it; only the histogram scatter that
+    // follows stays scalar.
+    static void binRow(const short *d, int count, int minDisparity, int numDisparities, short *bins) {
+        const int lowest = minDisparity * DISP_SCALE;
+        for (int x = 0; x < count; ++x) {
+            const int bin = ((d[x] + DISP_SCALE / 2) >> DISP_SHIFT) - minDisparity;
+            bins[x] = static_cast<short>(d[x] >= lowest && bin < numDisparities ? bin : -1);
+        }
+    }
+
+    struct GroundPoint {
+        double d, v;
+        int weight;
+    };
+
+    // Weighted least squares of v = slope * d + intercept.
+    static bool fitLine(const std::vector<GroundPoint> &points, double &slope, double &intercept) {
+        double sw = 0, sd = 0, sv = 0, sdd = 0, sdv = 0;
+        for (const auto &p : points) {
+            sw += p.weight;
+            sd += p.weight * p.d;
+            sv += p.weight * p.v;
+            sdd += p.weight * p.d * p.d;
+            sdv += p.weight * p.d * p.v;
+        }
+        const double det = sw * sdd - sd * sd;
+        if (sw <= 0 || std::abs(det) < 1e-9) {
+            return false;
+        }
+        slope = (sw * sdv - sd * sv) / det;
+        intercept = (sv - slope * sd) / sw;
+        return true;
+    }
+
+    // RANSAC over the dominant disparity of each row, then a least-squares refit on the inliers.
+    static void fitGround(const cv::Mat &vDisparity, const UVDisparityPipeline::Parameters &params, int cols,
+                          UVDisparitySummary &summary) {
+        const int minSupport = std::max(3, cols / 100);
+        const int firstBin = std::max(0, params.minGroundDisparity - params.minDisparity);
+        std::vector<GroundPoint> candidates;
+        for (int v = 0; v < vDisparity.rows; ++v) {
+            const int *row = vDisparity.ptr<int>(v);
+            const int *best = std::max_element(row + std::min(firstBin, vDisparity.cols), row + vDisparity.cols);
+            if (best != row + vDisparity.cols && *best >= minSupport) {
+                candidates.push_back({static_cast<double>(best - row + params.minDisparity), static_cast<double>(v), *best});
+            }
+        }
+        if (candidates.size() < 5) {
+            return;
+        }
+
+        cv::RNG rng(0x5eed);
+        const double tolerance = params.groundTolerance;
+        long long bestScore = 0;
+        double bestSlope = 0.0, bestIntercept = 0.0;
+        for (int iteration = 0; iteration < 200; ++iteration) {
+            const auto &a = candidates[rng.uniform(0, static_cast<int>(candidates.size()))];
+            const auto &b = candidates[rng.uniform(0, static_cast<int>(candidates.size()))];
+            if (a.d == b.d) {
+                continue;
+            }
+            const double slope = (b.v - a.v) / (b.d - a.d);
+            if (slope <= 0.0) {
+                continue; // the ground gets nearer (larger disparity) towards the bottom of the image
+            }
+            const double intercept = a.v - slope * a.d;
+            long long score = 0;
+            for (const auto &p : candidates) {
+                if (std::abs(p.v - (slope * p.d + intercept)) <= tolerance) {
+                    score += p.weight;
+                }
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                bestSlope = slope;
+                bestIntercept = intercept;
+            }
+        }
+        if (bestScore == 0) {
+            return;
+        }
+
+        std::vector<GroundPoint> inliers;
+        for (const auto &p : candidates) {
+            if (std::abs(p.v - (bestSlope * p.d + bestIntercept)) <= tolerance) {
+                inliers.push_back(p);
+            }
+        }
+        double slope = bestSlope, intercept = bestIntercept;
+        if (inliers.size() < 5 || !fitLine(inliers, slope, intercept) || slope <= 0.0) {
+            return;
+        }
+        summary.hasGround = true;
+        summary.groundSlope = slope;
+        summary.groundIntercept = intercept;
+        summary.groundInliers = static_cast<int>(inliers.size());
+    }
+
+    UVDisparityPipeline::UVDisparityPipeline(const Parameters &params, Callback callback, bool enable)
+        : m_Params(params), m_Callback(std::move(callback)) {
+        if (params.numDisparities <= 0) {
+            throw std::invalid_argument("numDisparities must be positive.");
+        }
+        if (params.minObstacleHeight <= 0 || params.groundTolerance < 0.0) {
+            throw std::invalid_argument("Obstacle height must be positive and ground tolerance non-negative.");
+        }
+        m_Enabled = enable;
+    }
+
+    UVDisparitySummary UVDisparityPipeline::analyze(const cv::Mat &disparity, const Parameters &params) {
+        if (disparity.type() != CV_16SC1) {
+            throw std::invalid_argument("U/V-disparity expects a CV_16SC1 disparity map.");
+        }
+        const int rows = disparity.rows, cols = disparity.cols;
+        const int minDisparity = params.minDisparity, numDisparities = params.numDisparities;
+        UVDisparitySummary summary;
+
+        // V-disparity: each task owns whole histogram rows.
+        cv::Mat vDisparity(rows, numDisparities, CV_32S, cv::Scalar(0));
+        cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range &range) {
+            std::vector<short> bins(cols);
+            for (int y = range.start; y < range.end; ++y) {
+                binRow(disparity.ptr<short>(y), cols, minDisparity, numDisparities, bins.data());
+                int *hist = vDisparity.ptr<int>(y);
+                for (int x = 0; x < cols; ++x) {
+                    if (bins[x] >= 0) {
+                        ++hist[bins[x]];
+                    }
+                }
+            }
+        });
+        fitGround(vDisparity, params, cols, summary);
+
+        // Only pixels clearly above the ground line belong to obstacles.
+        const bool hasGround = summary.hasGround;
+        const double slope = summary.groundSlope, intercept = summary.groundIntercept;
+        const double tolerance = params.groundTolerance;
+        auto aboveGround = [&](int y, int bin) {
+            return !hasGround || y < slope * (bin + minDisparity) + intercept - tolerance;
+        };
+
+        // U-disparity in column stripes: each task owns whole histogram columns and reads its stripe row by row.
+        cv::Mat uDisparity(numDisparities, cols, CV_32S, cv::Scalar(0));
+        constexpr int STRIPE = 64;
+        cv::parallel_for_(cv::Range(0, (cols + STRIPE - 1) / STRIPE), [&](const cv::Range &range) {
+            short bins[STRIPE];
+            for (int s = range.start; s < range.end; ++s) {
+                const int x0 = s * STRIPE, x1 = std::min(cols, x0 + STRIPE);
+                for (int y = 0; y < rows; ++y) {
+                    binRow(disparity.ptr<short>(y) + x0, x1 - x0, minDisparity, numDisparities, bins);
+                    for (int x = x0; x < x1; ++x) {
+                        const int bin = bins[x - x0];
+                        if (bin >= 0 && aboveGround(y, bin)) {
+                            ++uDisparity.ptr<int>(bin)[x];
+                        }
+                    }
+                }
+            }
+        });
+
+        // Nearest sufficiently tall cell per column, then its vertical extent from the disparity map.
+        std::vector<ObstacleColumn> columns(cols);
+        std::vector<char> found(cols, 0);
+        cv::parallel_for_(cv::Range(0, cols), [&](const cv::Range &range) {
+            for (int x = range.start; x < range.end; ++x) {
+                int bin = numDisparities - 1;
+                while (bin >= 0 && uDisparity.ptr<int>(bin)[x] < params.minObstacleHeight) {
+                    --bin;
+                }
+                if (bin < 0) {
+                    continue;
+                }
+                ObstacleColumn column;
+                column.u = x;
+                column.disparity = bin + minDisparity;
+                column.count = uDisparity.ptr<int>(bin)[x];
+                column.top = rows;
+                column.bottom = -1;
+                for (int y = 0; y < rows; ++y) {
+                    const int b = binOf(disparity.ptr<short>(y)[x], minDisparity, numDisparities);
+                    if (b >= 0 && std::abs(b - bin) <= 1 && aboveGround(y, b)) {
+                        column.top = std::min(column.top, y);
+                        column.bottom = std::max(column.bottom, y);
+                    }
+                }
+                columns[x] = column;
+                found[x] = 1;
+            }
+        });
+        for (int x = 0; x < cols; ++x) {
+            if (found[x]) {
+                summary.obstacles.push_back(columns[x]);
+            }
+        }
+
+        if (params.keepHistograms) {
+            summary.vDisparity = vDisparity;
+            summary.uDisparity = uDisparity;
+        }
+        return summary;
+    }
+
+    cv::Mat UVDisparityPipeline::filter_(const cv::Mat &leftDisparity, const cv::Mat &leftView,
+        const cv::Mat &rightDisparity, const cv::Mat &rightView) const {
+        return apply(leftDisparity, leftView, rightDisparity, rightView);
+    }
+
+    cv::Mat UVDisparityPipeline::apply(const cv::Mat &leftDisparity, [[maybe_unused]] const cv::Mat &leftView,
+                                       [[maybe_unused]] const cv::Mat &rightDisparity,
+                                       [[maybe_unused]] const cv::Mat &rightView) const {
+        const UVDisparitySummary summary = analyze(leftDisparity, m_Params);
+        if (m_Callback) {
+            m_Callback(summary);
+        }
+        return leftDisparity;
+    }
+}
@@ -3,6 +3,7 @@
 //
 #include "vision/sensors/camera/camera.h"
 #include "vision/helpers/yaml.h"
+#include "vision/helpers/memory_tracker.h"
 #include <iostream>
 #include <opencv2/calib3d.hpp>
 
@@ -66,6 +67,7 @@ namespace vlue::sensors {
     }
 
     void Camera::init_undistort_rectify_map() {
+        const ScopedMemoryRegion region("RectifyMaps");
         cv::initUndistortRectifyMap(k, d, r, p, cv::Size(width, height), CV_32FC1, map_x, map_y);
     }
 }
@@ -0,0 +1,356 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/transport/point_cloud_writer.h"
+#include "vision/helpers/trace.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <opencv2/core.hpp>
+
+namespace vlue::transport {
+    namespace {
+        std::runtime_error systemError(const std::string &what, const std::string &path, int error = errno) {
+            return std::runtime_error(what + " '" + path + "': " + std::strerror(error));
+        }
+
+        // Grows `fd` to `length` bytes with real blocks behind them where the platform allows, so that stores
+        // through the mapping cannot fail with SIGBUS on a full disk.
+        void reserve(int fd, std::size_t length, const std::string &path) {
+#if defined(__linux__)
+            if (const int error = posix_fallocate(fd, 0, off_t(length)); error != 0) {
+                throw systemError("Failed to preallocate", path, error);
+            }
+#else
+            if (ftruncate(fd, off_t(length)) != 0) {
+                throw systemError("Failed to size", path);
+            }
+#endif
+        }
+
+        uint8_t *map(int fd, std::size_t length, const std::string &path) {
+            void *mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) {
+                throw systemError("Failed to map", path);
+            }
+            return static_cast<uint8_t *>(mapping);
+        }
+
+        bool validPoint(const cv::Vec3f &p, float maxDepth) {
+            return std::isfinite(p[0]) && std::isfinite(p[1]) && std::isfinite(p[2]) && std::abs(p[2]) < maxDepth;
+        }
+
+        void colorOf(const cv::Mat &colors, int y, int x, uint8_t &r, uint8_t &g, uint8_t &b) {
+            if (colors.channels() == 1) {
+                r = g = b = colors.ptr<uint8_t>(y)[x];
+            } else {
+                const uint8_t *bgr = colors.ptr<uint8_t>(y) + 3 * x;
+                b = bgr[0];
+                g = bgr[1];
+                r = bgr[2];
+            }
+        }
+    }
+
+    PointCloudWriter::PointCloudWriter(std::string prefix, Options options)
+        : m_Prefix(std::move(prefix)), m_Options(options) {
+        if (m_Prefix.empty()) {
+            throw std::invalid_argument("PointCloudWriter needs an output path prefix.");
+        }
+        if (m_Options.queueFrames == 0 || m_Options.preallocate == 0) {
+            throw std::invalid_argument("PointCloudWriter needs a positive queue length and preallocation step.");
+        }
+        m_Thread = std::thread(&PointCloudWriter::run_, this);
+    }
+
+    PointCloudWriter::~PointCloudWriter() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_Work.notify_all();
+        m_Thread.join();
+        closePart_();
+    }
+
+    std::size_t PointCloudWriter::pointSize(CloudFormat format, bool color) {
+        // PLY stores colour as three uchar properties, PCD as one packed 0x00RRGGBB field.
+        return 3 * sizeof(float) + (color ? (format == CloudFormat::PLY ? 3 : 4) : 0);
+    }
+
+    std::string PointCloudWriter::header(CloudFormat format, std::size_t points, bool color) {
+        std::ostringstream out;
+        if (format == CloudFormat::PLY) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            const char *encoding = "binary_big_endian";
+#else
+            const char *encoding = "binary_little_endian";
+#endif
+            out << "ply\nformat " << encoding << " 1.0\nelement vertex " << points << "\n"
+                << "property float x\nproperty float y\nproperty float z\n";
+            if (color) {
+                out << "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+            }
+            out << "end_header\n";
+        } else {
+            out << "# .PCD v0.7 - Point Cloud Data file format\nVERSION 0.7\n"
+                << (color ? "FIELDS x y z rgb\nSIZE 4 4 4 4\nTYPE F F F U\nCOUNT 1 1 1 1\n"
+                          : "FIELDS x y z\nSIZE 4 4 4\nTYPE F F F\nCOUNT 1 1 1\n")
+                << "WIDTH " << points << "\nHEIGHT 1\nVIEWPOINT 0 0 0 1 0 0 0\nPOINTS " << points
+                << "\nDATA binary\n";
+        }
+        return out.str();
+    }
+
+    bool PointCloudWriter::write(const cv::Mat &points, const cv::Mat &colors, int64_t frame) {
+        if (points.type() != CV_32FC3) {
+            throw std::invalid_argument("PointCloudWriter expects CV_32FC3 points, as from reprojectImageTo3D.");
+        }
+        const bool color = !colors.empty();
+        if (color && (colors.size() != points.size() || (colors.type() != CV_8UC3 && colors.type() != CV_8UC1))) {
+            throw std::invalid_argument("Point colours must be CV_8UC3 (BGR) or CV_8UC1 and match the points.");
+        }
+
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            if (m_InFlight >= m_Options.queueFrames) {
+                if (!m_Options.blockWhenFull) {
+                    ++m_Dropped;
+                    return false;
+                }
+                m_Space.wait(lock, [&] { return m_InFlight < m_Options.queueFrames; });
+            }
+            ++m_InFlight;
+            job.frame = frame >= 0 ? static_cast<uint64_t>(frame) : m_NextFrame;
+            m_NextFrame = job.frame + 1;
+            if (!m_Buffers.empty()) {
+                job.body = std::move(m_Buffers.back());
+                m_Buffers.pop_back();
+            }
+        }
+
+        {
+            // Count valid points per row, then pack each row at its offset; rows are independent.
+            const utils::TraceSpan span("cloud.pack", "sink");
+            const int rows = points.rows, cols = points.cols;
+            const float maxDepth = m_Options.maxDepth;
+            std::vector<std::size_t> offsets(rows + 1, 0);
+            cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range &range) {
+                for (int y = range.start; y < range.end; ++y) {
+                    const auto *row = points.ptr<cv::Vec3f>(y);
+                    offsets[y + 1] = static_cast<std::size_t>(std::count_if(row, row + cols, [&](const cv::Vec3f &p) {
+                        return validPoint(p, maxDepth);
+                    }));
+                }
+            });
+            for (int y = 0; y < rows; ++y) {
+                offsets[y + 1] += offsets[y];
+            }
+
+            const CloudFormat format = m_Options.format;
+            const std::size_t stride = pointSize(format, color);
+            job.points = offsets[rows];
+            job.color = color;
+            job.body.resize(job.points * stride);
+            uint8_t *body = job.body.data();
+            cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range &range) {
+                for (int y = range.start; y < range.end; ++y) {
+                    const auto *row = points.ptr<cv::Vec3f>(y);
+                    uint8_t *out = body + offsets[y] * stride;
+                    for (int x = 0; x < cols; ++x) {
+                        if (!validPoint(row[x], maxDepth)) {
+                            continue;
+                        }
+                        std::memcpy(out, row[x].val, 3 * sizeof(float));
+                        if (color) {
+                            uint8_t r, g, b;
+                            colorOf(colors, y, x, r, g, b);
+                            if (format == CloudFormat::PLY) {
+                                out[12] = r;
+                                out[13] = g;
+                                out[14] = b;
+                            } else {
+                                const uint32_t rgb = uint32_t(r) << 16 | uint32_t(g) << 8 | b;
+                                std::memcpy(out + 12, &rgb, sizeof(rgb));
+                            }
+                        }
+                        out += stride;
+                    }
+                }
+            });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Queue.push_back(std::move(job));
+        }
+        m_Work.notify_one();
+        return true;
+    }
+
+    void PointCloudWriter::flush() {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Space.wait(lock, [&] { return m_InFlight == 0; });
+    }
+
+    uint64_t PointCloudWriter::getWritten() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Written;
+    }
+
+    uint64_t PointCloudWriter::getDropped() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Dropped;
+    }
+
+    uint64_t PointCloudWriter::getFailed() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Failed;
+    }
+
+    void PointCloudWriter::run_() {
+        utils::Tracer::setThreadName("cloud-writer");
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Work.wait(lock, [this] { return m_Stop || !m_Queue.empty(); });
+                if (m_Queue.empty()) {
+                    return;
+                }
+                job = std::move(m_Queue.front());
+                m_Queue.pop_front();
+            }
+
+            bool stored = true;
+            try {
+                const utils::TraceSpan span("cloud.store", "sink");
+                store_(job);
+            } catch (const std::exception &e) {
+                std::cerr << "Error: writing point cloud " << job.frame << " failed: " << e.what() << std::endl;
+                stored = false;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (stored) {
+                    ++m_Written;
+                } else {
+                    ++m_Failed;
+                }
+                --m_InFlight;
+                job.body.clear();
+                m_Buffers.push_back(std::move(job.body));
+            }
+            m_Space.notify_all();
+        }
+    }
+
+    std::string PointCloudWriter::extension_() const {
+        return m_Options.format == CloudFormat::PLY ? ".ply" : ".pcd";
+    }
+
+    void PointCloudWriter::store_(const Job &job) {
+        const std::string text = header(m_Options.format, job.points, job.color);
+        if (m_Options.mode == Mode::PerFrame) {
+            storeFile_(job, text);
+        } else {
+            storeSequence_(job, text);
+        }
+    }
+
+    void PointCloudWriter::storeFile_(const Job &job, const std::string &header) {
+        std::ostringstream name;
+        name << m_Prefix << "_" << std::setw(6) << std::setfill('0') << job.frame << extension_();
+        const std::string path = name.str();
+
+        const int fd = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+        if (fd < 0) {
+            throw systemError("Failed to create", path);
+        }
+        const std::size_t length = header.size() + job.body.size();
+        try {
+            reserve(fd, length, path);
+            uint8_t *mapping = map(fd, length, path);
+            std::memcpy(mapping, header.data(), header.size());
+            if (!job.body.empty()) {
+                std::memcpy(mapping + header.size(), job.body.data(), job.body.size());
+            }
+            munmap(mapping, length);
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+    }
+
+    void PointCloudWriter::storeSequence_(const Job &job, const std::string &header) {
+        const std::size_t length = header.size() + job.body.size();
+        if (m_Fd >= 0 && m_Used > 0 && m_Used + length > m_Options.rollBytes) {
+            closePart_();
+            ++m_Part;
+        }
+
+        std::ostringstream name;
+        name << m_Prefix << "_part" << std::setw(3) << std::setfill('0') << m_Part << extension_();
+        const std::string path = name.str();
+        if (m_Fd < 0) {
+            m_Fd = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+            if (m_Fd < 0) {
+                throw systemError("Failed to create", path);
+            }
+            m_Used = 0;
+            m_Capacity = 0;
+        }
+
+        if (m_Used + length > m_Capacity) {
+            // Grow by whole preallocation steps and remap; clouds already stored stay where they are.
+            const std::size_t step = m_Options.preallocate;
+            const std::size_t capacity = (m_Used + length + step - 1) / step * step;
+            if (m_Map != nullptr) {
+                munmap(m_Map, m_Capacity);
+                m_Map = nullptr;
+            }
+            // Nothing is mapped until both steps succeed; a failed grow (e.g. disk full) is retried by the next job.
+            m_Capacity = 0;
+            reserve(m_Fd, capacity, path);
+            m_Map = map(m_Fd, capacity, path);
+            m_Capacity = capacity;
+        }
+        std::memcpy(m_Map + m_Used, header.data(), header.size());
+        if (!job.body.empty()) {
+            std::memcpy(m_Map + m_Used + header.size(), job.body.data(), job.body.size());
+        }
+        m_Used += length;
+    }
+
+    void PointCloudWriter::closePart_() {
+        if (m_Map != nullptr) {
+            munmap(m_Map, m_Capacity);
+            m_Map = nullptr;
+        }
+        if (m_Fd >= 0) {
+            // Drop the unused preallocated tail so the part ends with its last cloud.
+            if (ftruncate(m_Fd, off_t(m_Used)) != 0) {
+                std::cerr << "Warning: failed to trim point cloud part " << m_Part << ": " << std::strerror(errno)
+                          << std::endl;
+            }
+            close(m_Fd);
+            m_Fd = -1;
+        }
+        m_Capacity = 0;
+        m_Used = 0;
+    }
+}
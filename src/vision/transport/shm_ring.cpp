@@ -0,0 +1,282 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/transport/shm_ring.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <opencv2/core.hpp>
+
+namespace vlue::transport {
+    namespace {
+        constexpr uint32_t SEGMENT_MAGIC = 0x56534852;  // "VSHR"
+        constexpr uint32_t SEGMENT_VERSION = 1;
+        constexpr std::size_t SLOT_ALIGN = 64;
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "The shared ring needs lock-free 64-bit atomics.");
+
+        // Shared layout. Only the atomics are touched concurrently; the other fields are written before the
+        // magic (header) or between the odd and even version stores (slots) and re-validated by readers.
+        struct alignas(SLOT_ALIGN) SegmentHeader {
+            std::atomic<uint32_t> magic;
+            uint32_t version;
+            uint32_t slotCount;
+            uint32_t reserved;
+            uint64_t slotSize;
+            uint64_t slotStride;
+            std::atomic<uint64_t> head;  // number of messages published
+        };
+
+        struct alignas(SLOT_ALIGN) SlotHeader {
+            std::atomic<uint64_t> version;
+            uint64_t sequence;
+            uint32_t kind;
+            int32_t rows;
+            int32_t cols;
+            int32_t type;
+            uint64_t frameSequence;
+            int64_t timestamp;
+            uint64_t size;
+        };
+
+        std::size_t alignUp(std::size_t value) {
+            return (value + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+        }
+
+        std::string shmPath(const std::string &name) {
+            if (name.empty() || name.find('/', 1) != std::string::npos) {
+                throw std::invalid_argument("Invalid shared memory segment name: '" + name + "'");
+            }
+            return name[0] == '/' ? name : "/" + name;
+        }
+
+        std::runtime_error systemError(const std::string &what, const std::string &path) {
+            return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+        }
+    }
+
+    class ShmSegment {
+    public:
+        std::string path;
+        int fd{-1};
+        uint8_t *base{nullptr};
+        std::size_t length{0};
+
+        ShmSegment(std::string path, int fd, std::size_t length, bool writable) : path(std::move(path)), fd(fd),
+                                                                                  length(length) {
+            void *mapping = mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) {
+                const auto error = systemError("Failed to map shared memory segment", this->path);
+                close(fd);
+                throw error;
+            }
+            base = static_cast<uint8_t *>(mapping);
+        }
+
+        ~ShmSegment() {
+            munmap(base, length);
+            close(fd);
+        }
+
+        ShmSegment(const ShmSegment &) = delete;
+        ShmSegment &operator=(const ShmSegment &) = delete;
+
+        [[nodiscard]] SegmentHeader *header() const { return reinterpret_cast<SegmentHeader *>(base); }
+
+        [[nodiscard]] SlotHeader *slot(uint64_t sequence) const {
+            const auto *h = header();
+            return reinterpret_cast<SlotHeader *>(base + sizeof(SegmentHeader) +
+                                                  (sequence % h->slotCount) * h->slotStride);
+        }
+
+        [[nodiscard]] uint8_t *payload(uint64_t sequence) const {
+            return reinterpret_cast<uint8_t *>(slot(sequence)) + sizeof(SlotHeader);
+        }
+    };
+
+    ShmPublisher::ShmPublisher(const std::string &name, std::size_t slotSize, uint32_t slotCount) {
+        if (!slotSize || !slotCount) {
+            throw std::invalid_argument("Shared memory ring needs a positive slot size and slot count.");
+        }
+        const auto path = shmPath(name);
+        const std::size_t stride = sizeof(SlotHeader) + alignUp(slotSize);
+        const std::size_t length = sizeof(SegmentHeader) + stride * slotCount;
+
+        // Replace any stale segment; subscribers still mapping it are unaffected.
+        shm_unlink(path.c_str());
+        const int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            throw systemError("Failed to create shared memory segment", path);
+        }
+        if (ftruncate(fd, off_t(length)) != 0) {
+            const auto error = systemError("Failed to size shared memory segment", path);
+            close(fd);
+            shm_unlink(path.c_str());
+            throw error;
+        }
+        try {
+            m_Segment = std::make_shared<ShmSegment>(path, fd, length, true);
+        } catch (...) {
+            shm_unlink(path.c_str());
+            throw;
+        }
+
+        // ftruncate zero-fills, so every slot starts at version 0 ("never written").
+        auto *header = new (m_Segment->base) SegmentHeader();
+        header->version = SEGMENT_VERSION;
+        header->slotCount = slotCount;
+        header->slotSize = slotSize;
+        header->slotStride = stride;
+        header->head.store(0, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < slotCount; ++i) {
+            new (m_Segment->slot(i)) SlotHeader();
+        }
+        header->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+    }
+
+    ShmPublisher::~ShmPublisher() {
+        shm_unlink(m_Segment->path.c_str());
+    }
+
+    uint64_t ShmPublisher::publish(const cv::Mat &data, PayloadKind kind, uint64_t frameSequence, int64_t timestamp) {
+        if (data.dims > 2) {
+            throw std::invalid_argument("ShmPublisher only carries 2D matrices.");
+        }
+        cv::Mat view = beginWrite(data.rows, data.cols, data.type());
+        data.copyTo(view);
+        return commit(kind, frameSequence, timestamp);
+    }
+
+    cv::Mat ShmPublisher::beginWrite(int rows, int cols, int type) {
+        const std::size_t size = std::size_t(rows) * cols * CV_ELEM_SIZE(type);
+        if (rows < 0 || cols < 0 || size > getSlotSize()) {
+            throw std::invalid_argument("Message of " + std::to_string(size) + " bytes does not fit a " +
+                                        std::to_string(getSlotSize()) + " byte slot.");
+        }
+        auto *slot = m_Segment->slot(m_Next);
+        if (!m_Writing) {
+            slot->version.store(2 * m_Next + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_Writing = true;
+        }
+        slot->rows = rows;
+        slot->cols = cols;
+        slot->type = type;
+        slot->size = size;
+        return {rows, cols, type, m_Segment->payload(m_Next)};
+    }
+
+    uint64_t ShmPublisher::commit(PayloadKind kind, uint64_t frameSequence, int64_t timestamp) {
+        if (!m_Writing) {
+            throw std::runtime_error("ShmPublisher::commit called without beginWrite.");
+        }
+        auto *slot = m_Segment->slot(m_Next);
+        slot->sequence = m_Next;
+        slot->kind = uint32_t(kind);
+        slot->frameSequence = frameSequence;
+        slot->timestamp = timestamp;
+        slot->version.store(2 * (m_Next + 1), std::memory_order_release);
+        m_Segment->header()->head.store(m_Next + 1, std::memory_order_release);
+        m_Writing = false;
+        return m_Next++;
+    }
+
+    std::size_t ShmPublisher::getSlotSize() const { return m_Segment->header()->slotSize; }
+
+    uint32_t ShmPublisher::getSlotCount() const { return m_Segment->header()->slotCount; }
+
+    bool ShmMessage::valid() const {
+        if (!segment) {
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return segment->slot(info.sequence)->version.load(std::memory_order_relaxed) == 2 * (info.sequence + 1);
+    }
+
+    ShmSubscriber::ShmSubscriber(const std::string &name) {
+        const auto path = shmPath(name);
+        const int fd = shm_open(path.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            throw systemError("Failed to open shared memory segment", path);
+        }
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || std::size_t(info.st_size) < sizeof(SegmentHeader)) {
+            close(fd);
+            throw std::runtime_error("Shared memory segment '" + path + "' is not a frame ring.");
+        }
+        m_Segment = std::make_shared<ShmSegment>(path, fd, std::size_t(info.st_size), false);
+
+        const auto *header = m_Segment->header();
+        if (header->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC || header->version != SEGMENT_VERSION ||
+            !header->slotCount ||
+            sizeof(SegmentHeader) + header->slotStride * header->slotCount > m_Segment->length ||
+            header->slotStride < sizeof(SlotHeader) + header->slotSize) {
+            throw std::runtime_error("Shared memory segment '" + path + "' is not a compatible frame ring.");
+        }
+        m_Next = header->head.load(std::memory_order_acquire);
+    }
+
+    bool ShmSubscriber::next(ShmMessage &message, std::chrono::milliseconds timeout) {
+        const auto *header = m_Segment->header();
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;) {
+            const uint64_t head = header->head.load(std::memory_order_acquire);
+            if (m_Next >= head) {
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+            if (head - m_Next > header->slotCount) {
+                m_Dropped += head - header->slotCount - m_Next;
+                m_Next = head - header->slotCount;
+            }
+
+            const auto *slot = m_Segment->slot(m_Next);
+            const uint64_t expected = 2 * (m_Next + 1);
+            if (slot->version.load(std::memory_order_acquire) == expected) {
+                MessageInfo info;
+                info.sequence = slot->sequence;
+                info.kind = PayloadKind(slot->kind);
+                info.rows = slot->rows;
+                info.cols = slot->cols;
+                info.type = slot->type;
+                info.frameSequence = slot->frameSequence;
+                info.timestamp = slot->timestamp;
+                info.size = slot->size;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot->version.load(std::memory_order_relaxed) == expected && info.sequence == m_Next &&
+                    info.rows >= 0 && info.cols >= 0 &&
+                    info.size == std::size_t(info.rows) * info.cols * CV_ELEM_SIZE(info.type) &&
+                    info.size <= header->slotSize) {
+                    message.info = info;
+                    message.data = cv::Mat(info.rows, info.cols, info.type, m_Segment->payload(m_Next));
+                    message.segment = m_Segment;
+                    ++m_Next;
+                    return true;
+                }
+            }
+            // The publisher lapped us between reading the head and the slot.
+            ++m_Dropped;
+            ++m_Next;
+        }
+    }
+
+    void ShmSubscriber::seekLatest() {
+        const uint64_t head = m_Segment->header()->head.load(std::memory_order_acquire);
+        m_Next = head ? head - 1 : 0;
+    }
+
+    std::size_t ShmSubscriber::getSlotSize() const { return m_Segment->header()->slotSize; }
+
+    uint32_t ShmSubscriber::getSlotCount() const { return m_Segment->header()->slotCount; }
+}
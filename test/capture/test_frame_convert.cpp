@@ -0,0 +1,78 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/capture/frame_convert.h"
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+using namespace vlue::capture;
+
+// Packed YUYV frame whose luma is x + y and chroma a constant 128, odd width to exercise the scalar tail.
+static cv::Mat makeYuyv(int rows, int cols) {
+    cv::Mat packed(rows, cols, CV_8UC2);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < cols; ++x) {
+            packed.at<cv::Vec2b>(y, x) = cv::Vec2b(static_cast<uchar>(x + y), 128);
+        }
+    }
+    return packed;
+}
+
+TEST(FrameConvertTest, ExtractLumaKeepsEveryLumaSample) {
+    const cv::Mat packed = makeYuyv(5, 37);
+    cv::Mat gray;
+    extractLuma(packed, gray);
+
+    ASSERT_EQ(gray.type(), CV_8UC1);
+    ASSERT_EQ(gray.size(), packed.size());
+    for (int y = 0; y < gray.rows; ++y) {
+        for (int x = 0; x < gray.cols; ++x) {
+            EXPECT_EQ(gray.at<uchar>(y, x), static_cast<uchar>(x + y));
+        }
+    }
+}
+
+TEST(FrameConvertTest, ExtractLumaFromUyvy) {
+    cv::Mat packed = makeYuyv(3, 20);
+    cv::Mat swapped;
+    cv::flip(packed.reshape(1, packed.rows * packed.cols), swapped, 1);
+    swapped = swapped.reshape(2, packed.rows);
+
+    cv::Mat gray;
+    extractLuma(swapped, gray, false);
+    EXPECT_EQ(gray.at<uchar>(2, 19), static_cast<uchar>(21));
+}
+
+TEST(FrameConvertTest, SplitMatchesSeparateExtraction) {
+    const cv::Mat packed = makeYuyv(4, 66);
+    cv::Mat gray, left, right;
+    extractLuma(packed, gray);
+    extractLumaSplit(packed, left, right, 33);
+
+    ASSERT_EQ(left.cols, 33);
+    ASSERT_EQ(right.cols, 33);
+    EXPECT_EQ(cv::norm(left, gray.colRange(0, 33), cv::NORM_INF), 0.0);
+    EXPECT_EQ(cv::norm(right, gray.colRange(33, 66), cv::NORM_INF), 0.0);
+}
+
+TEST(FrameConvertTest, SplitRejectsColumnOutsideFrame) {
+    const cv::Mat packed = makeYuyv(2, 8);
+    cv::Mat left, right;
+    EXPECT_THROW(extractLumaSplit(packed, left, right, 0), std::invalid_argument);
+    EXPECT_THROW(extractLumaSplit(packed, left, right, 8), std::invalid_argument);
+}
+
+TEST(FrameConvertTest, DecodeGrayFromJpeg) {
+    cv::Mat image(16, 32, CV_8UC3, cv::Scalar(40, 80, 120));
+    std::vector<uchar> buffer;
+    ASSERT_TRUE(cv::imencode(".jpg", image, buffer));
+
+    cv::Mat gray;
+    ASSERT_TRUE(decodeGray(cv::Mat(1, static_cast<int>(buffer.size()), CV_8UC1, buffer.data()), gray));
+    EXPECT_EQ(gray.type(), CV_8UC1);
+    EXPECT_EQ(gray.size(), image.size());
+
+    EXPECT_FALSE(decodeGray(cv::Mat(), gray));
+}
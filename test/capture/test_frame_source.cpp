@@ -0,0 +1,226 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/capture/frame_source.h"
+#include "vision/capture/decode_pool.h"
+#include "vision/capture/stereo_capture.h"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace vlue::capture;
+using namespace std::chrono_literals;
+
+// Writes `frames` side-by-side YUYV frames of 2 * width x height. Luma encodes the frame index in the left
+// view and 100 + index in the right view.
+static std::string writeYuyvFile(int frames, int width, int height) {
+    const auto path = (std::filesystem::temp_directory_path() / "vision_test_frames.yuyv").string();
+    std::ofstream file(path, std::ios::binary);
+    for (int f = 0; f < frames; ++f) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < 2 * width; ++x) {
+                file.put(static_cast<char>(x < width ? f : 100 + f));
+                file.put(static_cast<char>(128));
+            }
+        }
+    }
+    return path;
+}
+
+TEST(FileFrameSourceTest, DeliversFramesInOrderWithSequence) {
+    const auto path = writeYuyvFile(3, 8, 4);
+    FileFrameSource source(path, 16, 4, FOURCC_YUYV, 2);
+    source.start();
+
+    RawFrame frame;
+    for (int f = 0; f < 3; ++f) {
+        ASSERT_TRUE(source.grab(frame, 10ms));
+        EXPECT_EQ(frame.sequence, static_cast<uint64_t>(f));
+        EXPECT_EQ(frame.data.type(), CV_8UC2);
+        EXPECT_EQ(frame.data.at<cv::Vec2b>(0, 0)[0], f);
+    }
+    frame.release();
+    EXPECT_FALSE(source.grab(frame, 10ms));
+    std::remove(path.c_str());
+}
+
+TEST(FileFrameSourceTest, LeasedBuffersAreRequeuedOnRelease) {
+    const auto path = writeYuyvFile(1, 8, 4);
+    FileFrameSource source(path, 16, 4, FOURCC_YUYV, 2, true);
+    source.start();
+
+    RawFrame first, second, third;
+    ASSERT_TRUE(source.grab(first, 10ms));
+    ASSERT_TRUE(source.grab(second, 10ms));
+    EXPECT_FALSE(source.grab(third, 10ms)); // every buffer is leased
+
+    first.release();
+    EXPECT_TRUE(source.grab(third, 10ms));
+    std::remove(path.c_str());
+}
+
+TEST(FileFrameSourceTest, LeaseOutlivesStop) {
+    const auto path = writeYuyvFile(1, 8, 4);
+    FileFrameSource source(path, 16, 4, FOURCC_YUYV, 2);
+    source.start();
+
+    RawFrame frame;
+    ASSERT_TRUE(source.grab(frame, 10ms));
+    source.stop();
+    EXPECT_EQ(frame.data.at<cv::Vec2b>(3, 15)[0], 100);
+    frame.release();
+    std::remove(path.c_str());
+}
+
+TEST(StereoCaptureSourceTest, SplitsGrayViewsFromYuyvSource) {
+    const auto path = writeYuyvFile(2, 8, 4);
+    StereoCapture capture(std::make_shared<FileFrameSource>(path, 16, 4, FOURCC_YUYV, 2), 8, 4);
+    capture.setOutputFormat(CaptureOutputFormat::Gray);
+
+    StereoFrame frame;
+    ASSERT_EQ(capture.captureStereoFrame(frame), CaptureFrameState::HasRightFrame);
+    EXPECT_EQ(frame.left.type(), CV_8UC1);
+    EXPECT_EQ(frame.left.size(), cv::Size(8, 4));
+    EXPECT_EQ(frame.left.at<uchar>(2, 3), 0);
+    EXPECT_EQ(frame.right.at<uchar>(2, 3), 100);
+
+    ASSERT_EQ(capture.captureStereoFrame(frame), CaptureFrameState::HasRightFrame);
+    EXPECT_EQ(frame.sequence, 1u);
+    EXPECT_EQ(frame.right.at<uchar>(0, 0), 101);
+    std::remove(path.c_str());
+}
+
+// Concatenated side-by-side JPEGs whose left half is 10 * index and right half 10 * index + 100.
+static std::string writeMjpegFile(int frames, int width, int height) {
+    const auto path = (std::filesystem::temp_directory_path() / "vision_test_frames.mjpg").string();
+    std::ofstream file(path, std::ios::binary);
+    for (int f = 0; f < frames; ++f) {
+        cv::Mat image(height, 2 * width, CV_8UC3);
+        image.colRange(0, width).setTo(cv::Scalar::all(10 * f));
+        image.colRange(width, 2 * width).setTo(cv::Scalar::all(10 * f + 100));
+        std::vector<uchar> buffer;
+        cv::imencode(".jpg", image, buffer, {cv::IMWRITE_JPEG_QUALITY, 100});
+        file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    }
+    return path;
+}
+
+TEST(DecodePoolTest, DeliversDecodedFramesInCaptureOrder) {
+    const int frames = 12;
+    const auto path = writeMjpegFile(frames, 16, 16);
+    auto source = std::make_shared<FileFrameSource>(path, 32, 16, FOURCC_MJPG, 3);
+    source->start();
+
+    DecodePool::Options options;
+    options.workers = 4;
+    options.width = 16;
+    DecodePool pool(source, options);
+    pool.start();
+
+    StereoFrame frame;
+    for (int f = 0; f < frames; ++f) {
+        ASSERT_TRUE(pool.next(frame, 2000ms));
+        EXPECT_EQ(frame.sequence, static_cast<uint64_t>(f));
+        ASSERT_EQ(frame.left.type(), CV_8UC1);
+        EXPECT_EQ(frame.left.size(), cv::Size(16, 16));
+        EXPECT_NEAR(frame.left.at<uchar>(8, 4), 10 * f, 2);
+        EXPECT_NEAR(frame.right.at<uchar>(8, 12), 10 * f + 100, 2);
+    }
+    EXPECT_FALSE(pool.next(frame, 50ms));
+    EXPECT_EQ(pool.getDecodeFailures(), 0u);
+    pool.stop();
+    std::remove(path.c_str());
+}
+
+TEST(DecodePoolTest, DecodesSeparateSourcesAsIndependentTasks) {
+    const auto path = writeYuyvFile(4, 8, 4);
+    auto left = std::make_shared<FileFrameSource>(path, 16, 4, FOURCC_YUYV, 2);
+    auto right = std::make_shared<FileFrameSource>(path, 16, 4, FOURCC_YUYV, 2);
+    left->start();
+    right->start();
+
+    DecodePool::Options options;
+    options.workers = 2;
+    DecodePool pool(left, right, options);
+    pool.start();
+
+    StereoFrame frame;
+    for (int f = 0; f < 4; ++f) {
+        ASSERT_TRUE(pool.next(frame, 2000ms));
+        EXPECT_EQ(frame.left.size(), cv::Size(16, 4));
+        EXPECT_EQ(frame.right.size(), cv::Size(16, 4));
+        EXPECT_EQ(frame.left.at<uchar>(0, 0), f);
+        EXPECT_EQ(frame.right.at<uchar>(0, 0), f);
+    }
+    pool.stop();
+    std::remove(path.c_str());
+}
+
+// GREY frames whose pixels hold the frame index; `script` decides per grab() call whether to deliver the next
+// frame ('f'), time out ('t') or throw ('x'). Calls past the end of the script time out.
+class ScriptedSource : public FrameSource {
+    std::string m_Script;
+    size_t m_Call{0};
+    uint64_t m_Next{0};
+
+public:
+    explicit ScriptedSource(std::string script) : m_Script(std::move(script)) {}
+
+    void start() override {}
+    void stop() override {}
+
+    bool grab(RawFrame &frame, std::chrono::milliseconds) override {
+        const char step = m_Call < m_Script.size() ? m_Script[m_Call++] : 't';
+        if (step == 'x') {
+            throw std::runtime_error("device unplugged");
+        }
+        if (step == 't') {
+            return false;
+        }
+        frame.data = cv::Mat(4, 4, CV_8UC1, cv::Scalar::all(static_cast<double>(m_Next)));
+        frame.fourcc = FOURCC_GREY;
+        frame.sequence = m_Next++;
+        return true;
+    }
+
+    [[nodiscard]] cv::Size getSize() const override { return {4, 4}; }
+    [[nodiscard]] uint32_t getFourcc() const override { return FOURCC_GREY; }
+};
+
+TEST(DecodePoolTest, KeepsLeftFrameWhenRightGrabTimesOut) {
+    DecodePool::Options options;
+    options.workers = 1;
+    options.grabTimeout = 1ms;
+    DecodePool pool(std::make_shared<ScriptedSource>("fff"), std::make_shared<ScriptedSource>("ftfttf"), options);
+    pool.start();
+
+    StereoFrame frame;
+    for (int f = 0; f < 3; ++f) {
+        ASSERT_TRUE(pool.next(frame, 2000ms));
+        EXPECT_EQ(frame.left.at<uchar>(0, 0), f);
+        EXPECT_EQ(frame.right.at<uchar>(0, 0), f);
+    }
+    pool.stop();
+}
+
+TEST(DecodePoolTest, SourceErrorReachesNextAfterEarlierFrames) {
+    DecodePool::Options options;
+    options.workers = 2;
+    options.grabTimeout = 1ms;
+    DecodePool pool(std::make_shared<ScriptedSource>("ffx"), options);
+    pool.start();
+
+    StereoFrame frame;
+    ASSERT_TRUE(pool.next(frame, 2000ms));
+    ASSERT_TRUE(pool.next(frame, 2000ms));
+    EXPECT_EQ(frame.left.at<uchar>(0, 0), 1);
+    EXPECT_THROW(pool.next(frame, 2000ms), std::runtime_error);
+    pool.stop();
+}
@@ -0,0 +1,165 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/codec/disparity_codec.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+using namespace vlue::codec;
+
+// Sloped surface with subpixel noise, invalid blocks and a few extreme values.
+static cv::Mat makeDisparity(int rows, int cols) {
+    cv::Mat disparity(rows, cols, CV_16SC1);
+    cv::RNG rng(3);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < cols; ++x) {
+            short value = short(16 * (20 + x / 10 + y / 25) + rng.uniform(-3, 4));
+            if ((x / 7 + y / 5) % 6 == 0) value = -16;
+            disparity.at<short>(y, x) = value;
+        }
+    }
+    disparity.at<short>(rows / 2, cols / 2) = std::numeric_limits<short>::min();
+    disparity.at<short>(rows / 2, cols / 2 + 1) = std::numeric_limits<short>::max();
+    return disparity;
+}
+
+class DisparityCodecTest : public ::testing::TestWithParam<int> {};
+
+TEST_P(DisparityCodecTest, RoundTripsExactly) {
+    const cv::Mat disparity = makeDisparity(101, 131);
+    DisparityCodec::Options options;
+    options.stripeRows = GetParam();
+
+    const auto encoded = DisparityCodec::encode(disparity, options);
+    EXPECT_LT(encoded.size(), disparity.total() * disparity.elemSize());
+
+    cv::Mat decoded;
+    DisparityCodec::decode(encoded, decoded);
+    ASSERT_EQ(decoded.type(), CV_16SC1);
+    ASSERT_EQ(decoded.size(), disparity.size());
+    EXPECT_EQ(cv::countNonZero(decoded != disparity), 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(StripeRows, DisparityCodecTest, ::testing::Values(1, 7, 32, 1000));
+
+TEST(DisparityCodec, DepthIsQuantizedToStep) {
+    cv::Mat depth(48, 64, CV_32FC1);
+    for (int y = 0; y < depth.rows; ++y) {
+        for (int x = 0; x < depth.cols; ++x) {
+            depth.at<float>(y, x) = x == 5 ? std::numeric_limits<float>::quiet_NaN() : 1.0f + 0.0137f * float(x + y);
+        }
+    }
+    depth.at<float>(0, 0) = -1.0f;
+
+    const double step = 0.001;
+    cv::Mat decoded;
+    DisparityCodec::decode(DisparityCodec::encodeDepth(depth, step), decoded);
+    ASSERT_EQ(decoded.type(), CV_32FC1);
+    for (int y = 0; y < depth.rows; ++y) {
+        for (int x = 0; x < depth.cols; ++x) {
+            const float expected = depth.at<float>(y, x);
+            if (std::isfinite(expected) && expected > 0.0f) {
+                EXPECT_NEAR(decoded.at<float>(y, x), expected, step / 2 + 1e-6);
+            } else {
+                EXPECT_EQ(decoded.at<float>(y, x), 0.0f);
+            }
+        }
+    }
+}
+
+TEST(DisparityCodec, RejectsCorruptStreams) {
+    const auto encoded = DisparityCodec::encode(makeDisparity(40, 40));
+    cv::Mat decoded;
+
+    auto truncated = encoded;
+    truncated.resize(truncated.size() - 5);
+    EXPECT_THROW(DisparityCodec::decode(truncated, decoded), std::runtime_error);
+
+    auto badMagic = encoded;
+    badMagic[0] = 'X';
+    EXPECT_THROW(DisparityCodec::decode(badMagic, decoded), std::runtime_error);
+
+    auto trailing = encoded;
+    trailing.push_back(0);
+    EXPECT_THROW(DisparityCodec::decode(trailing, decoded), std::runtime_error);
+
+    EXPECT_THROW(DisparityCodec::encode(cv::Mat(4, 4, CV_8UC1)), std::invalid_argument);
+}
+
+TEST(DisparityCodec, ClampsOversizedStripeRows) {
+    const cv::Mat disparity = makeDisparity(40, 40);
+    DisparityCodec::Options options;
+    options.stripeRows = 64;
+    auto encoded = DisparityCodec::encode(disparity, options);
+
+    // Magic, kind, width, height and invalid value precede the stripe height.
+    constexpr std::size_t offset = 4 + 1 + 3 * 4;
+    for (std::size_t i = 0; i < 4; ++i) {
+        encoded[offset + i] = 0xFF;
+    }
+    cv::Mat decoded;
+    DisparityCodec::decode(encoded, decoded);
+    EXPECT_EQ(cv::countNonZero(decoded != disparity), 0);
+}
+
+// Not a pass/fail benchmark: records size and time next to PNG, the usual way to store 16-bit disparity, so a
+// regression in either shows up in the test output (and the gtest XML report).
+TEST(DisparityCodec, ComparesWithPng) {
+    const cv::Mat disparity = makeDisparity(480, 640);
+    // PNG has no signed 16-bit type; the same bits as CV_16U round-trip losslessly.
+    const cv::Mat bits(disparity.rows, disparity.cols, CV_16UC1, disparity.data, disparity.step);
+    constexpr int repeats = 5;
+
+    using Clock = std::chrono::steady_clock;
+    auto elapsedMs = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+    };
+
+    std::vector<uint8_t> codec;
+    auto start = Clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        codec = DisparityCodec::encode(disparity);
+    }
+    const double codecEncodeMs = elapsedMs(start);
+    cv::Mat codecDecoded;
+    start = Clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        DisparityCodec::decode(codec, codecDecoded);
+    }
+    const double codecDecodeMs = elapsedMs(start);
+
+    std::vector<uint8_t> png;
+    start = Clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        ASSERT_TRUE(cv::imencode(".png", bits, png));
+    }
+    const double pngEncodeMs = elapsedMs(start);
+    cv::Mat pngDecoded;
+    start = Clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        pngDecoded = cv::imdecode(png, cv::IMREAD_UNCHANGED);
+    }
+    const double pngDecodeMs = elapsedMs(start);
+
+    EXPECT_EQ(cv::countNonZero(codecDecoded != disparity), 0);
+    ASSERT_EQ(pngDecoded.type(), CV_16UC1);
+    EXPECT_EQ(cv::countNonZero(pngDecoded != bits), 0);
+
+    const std::size_t raw = disparity.total() * disparity.elemSize();
+    std::cout << "Info: 640x480 disparity, " << raw << " bytes raw\n"
+              << "  DisparityCodec " << codec.size() << " bytes, encode " << codecEncodeMs << " ms, decode "
+              << codecDecodeMs << " ms\n"
+              << "  PNG            " << png.size() << " bytes, encode " << pngEncodeMs << " ms, decode "
+              << pngDecodeMs << " ms" << std::endl;
+    RecordProperty("codec_bytes", static_cast<int>(codec.size()));
+    RecordProperty("png_bytes", static_cast<int>(png.size()));
+    RecordProperty("codec_encode_us", static_cast<int>(codecEncodeMs * 1000));
+    RecordProperty("png_encode_us", static_cast<int>(pngEncodeMs * 1000));
+}
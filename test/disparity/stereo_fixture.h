@@ -0,0 +1,33 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+
+#ifndef VISION_TEST_DISPARITY_STEREO_FIXTURE_H
+#define VISION_TEST_DISPARITY_STEREO_FIXTURE_H
+
+#include "vision/disparity/sgbm.h"
+
+#include <memory>
+#include <opencv2/core.hpp>
+
+namespace vlue::disparity::test {
+    // Matcher shared by the disparity tests: 32 disparities, 5x5 blocks.
+    inline std::unique_ptr<StereoSGBM> makeMatcher() {
+        StereoSGBM::Parameters params;
+        params.numDisparities = 32;
+        params.blockSize = 5;
+        return std::make_unique<StereoSGBM>(params);
+    }
+
+    // Random texture of `textureSize` with the right view shifted so that every pixel has disparity `shift`.
+    // Both views are `shift` columns narrower than the texture.
+    inline void makePair(cv::Mat &left, cv::Mat &right, cv::Size textureSize, int shift, int seed) {
+        cv::Mat texture(textureSize, CV_8UC1);
+        cv::RNG rng(seed);
+        rng.fill(texture, cv::RNG::UNIFORM, 0, 256);
+        left = texture.colRange(0, texture.cols - shift).clone();
+        right = texture.colRange(shift, texture.cols).clone();
+    }
+}
+
+#endif //VISION_TEST_DISPARITY_STEREO_FIXTURE_H
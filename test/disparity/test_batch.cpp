@@ -0,0 +1,64 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/batch.h"
+#include "stereo_fixture.h"
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::disparity;
+using namespace vlue::disparity::test;
+
+TEST(BatchStereoMatcherTest, MatchesSequentialOutputInOrder) {
+    BatchStereoMatcher::Options options;
+    options.workers = 3;
+    options.maxInFlight = 4;
+    BatchStereoMatcher batch(makeMatcher, options);
+    const auto reference = makeMatcher();
+
+    constexpr int frames = 12;
+    std::vector<cv::Mat> expected(frames);
+    int delivered = 0;
+    const auto receive = [&] {
+        BatchResult result;
+        ASSERT_TRUE(batch.next(result));
+        ASSERT_EQ(result.sequence, static_cast<uint64_t>(delivered));
+        EXPECT_EQ(cv::countNonZero(result.leftDisparity != expected[delivered]), 0);
+        ++delivered;
+    };
+
+    for (int i = 0; i < frames; ++i) {
+        cv::Mat left, right, rightDisparity;
+        makePair(left, right, {160, 64}, 4 + i, i);
+        reference->computeDisparity(left, right, expected[i], rightDisparity);
+        while (batch.full()) {
+            receive();
+        }
+        EXPECT_EQ(batch.submit(left, right), static_cast<uint64_t>(i));
+    }
+    while (batch.pending() > 0) {
+        receive();
+    }
+    EXPECT_EQ(delivered, frames);
+    EXPECT_EQ(batch.pending(), 0u);
+}
+
+TEST(BatchStereoMatcherTest, RethrowsFailuresInOrder) {
+    BatchStereoMatcher::Options options;
+    options.workers = 2;
+    BatchStereoMatcher batch(makeMatcher, options);
+
+    cv::Mat left, right;
+    makePair(left, right, {160, 64}, 4, 0);
+    batch.submit(left, right);
+    batch.submit(left, right.colRange(0, right.cols - 1));
+    batch.submit(left, right);
+
+    BatchResult result;
+    EXPECT_TRUE(batch.next(result));
+    EXPECT_THROW(batch.next(result), std::invalid_argument);
+    EXPECT_TRUE(batch.next(result));
+    EXPECT_EQ(result.sequence, 2u);
+    EXPECT_FALSE(batch.next(result));
+}
@@ -0,0 +1,48 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/confidence.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::disparity;
+
+// Constant disparity `d` on the left and the matching -d on the right.
+static void makeMaps(cv::Mat &left, cv::Mat &right, int d) {
+    left = cv::Mat(20, 40, CV_16SC1, cv::Scalar(d * DISP_SCALE));
+    right = cv::Mat(20, 40, CV_16SC1, cv::Scalar(-d * DISP_SCALE));
+}
+
+TEST(DisparityConfidenceTest, ConsistentSmoothDisparityIsConfident) {
+    cv::Mat left, right, confidence;
+    makeMaps(left, right, 8);
+    DisparityConfidence({0, 16}).compute(left, right, confidence);
+
+    ASSERT_EQ(confidence.type(), CV_32FC1);
+    EXPECT_FLOAT_EQ(confidence.at<float>(10, 20), 1.0f);
+    // Pixels whose match falls outside the right view have no left-right support.
+    EXPECT_FLOAT_EQ(confidence.at<float>(10, 2), 0.0f);
+}
+
+TEST(DisparityConfidenceTest, PenalizesDisagreementNoiseAndInvalidPixels) {
+    cv::Mat left, right, confidence;
+    makeMaps(left, right, 8);
+    left.at<short>(10, 20) = invalidDisparity();
+    right.at<short>(5, 22) = static_cast<short>(-9 * DISP_SCALE);  // one pixel off: half of the 2 px tolerance
+    right.at<short>(15, 22) = invalidDisparity(1 - 16);
+    for (int x = 10; x < 20; x += 2) {
+        left.at<short>(2, x) = static_cast<short>(12 * DISP_SCALE);
+    }
+    DisparityConfidence({0, 16}).compute(left, right, confidence);
+
+    EXPECT_FLOAT_EQ(confidence.at<float>(10, 20), 0.0f);
+    EXPECT_NEAR(confidence.at<float>(5, 30), 0.5f, 1e-5f);
+    EXPECT_FLOAT_EQ(confidence.at<float>(15, 30), 0.0f);
+    EXPECT_LT(confidence.at<float>(2, 15), 0.5f);
+
+    // Without a right map only the smoothness term is left.
+    DisparityConfidence({0, 16}).compute(left, cv::Mat(), confidence);
+    EXPECT_FLOAT_EQ(confidence.at<float>(5, 30), 1.0f);
+}
@@ -0,0 +1,69 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/incremental.h"
+#include "stereo_fixture.h"
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::disparity;
+using namespace vlue::disparity::test;
+
+TEST(IncrementalStereoMatcherTest, StaticSceneReusesCachedDisparity) {
+    IncrementalStereoMatcher::Options options;
+    IncrementalStereoMatcher matcher(makeMatcher(), options);
+    cv::Mat left, right, first, second;
+    makePair(left, right, {328, 192}, 8, 1);
+
+    const auto keyframe = matcher.compute(left, right, first);
+    EXPECT_TRUE(keyframe.keyframe);
+    EXPECT_DOUBLE_EQ(keyframe.matchedArea, 1.0);
+
+    const auto idle = matcher.compute(left, right, second);
+    EXPECT_FALSE(idle.keyframe);
+    EXPECT_EQ(idle.changedTiles, 0);
+    EXPECT_DOUBLE_EQ(idle.matchedArea, 0.0);
+    EXPECT_EQ(cv::countNonZero(first != second), 0);
+}
+
+TEST(IncrementalStereoMatcherTest, RecomputesOnlyAroundChangedTiles) {
+    IncrementalStereoMatcher::Options options;
+    options.tileSize = 32;
+    IncrementalStereoMatcher matcher(makeMatcher(), options);
+    cv::Mat left, right, before, after;
+    makePair(left, right, {328, 192}, 8, 2);
+    matcher.compute(left, right, before);
+
+    // A new patch in the middle of the left view only.
+    cv::RNG rng(3);
+    rng.fill(left(cv::Rect(160, 96, 24, 24)), cv::RNG::UNIFORM, 0, 256);
+    const auto info = matcher.compute(left, right, after);
+    EXPECT_FALSE(info.keyframe);
+    EXPECT_EQ(info.changedTiles, 1);
+    EXPECT_EQ(info.recomputedTiles, 9);
+    EXPECT_GT(info.matchedArea, 0.0);
+    EXPECT_LT(info.matchedArea, 0.5);
+
+    // Far from the patch the cached values stay untouched.
+    EXPECT_EQ(cv::countNonZero(before(cv::Rect(0, 0, 320, 32)) != after(cv::Rect(0, 0, 320, 32))), 0);
+
+    // The reference moved with the recompute, so the same frame again is idle.
+    EXPECT_EQ(matcher.compute(left, right, after).changedTiles, 0);
+}
+
+TEST(IncrementalStereoMatcherTest, KeyframeIntervalForcesFullFrame) {
+    IncrementalStereoMatcher::Options options;
+    options.keyframeInterval = 3;
+    IncrementalStereoMatcher matcher(makeMatcher(), options);
+    cv::Mat left, right, disparity;
+    makePair(left, right, {328, 192}, 8, 4);
+
+    EXPECT_TRUE(matcher.compute(left, right, disparity).keyframe);
+    EXPECT_FALSE(matcher.compute(left, right, disparity).keyframe);
+    EXPECT_FALSE(matcher.compute(left, right, disparity).keyframe);
+    EXPECT_TRUE(matcher.compute(left, right, disparity).keyframe);
+
+    matcher.reset();
+    EXPECT_TRUE(matcher.compute(left, right, disparity).keyframe);
+}
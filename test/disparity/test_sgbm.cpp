@@ -0,0 +1,91 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/sgbm.h"
+#include "vision/pipeline/pipeline.h"
+#include "vision/pipeline/pipeline_factory.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <yaml-cpp/yaml.h>
+
+using namespace vlue::disparity;
+using namespace vlue::processing;
+
+static std::string makeConfig(double lambda, double sigmaColor) {
+    return "minDisparity: 0\n"
+           "numDisparities: 32\n"
+           "blockSize: 5\n"
+           "postprocess:\n"
+           "  - type: wls\n"
+           "    lambda: " + std::to_string(lambda) + "\n"
+           "    sigmaColor: " + std::to_string(sigmaColor) + "\n"
+           "  - type: speckle\n"
+           "    maxSpeckleSize: 100\n";
+}
+
+// A matcher with the file's stages registered, keeping a handle on the WLS stage to observe it.
+static std::shared_ptr<DisparityWLSFilterPipeline> registerStages(StereoSGBM &matcher, const YAML::Node &config) {
+    std::shared_ptr<DisparityWLSFilterPipeline> wls;
+    for (const auto &stage : PipelineFactory::createAll(config["postprocess"])) {
+        if (auto filter = std::dynamic_pointer_cast<DisparityWLSFilterPipeline>(stage)) {
+            wls = filter;
+        }
+        matcher.registerPostprocessPipeline(stage);
+    }
+    return wls;
+}
+
+TEST(StereoSGBMTest, UpdateParametersReachesWlsStage) {
+    const YAML::Node config = YAML::Load(makeConfig(8000.0, 1.5));
+    StereoSGBM matcher(StereoSGBM::parseParameters(config));
+    const auto wls = registerStages(matcher, config);
+    ASSERT_NE(wls, nullptr);
+    EXPECT_DOUBLE_EQ(wls->getLambda(), 8000.0);
+
+    matcher.updateParameters(YAML::Load(makeConfig(500.0, 0.8)));
+    EXPECT_DOUBLE_EQ(wls->getLambda(), 500.0);
+    EXPECT_DOUBLE_EQ(wls->getSigmaColor(), 0.8);
+}
+
+TEST(StereoSGBMTest, ReshapedChainKeepsStageParameters) {
+    const YAML::Node config = YAML::Load(makeConfig(8000.0, 1.5));
+    StereoSGBM matcher(StereoSGBM::parseParameters(config));
+    const auto wls = registerStages(matcher, config);
+
+    YAML::Node reshaped = YAML::Load(makeConfig(500.0, 0.8));
+    reshaped["postprocess"].remove(1);
+    reshaped["numDisparities"] = 48;
+    matcher.updateParameters(reshaped);
+    EXPECT_DOUBLE_EQ(wls->getLambda(), 8000.0);
+    EXPECT_EQ(matcher.getParameters().numDisparities, 48);
+}
+
+TEST(StereoSGBMTest, WatchedFileReloadsWlsParameters) {
+    const auto path = (std::filesystem::temp_directory_path() / "vision_test_sgbm_reload.yaml").string();
+    const auto write = [&path](double lambda, double sigmaColor) {
+        std::ofstream(path, std::ios::trunc) << makeConfig(lambda, sigmaColor);
+    };
+    write(8000.0, 1.5);
+    StereoSGBM matcher(StereoSGBM::parseParameters(YAML::LoadFile(path)));
+    const auto wls = registerStages(matcher, YAML::LoadFile(path));
+    matcher.watchParameterFile(path, std::chrono::milliseconds(10));
+
+    write(500.0, 0.8);
+    // Coarse file clocks may not see a rewrite within the same tick.
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(2));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (wls->getLambda() != 500.0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    matcher.stopWatchingParameterFile();
+    EXPECT_DOUBLE_EQ(wls->getLambda(), 500.0);
+    EXPECT_DOUBLE_EQ(wls->getSigmaColor(), 0.8);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,61 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/sparse.h"
+#include "stereo_fixture.h"
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::disparity;
+using namespace vlue::disparity::test;
+
+class SparseMatcherTest : public ::testing::TestWithParam<SparseCost> {};
+
+TEST_P(SparseMatcherTest, RecoversConstantShift) {
+    cv::Mat left, right;
+    makePair(left, right, {200, 60}, 12, 7);
+
+    SparseStereoMatcher::Parameters params;
+    params.numDisparities = 32;
+    params.cost = GetParam();
+    SparseStereoMatcher matcher(params);
+
+    const std::vector<cv::Point2f> points{{60, 20}, {100, 30}, {150, 40}};
+    std::vector<SparseMatch> matches;
+    matcher.match(left, right, points, matches);
+
+    ASSERT_EQ(matches.size(), points.size());
+    for (const auto &m : matches) {
+        EXPECT_TRUE(m.valid);
+        EXPECT_NEAR(m.disparity, 12.0f, 0.5f);
+        EXPECT_GT(m.confidence, 0.1f);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Costs, SparseMatcherTest, ::testing::Values(SparseCost::SAD, SparseCost::Census));
+
+TEST(SparseMatcherTest, PointsNearTheBorderAreInvalid) {
+    cv::Mat left, right;
+    makePair(left, right, {200, 60}, 12, 7);
+    SparseStereoMatcher matcher(SparseStereoMatcher::Parameters{});
+
+    std::vector<SparseMatch> matches;
+    matcher.match(left, right, {{1, 1}, {2, 30}}, matches);
+    EXPECT_FALSE(matches[0].valid);
+    EXPECT_FALSE(matches[1].valid);
+}
+
+TEST(SparseMatcherTest, DepthFromQ) {
+    cv::Mat left, right;
+    makePair(left, right, {200, 60}, 12, 7);
+
+    // f = 500 px, baseline 0.1: Z = f * B / d.
+    cv::Mat Q = (cv::Mat_<double>(4, 4) << 1, 0, 0, -94, 0, 1, 0, -24, 0, 0, 0, 500, 0, 0, 10, 0);
+    SparseStereoMatcher matcher(SparseStereoMatcher::Parameters{}, Q);
+
+    std::vector<SparseMatch> matches;
+    matcher.match(left, right, {{100, 30}}, matches);
+    ASSERT_TRUE(matches[0].valid);
+    EXPECT_NEAR(matches[0].depth, 500.0 / (10.0 * matches[0].disparity), 1e-3);
+}
@@ -0,0 +1,107 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/disparity/upsampling.h"
+#include "vision/disparity/disparity_format.h"
+#include "stereo_fixture.h"
+
+#include <cstdlib>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::disparity;
+
+static constexpr int LOW_ROWS = 12, LOW_COLS = 16;
+
+TEST(DisparityUpsamplerTest, ScalesConstantDisparity) {
+    const cv::Mat low(LOW_ROWS, LOW_COLS, CV_16SC1, cv::Scalar(5 * DISP_SCALE + 4));
+    for (const int f : {2, 4}) {
+        const cv::Mat guide(LOW_ROWS * f, LOW_COLS * f, CV_8UC1, cv::Scalar(90));
+        cv::Mat up;
+        DisparityUpsampler().upsample(low, guide, up, f, 0, 0);
+        ASSERT_EQ(up.type(), CV_16SC1);
+        ASSERT_EQ(up.size(), guide.size());
+        EXPECT_EQ(cv::countNonZero(up != (5 * DISP_SCALE + 4) * f), 0) << f;
+    }
+}
+
+TEST(DisparityUpsamplerTest, PropagatesInvalidRegions) {
+    // A hole wider than the 3x3 neighbourhood stays a hole, carrying the full-resolution invalid value.
+    cv::Mat low(LOW_ROWS, LOW_COLS, CV_16SC1, cv::Scalar(6 * DISP_SCALE));
+    low(cv::Rect(4, 3, 6, 6)).setTo(cv::Scalar(invalidDisparity(-1)));
+    const int f = 2;
+    const cv::Mat guide(LOW_ROWS * f, LOW_COLS * f, CV_8UC1, cv::Scalar(90));
+
+    cv::Mat up;
+    DisparityUpsampler().upsample(low, guide, up, f, -1, -2);
+    const short invalid = invalidDisparity(-2);
+    for (int y = 0; y < up.rows; ++y) {
+        for (int x = 0; x < up.cols; ++x) {
+            const int lx = x / f, ly = y / f;
+            // Low-resolution samples at least two cells inside the hole have no valid neighbour.
+            const bool deep = lx >= 5 && lx <= 8 && ly >= 4 && ly <= 7;
+            const bool outside = lx < 3 || lx > 10 || ly < 2 || ly > 9;
+            if (deep) {
+                EXPECT_EQ(up.at<short>(y, x), invalid) << y << "," << x;
+            } else if (outside) {
+                EXPECT_EQ(up.at<short>(y, x), 6 * DISP_SCALE * f) << y << "," << x;
+            }
+        }
+    }
+}
+
+TEST(DisparityUpsamplerTest, ClampsToTheFullResolutionMinimum) {
+    // minDisparity -3 at f = 2 floors to -2 at low resolution, whose smallest value would come back as -4: the
+    // full-resolution invalid value. It has to stay a valid -3 instead.
+    const cv::Mat low(LOW_ROWS, LOW_COLS, CV_16SC1, cv::Scalar(-2 * DISP_SCALE));
+    const cv::Mat guide(LOW_ROWS * 2, LOW_COLS * 2, CV_8UC1, cv::Scalar(90));
+    cv::Mat up;
+    DisparityUpsampler().upsample(low, guide, up, 2, -2, -3);
+    EXPECT_EQ(cv::countNonZero(up != -3 * DISP_SCALE), 0);
+}
+
+TEST(DisparityUpsamplerTest, RejectsInvalidInput) {
+    EXPECT_THROW(DisparityUpsampler(0), std::invalid_argument);
+    EXPECT_THROW(DisparityUpsampler(1, 0.0), std::invalid_argument);
+    cv::Mat up;
+    EXPECT_THROW(DisparityUpsampler().upsample(cv::Mat(4, 4, CV_32FC1), cv::Mat(8, 8, CV_8UC1), up, 2, 0, 0),
+                 std::invalid_argument);
+    EXPECT_THROW(DisparityUpsampler().upsample(cv::Mat(4, 4, CV_16SC1), cv::Mat(8, 8, CV_8UC1), up, 0, 0, 0),
+                 std::invalid_argument);
+}
+
+TEST(DisparityUpsamplerTest, DownscaledMatchingTracksFullResolution) {
+    constexpr int shift = 8;
+    cv::Mat left, right;
+    test::makePair(left, right, cv::Size(160 + shift, 120), shift, 7);
+
+    auto matcher = test::makeMatcher();
+    cv::Mat full, fullRight;
+    matcher->computeDisparity(left, right, full, fullRight);
+
+    for (const int f : {2, 4}) {
+        matcher->setDownscale(f);
+        cv::Mat down, downRight;
+        matcher->computeDisparity(left, right, down, downRight);
+        ASSERT_EQ(down.size(), full.size());
+        ASSERT_EQ(down.type(), CV_16SC1);
+
+        // Skip the left band where the full search range does not fit.
+        int both = 0, close = 0, fullValid = 0, downValid = 0;
+        for (int y = 0; y < full.rows; ++y) {
+            for (int x = 32; x < full.cols; ++x) {
+                const short a = full.at<short>(y, x), b = down.at<short>(y, x);
+                fullValid += isValidDisparity(a);
+                downValid += isValidDisparity(b);
+                if (isValidDisparity(a) && isValidDisparity(b)) {
+                    ++both;
+                    close += std::abs(a - b) <= f * DISP_SCALE;
+                }
+            }
+        }
+        ASSERT_GT(both, 0);
+        EXPECT_GT(downValid, fullValid * 8 / 10) << f;
+        EXPECT_GT(close, both * 9 / 10) << f;
+    }
+}
@@ -0,0 +1,171 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/evaluation/dataset.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+using namespace vlue::evaluation;
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr int ROWS = 2, COLS = 3;
+
+    // Rows as they should come out of readPfm, top row first.
+    const float PFM_ROWS[ROWS][COLS] = {{1.5f, 2.0f, 0.25f},
+                                        {-4.0f, std::numeric_limits<float>::infinity(), 100.0f}};
+
+    uint32_t byteSwap(uint32_t v) {
+        return (v >> 24) | ((v >> 8) & 0xff00u) | ((v << 8) & 0xff0000u) | (v << 24);
+    }
+
+    bool hostLittleEndian() {
+        const uint16_t probe = 1;
+        return *reinterpret_cast<const uint8_t *>(&probe) == 1;
+    }
+
+    // PFM stores rows bottom to top; the sign of the scale gives the byte order (negative = little-endian).
+    void writePfm(const fs::path &path, bool littleEndian, const std::string &magic = "Pf") {
+        fs::create_directories(path.parent_path());
+        std::ofstream file(path, std::ios::binary);
+        file << magic << "\n" << COLS << " " << ROWS << "\n" << (littleEndian ? "-1.0" : "1.0") << "\n";
+        for (int y = ROWS - 1; y >= 0; --y) {
+            for (int x = 0; x < COLS; ++x) {
+                uint32_t bits;
+                std::memcpy(&bits, &PFM_ROWS[y][x], sizeof(bits));
+                if (littleEndian != hostLittleEndian()) {
+                    bits = byteSwap(bits);
+                }
+                file.write(reinterpret_cast<const char *>(&bits), sizeof(bits));
+            }
+        }
+    }
+
+    void expectPfmRows(const cv::Mat &disparity) {
+        ASSERT_EQ(disparity.type(), CV_32FC1);
+        ASSERT_EQ(disparity.size(), cv::Size(COLS, ROWS));
+        for (int y = 0; y < ROWS; ++y) {
+            for (int x = 0; x < COLS; ++x) {
+                EXPECT_EQ(disparity.at<float>(y, x), PFM_ROWS[y][x]) << y << "," << x;
+            }
+        }
+    }
+
+    void writeImage(const fs::path &path, int value = 100) {
+        fs::create_directories(path.parent_path());
+        ASSERT_TRUE(cv::imwrite(path.string(), cv::Mat(ROWS, COLS, CV_8UC1, cv::Scalar(value))));
+    }
+
+    class StereoDatasetTest : public ::testing::Test {
+    protected:
+        fs::path m_Root;
+
+        void SetUp() override {
+            const auto *info = ::testing::UnitTest::GetInstance()->current_test_info();
+            m_Root = fs::temp_directory_path() / (std::string("vision_test_dataset_") + info->name());
+            fs::remove_all(m_Root);
+            fs::create_directories(m_Root);
+        }
+
+        void TearDown() override {
+            fs::remove_all(m_Root);
+        }
+    };
+}
+
+TEST_F(StereoDatasetTest, DetectsLayout) {
+    EXPECT_EQ(StereoDataset::detectLayout(m_Root.string()), DatasetLayout::Middlebury);
+    fs::create_directories(m_Root / "image_0");
+    EXPECT_EQ(StereoDataset::detectLayout(m_Root.string()), DatasetLayout::Kitti);
+    fs::create_directories(m_Root / "image_2");
+    EXPECT_EQ(StereoDataset::detectLayout(m_Root.string()), DatasetLayout::Kitti);
+    // A left/ folder wins over everything else.
+    fs::create_directories(m_Root / "left");
+    EXPECT_EQ(StereoDataset::detectLayout(m_Root.string()), DatasetLayout::Directory);
+}
+
+TEST_F(StereoDatasetTest, ReadsPfmInEitherByteOrder) {
+    writePfm(m_Root / "little.pfm", true);
+    writePfm(m_Root / "big.pfm", false);
+    expectPfmRows(readPfm((m_Root / "little.pfm").string()));
+    expectPfmRows(readPfm((m_Root / "big.pfm").string()));
+    expectPfmRows(readDisparity((m_Root / "little.pfm").string()));
+}
+
+TEST_F(StereoDatasetTest, RejectsUnsupportedPfm) {
+    EXPECT_TRUE(readPfm((m_Root / "missing.pfm").string()).empty());
+
+    writePfm(m_Root / "colour.pfm", true, "PF");
+    EXPECT_THROW(readPfm((m_Root / "colour.pfm").string()), std::runtime_error);
+
+    std::ofstream(m_Root / "header.pfm") << "Pf\n0 2\n-1.0\n";
+    EXPECT_THROW(readPfm((m_Root / "header.pfm").string()), std::runtime_error);
+
+    std::ofstream(m_Root / "short.pfm", std::ios::binary) << "Pf\n3 2\n-1.0\n" << std::string(8, '\0');
+    EXPECT_THROW(readPfm((m_Root / "short.pfm").string()), std::runtime_error);
+}
+
+TEST_F(StereoDatasetTest, LoadsKittiWithScaledGroundTruth) {
+    writeImage(m_Root / "image_2" / "000000_10.png");
+    writeImage(m_Root / "image_3" / "000000_10.png");
+    // The _11 frame has no ground truth and is not a sample.
+    writeImage(m_Root / "image_2" / "000000_11.png");
+    writeImage(m_Root / "image_3" / "000000_11.png");
+
+    // KITTI stores disparity * 256 in 16 bits, 0 for unknown.
+    cv::Mat raw(ROWS, COLS, CV_16UC1, cv::Scalar(0));
+    raw.at<uint16_t>(0, 1) = 10 * 256 + 128;
+    raw.at<uint16_t>(1, 2) = 256 * 200;
+    fs::create_directories(m_Root / "disp_occ_0");
+    ASSERT_TRUE(cv::imwrite((m_Root / "disp_occ_0" / "000000_10.png").string(), raw));
+
+    const auto dataset = StereoDataset::load(m_Root.string());
+    ASSERT_EQ(dataset.size(), 1u);
+    const auto &sample = dataset.getSamples().front();
+    EXPECT_EQ(sample.name, "000000_10");
+    EXPECT_EQ(sample.left.channels(), 3);
+    ASSERT_EQ(sample.groundTruth.type(), CV_32FC1);
+    EXPECT_FLOAT_EQ(sample.groundTruth.at<float>(0, 1), 10.5f);
+    EXPECT_FLOAT_EQ(sample.groundTruth.at<float>(1, 2), 200.0f);
+    EXPECT_FLOAT_EQ(sample.groundTruth.at<float>(0, 0), 0.0f);
+    EXPECT_TRUE(dataset.hasGroundTruth());
+}
+
+TEST_F(StereoDatasetTest, LoadsDirectoryAndMiddleburyLayouts) {
+    writeImage(m_Root / "rec" / "left" / "b.png");
+    writeImage(m_Root / "rec" / "right" / "b.png");
+    writeImage(m_Root / "rec" / "left" / "a.png");
+    writeImage(m_Root / "rec" / "right" / "a.png");
+    // No right view: skipped.
+    writeImage(m_Root / "rec" / "left" / "c.png");
+    writePfm(m_Root / "rec" / "disparity" / "a.pfm", true);
+
+    const auto recording = StereoDataset::load((m_Root / "rec").string(), DatasetLayout::Auto, true);
+    ASSERT_EQ(recording.size(), 2u);
+    EXPECT_EQ(recording.getSamples()[0].name, "a");
+    EXPECT_EQ(recording.getSamples()[1].name, "b");
+    EXPECT_EQ(recording.getSamples()[0].left.channels(), 1);
+    expectPfmRows(recording.getSamples()[0].groundTruth);
+    EXPECT_TRUE(recording.getSamples()[1].groundTruth.empty());
+
+    writeImage(m_Root / "mb" / "Piano" / "im0.png");
+    writeImage(m_Root / "mb" / "Piano" / "im1.png");
+    writePfm(m_Root / "mb" / "Piano" / "disp0GT.pfm", false);
+    fs::create_directories(m_Root / "mb" / "notes");
+
+    const auto middlebury = StereoDataset::load((m_Root / "mb").string());
+    ASSERT_EQ(middlebury.size(), 1u);
+    EXPECT_EQ(middlebury.getSamples()[0].name, "Piano");
+    expectPfmRows(middlebury.getSamples()[0].groundTruth);
+}
@@ -0,0 +1,113 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/evaluation/metrics.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::evaluation;
+using namespace vlue::disparity;
+
+static constexpr int ROWS = 4, COLS = 40;
+
+TEST(MetricsTest, DensityCountsValidPixels) {
+    cv::Mat disparity(ROWS, COLS, CV_16SC1, cv::Scalar(3 * DISP_SCALE));
+    disparity.row(0).setTo(cv::Scalar(invalidDisparity()));
+
+    EXPECT_DOUBLE_EQ(disparityDensity(disparity), 0.75);
+    // One below the search range is still valid once minDisparity moves down.
+    disparity.setTo(cv::Scalar(-DISP_SCALE));
+    EXPECT_DOUBLE_EQ(disparityDensity(disparity), 0.0);
+    EXPECT_DOUBLE_EQ(disparityDensity(disparity, -1), 1.0);
+}
+
+TEST(MetricsTest, LeftRightConsistencyMatchesMirroredDisparity) {
+    const cv::Mat left(ROWS, COLS, CV_16SC1, cv::Scalar(5 * DISP_SCALE));
+    cv::Mat right(ROWS, COLS, CV_16SC1, cv::Scalar(-5 * DISP_SCALE));
+    // Off by more than one pixel: the left pixel at x = 25 lands here.
+    right.at<short>(1, 20) = -7 * DISP_SCALE;
+
+    // The five left pixels per row that land left of the image have nothing to agree with.
+    const double expected = (ROWS * (COLS - 5) - 1) / static_cast<double>(ROWS * COLS);
+    EXPECT_DOUBLE_EQ(leftRightConsistency(left, right, 0, 16), expected);
+    EXPECT_DOUBLE_EQ(leftRightConsistency(left, right, 0, 16, 2), (ROWS * (COLS - 5)) / static_cast<double>(ROWS * COLS));
+}
+
+TEST(MetricsTest, LeftRightConsistencySkipsInvalidLeftPixels) {
+    cv::Mat left(ROWS, COLS, CV_16SC1, cv::Scalar(invalidDisparity()));
+    left.at<short>(2, 10) = 4 * DISP_SCALE;
+    const cv::Mat right(ROWS, COLS, CV_16SC1, cv::Scalar(-4 * DISP_SCALE));
+
+    EXPECT_DOUBLE_EQ(leftRightConsistency(left, right, 0, 16), 1.0);
+    EXPECT_DOUBLE_EQ(leftRightConsistency(cv::Mat(ROWS, COLS, CV_16SC1, cv::Scalar(invalidDisparity())), right, 0, 16),
+                     0.0);
+}
+
+TEST(MetricsTest, LeftRightConsistencyRejectsUnmatchedRightPixels) {
+    // With minDisparity -2 and 16 disparities the left range tops out at 13 and the right matcher marks unmatched
+    // pixels with -14; the two are within one pixel of each other but must not count as a match.
+    constexpr int minDisparity = -2, numDisparities = 16;
+    const cv::Mat left(ROWS, COLS, CV_16SC1, cv::Scalar(13 * DISP_SCALE));
+    const cv::Mat right(ROWS, COLS, CV_16SC1, cv::Scalar(invalidDisparity(1 - minDisparity - numDisparities)));
+    ASSERT_EQ(right.at<short>(0, 0), -14 * DISP_SCALE);
+
+    EXPECT_DOUBLE_EQ(leftRightConsistency(left, right, minDisparity, numDisparities), 0.0);
+    EXPECT_DOUBLE_EQ(evaluateDisparity(left, right, cv::Mat(), minDisparity, numDisparities).lrConsistency, 0.0);
+}
+
+TEST(MetricsTest, LeftRightConsistencyValidatesArguments) {
+    const cv::Mat map(ROWS, COLS, CV_16SC1, cv::Scalar(0));
+    EXPECT_THROW(leftRightConsistency(map, map, 0, 0), std::invalid_argument);
+    EXPECT_THROW(leftRightConsistency(map, cv::Mat(ROWS, COLS + 1, CV_16SC1), 0, 16), std::invalid_argument);
+    EXPECT_THROW(leftRightConsistency(map, cv::Mat(ROWS, COLS, CV_32FC1), 0, 16), std::invalid_argument);
+}
+
+// One row: two pixels without ground truth (0 and NaN), one invalid estimate, errors of 0.5 and 0 pixels.
+static void groundTruthFixture(cv::Mat &disparity, cv::Mat &groundTruth) {
+    disparity = (cv::Mat_<short>(1, 5) << 168, invalidDisparity(), 3 * DISP_SCALE, 20 * DISP_SCALE, 8 * DISP_SCALE);
+    groundTruth = (cv::Mat_<float>(1, 5) << 10.0f, 5.0f, 0.0f, std::nanf(""), 8.0f);
+}
+
+TEST(MetricsTest, GroundTruthErrorCountsInvalidAsBad) {
+    cv::Mat disparity, groundTruth;
+    groundTruthFixture(disparity, groundTruth);
+
+    double badPixelRate = -1.0, endPointError = -1.0;
+    groundTruthError(disparity, groundTruth, 1.0, badPixelRate, endPointError);
+    EXPECT_DOUBLE_EQ(badPixelRate, 1.0 / 3.0);
+    // Only pixels with an estimate contribute to the end-point error.
+    EXPECT_DOUBLE_EQ(endPointError, 0.25);
+
+    groundTruthError(disparity, cv::Mat(1, 5, CV_32FC1, cv::Scalar(0)), 1.0, badPixelRate, endPointError);
+    EXPECT_DOUBLE_EQ(badPixelRate, 0.0);
+    EXPECT_DOUBLE_EQ(endPointError, 0.0);
+}
+
+TEST(MetricsTest, BadPixelRatesPerThreshold) {
+    cv::Mat disparity, groundTruth;
+    groundTruthFixture(disparity, groundTruth);
+
+    const auto rates = badPixelRates(disparity, groundTruth, {0.25, 0.5, 1.0});
+    ASSERT_EQ(rates.size(), 3u);
+    EXPECT_DOUBLE_EQ(rates[0], 2.0 / 3.0);
+    EXPECT_DOUBLE_EQ(rates[1], 1.0 / 3.0);
+    EXPECT_DOUBLE_EQ(rates[2], 1.0 / 3.0);
+
+    const auto metrics = evaluateDisparity(disparity, cv::Mat(), groundTruth, 0, 16, 0.25);
+    EXPECT_TRUE(metrics.hasGroundTruth);
+    EXPECT_DOUBLE_EQ(metrics.badPixelRate, rates[0]);
+    EXPECT_DOUBLE_EQ(metrics.density, 0.8);
+}
+
+TEST(MetricsTest, GroundTruthMustMatchTheDisparity) {
+    cv::Mat disparity, groundTruth;
+    groundTruthFixture(disparity, groundTruth);
+    double badPixelRate, endPointError;
+    EXPECT_THROW(groundTruthError(disparity, cv::Mat(1, 4, CV_32FC1), 1.0, badPixelRate, endPointError),
+                 std::invalid_argument);
+    EXPECT_THROW(badPixelRates(disparity, cv::Mat(1, 5, CV_16SC1), {1.0}), std::invalid_argument);
+}
@@ -0,0 +1,111 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/helpers/memory_tracker.h"
+
+#include <future>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::utils;
+
+namespace {
+    struct SampleStage {};
+}
+
+TEST(MemoryTrackerTest, ChargesInnermostRegion) {
+    auto &tracker = MemoryTracker::instance();
+    tracker.install();
+    {
+        const ScopedMemoryRegion outer("test-outer");
+        cv::Mat big(100, 100, CV_16SC1);
+        {
+            const ScopedMemoryRegion inner(MemoryTracker::regionOf<SampleStage>());
+            cv::Mat small(10, 10, CV_8UC1);
+            EXPECT_EQ(tracker.stats("SampleStage").currentBytes, 100);
+        }
+        EXPECT_EQ(tracker.stats("SampleStage").currentBytes, 0);
+        EXPECT_EQ(tracker.stats("SampleStage").peakBytes, 100);
+        EXPECT_EQ(tracker.stats("test-outer").currentBytes, 100 * 100 * 2);
+
+        // Threads without a region of their own charge the open one.
+        std::thread([] { cv::Mat worker(10, 10, CV_32FC1); }).join();
+        EXPECT_EQ(tracker.stats("test-outer").allocations, 2u);
+    }
+    const auto outer = tracker.stats("test-outer");
+    EXPECT_EQ(outer.currentBytes, 0);
+    EXPECT_EQ(outer.peakBytes, 100 * 100 * 2 + 10 * 10 * 4);
+    EXPECT_EQ(outer.deallocations, 2u);
+
+    std::ostringstream os;
+    tracker.dump(os);
+    EXPECT_NE(os.str().find("test-outer"), std::string::npos);
+    tracker.uninstall();
+}
+
+TEST(MemoryTrackerTest, BuffersOutliveTheirRegion) {
+    auto &tracker = MemoryTracker::instance();
+    tracker.install();
+    cv::Mat kept;
+    {
+        const ScopedMemoryRegion region("test-queue");
+        kept.create(16, 16, CV_8UC1);
+    }
+    EXPECT_EQ(tracker.stats("test-queue").currentBytes, 256);
+    tracker.uninstall();
+    kept.release();
+    EXPECT_EQ(tracker.stats("test-queue").currentBytes, 0);
+}
+
+TEST(MemoryTrackerTest, WorkersFollowRegionsClosedOutOfOrder) {
+    auto &tracker = MemoryTracker::instance();
+    tracker.install();
+    const auto workerAllocates = [] { std::thread([] { cv::Mat worker(4, 4, CV_8UC1); }).join(); };
+
+    // This thread opens X, then thread B opens Y; X closes first, then Y.
+    std::promise<void> opened, closeY;
+    auto x = std::make_unique<ScopedMemoryRegion>("test-x");
+    std::thread b([&] {
+        const ScopedMemoryRegion y("test-y");
+        opened.set_value();
+        closeY.get_future().wait();
+    });
+    opened.get_future().wait();
+    x.reset();
+    workerAllocates();
+    EXPECT_EQ(tracker.stats("test-y").allocations, 1u);
+    closeY.set_value();
+    b.join();
+
+    // Both are closed, so nothing may be charged to X any more.
+    const auto unscoped = tracker.stats("unscoped").allocations;
+    workerAllocates();
+    EXPECT_EQ(tracker.stats("test-x").allocations, 0u);
+    EXPECT_EQ(tracker.stats("unscoped").allocations, unscoped + 1);
+    tracker.uninstall();
+}
+
+TEST(MemoryTrackerTest, WorkersFallBackToOlderOpenRegion) {
+    auto &tracker = MemoryTracker::instance();
+    tracker.install();
+    const auto workerAllocates = [] { std::thread([] { cv::Mat worker(4, 4, CV_8UC1); }).join(); };
+
+    // This thread opens P, then thread B opens Q and closes it again while P is still open.
+    const ScopedMemoryRegion p("test-p");
+    std::thread([] { const ScopedMemoryRegion q("test-q"); }).join();
+    workerAllocates();
+    EXPECT_EQ(tracker.stats("test-p").allocations, 1u);
+    EXPECT_EQ(tracker.stats("test-q").allocations, 0u);
+    tracker.uninstall();
+}
+
+TEST(MemoryTrackerTest, RegionOfResolvesOnce) {
+    auto &tracker = MemoryTracker::instance();
+    MemoryTracker::Region *const region = MemoryTracker::regionOf<SampleStage>();
+    EXPECT_EQ(region, tracker.region(typeid(SampleStage)));
+    EXPECT_EQ(region, tracker.region("SampleStage"));
+    EXPECT_EQ(region, MemoryTracker::regionOf<SampleStage>());
+}
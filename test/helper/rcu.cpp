@@ -0,0 +1,96 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/helpers/rcu.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace vlue::utils;
+
+TEST(RcuCellTest, LoadReturnsStoredValue) {
+    RcuCell<const int> cell(std::make_shared<const int>(1));
+    EXPECT_EQ(*cell.load(), 1);
+
+    cell.store(std::make_shared<const int>(2));
+    EXPECT_EQ(*cell.load(), 2);
+}
+
+TEST(RcuCellTest, SnapshotOutlivesStore) {
+    RcuCell<const int> cell(std::make_shared<const int>(1));
+    auto snapshot = cell.load();
+    cell.store(std::make_shared<const int>(2));
+
+    EXPECT_EQ(*snapshot, 1);
+    EXPECT_EQ(*cell.load(), 2);
+}
+
+TEST(RcuCellTest, CopyIsIndependent) {
+    RcuCell<const int> cell(std::make_shared<const int>(1));
+    RcuCell<const int> copy(cell);
+    cell.store(std::make_shared<const int>(2));
+
+    EXPECT_EQ(*copy.load(), 1);
+}
+
+TEST(RcuCellTest, ReadersSeeMonotonicValuesWhileWriterStores) {
+    RcuCell<const int> cell(std::make_shared<const int>(0));
+    std::atomic<bool> done{false};
+    std::atomic<bool> ordered{true};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!done.load()) {
+                const int value = *cell.load();
+                if (value < last) {
+                    ordered = false;
+                }
+                last = value;
+            }
+        });
+    }
+
+    for (int value = 1; value <= 1000; ++value) {
+        cell.store(std::make_shared<const int>(value));
+    }
+    done = true;
+    for (auto &reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_TRUE(ordered.load());
+    EXPECT_EQ(*cell.load(), 1000);
+}
+
+TEST(RcuCellTest, StoreCompletesUnderContinuousLoads) {
+    RcuCell<const int> cell(std::make_shared<const int>(0));
+    std::atomic<bool> done{false};
+
+    // Readers overlap constantly, so a single shared counter would rarely drop to zero.
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 8; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                (void) cell.load();
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int value = 1; value <= 200; ++value) {
+        cell.store(std::make_shared<const int>(value));
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    done = true;
+    for (auto &reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(*cell.load(), 200);
+    EXPECT_LT(elapsed, std::chrono::seconds(5));
+}
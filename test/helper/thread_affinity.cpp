@@ -0,0 +1,41 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/helpers/thread_affinity.h"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace vlue::utils;
+
+TEST(ThreadAffinity, ParsesAndFormatsCpuLists) {
+    EXPECT_EQ(parseCpuList("0-3, 8,10-11,2"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_TRUE(parseCpuList("").empty());
+    EXPECT_EQ(formatCpuList({0, 1, 2, 3, 8, 10, 11}), "0-3,8,10-11");
+    EXPECT_THROW(parseCpuList("4-2"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("1,x"), std::invalid_argument);
+    EXPECT_THROW(parseCpuList("1-2-3"), std::invalid_argument);
+}
+
+TEST(ThreadAffinity, PinsAndReportsThread) {
+    const auto available = currentThreadAffinity();
+    ASSERT_FALSE(available.empty());
+    const int cpu = available.back();
+
+    ThreadPlacement placement;
+    std::thread([&] { placement = placeCurrentThread("test-worker", {cpu}); }).join();
+#if defined(__linux__)
+    EXPECT_TRUE(placement.error.empty()) << placement.error;
+    EXPECT_EQ(placement.cpus, std::vector<int>{cpu});
+#endif
+
+    const auto report = placementReport();
+    EXPECT_TRUE(std::any_of(report.begin(), report.end(), [](const ThreadPlacement &p) {
+        return p.role == "test-worker";
+    }));
+    std::ostringstream os;
+    printPlacementReport(os);
+    EXPECT_NE(os.str().find("test-worker"), std::string::npos);
+}
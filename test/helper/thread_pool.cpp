@@ -0,0 +1,41 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/helpers/thread_pool.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+
+using namespace vlue::utils;
+
+TEST(ThreadPoolTest, SubmitReturnsResult) {
+    ThreadPool pool(2);
+    auto result = pool.submit([] { return 42; });
+    EXPECT_EQ(result.get(), 42);
+}
+
+TEST(ThreadPoolTest, RunsEveryTaskBeforeDestruction) {
+    std::atomic<int> count{0};
+    {
+        ThreadPool pool(3);
+        for (int i = 0; i < 100; ++i) {
+            pool.post([&] { ++count; });
+        }
+    }
+    EXPECT_EQ(count.load(), 100);
+}
+
+TEST(ThreadPoolTest, ExceptionsReachTheFuture) {
+    ThreadPool pool(1);
+    auto result = pool.submit([]() -> int { throw std::runtime_error("decode failed"); });
+    EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, RunsStartHookOnEveryWorker) {
+    std::atomic<unsigned> indices{0};
+    {
+        ThreadPool pool(4, [&](unsigned index) { indices |= 1u << index; });
+    }
+    EXPECT_EQ(indices.load(), 0xFu);
+}
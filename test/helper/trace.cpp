@@ -0,0 +1,61 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/helpers/trace.h"
+
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace vlue::utils;
+
+namespace {
+    struct SampleStage {};
+}
+
+TEST(TraceTest, RecordsNothingWhileDisabled) {
+    Tracer::clear();
+    {
+        const TraceSpan span("disabled");
+    }
+    EXPECT_EQ(Tracer::spanCount(), 0u);
+}
+
+TEST(TraceTest, ExportsTaggedSpansPerThread) {
+    Tracer::clear();
+    Tracer::start();
+    Tracer::setThreadName("main");
+    {
+        const TraceFrame frame(7);
+        const TraceSpan outer("capture.grab", "capture");
+        const TraceSpan inner(Tracer::nameOf<SampleStage>(), "postprocess");
+    }
+    std::thread([] {
+        for (int i = 0; i < 5000; ++i) {
+            const TraceSpan span("worker");
+        }
+    }).join();
+    Tracer::stop();
+    {
+        const TraceSpan span("after-stop");
+    }
+    EXPECT_EQ(Tracer::spanCount(), 5002u);
+
+    std::ostringstream os;
+    Tracer::writeChromeTrace(os);
+    const std::string json = os.str();
+    EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"capture.grab\",\"cat\":\"capture\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"SampleStage\",\"cat\":\"postprocess\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"frame\":7}"), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"main\"}"), std::string::npos);
+    EXPECT_EQ(json.find("after-stop"), std::string::npos);
+    Tracer::clear();
+}
+
+TEST(TraceTest, NameOfResolvesEachTypeOnce) {
+    const char *name = Tracer::nameOf<SampleStage>();
+    EXPECT_STREQ(name, "SampleStage");
+    EXPECT_EQ(Tracer::nameOf<SampleStage>(), name);
+    EXPECT_EQ(Tracer::intern(typeid(SampleStage)), name);
+}
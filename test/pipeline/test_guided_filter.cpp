@@ -0,0 +1,95 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/guided_filter.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <cstdlib>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::processing;
+using namespace vlue::disparity;
+
+static constexpr int SIZE = 40, EDGE = 20;
+
+// Guide and disparity that both step at x = EDGE, like an object boundary seen in the left view.
+static cv::Mat stepGuide() {
+    cv::Mat guide(SIZE, SIZE, CV_8UC1, cv::Scalar(0));
+    guide.colRange(EDGE, SIZE).setTo(cv::Scalar(200));
+    return guide;
+}
+
+static cv::Mat stepDisparity() {
+    cv::Mat disparity(SIZE, SIZE, CV_16SC1, cv::Scalar(10 * DISP_SCALE));
+    disparity.colRange(EDGE, SIZE).setTo(cv::Scalar(30 * DISP_SCALE));
+    return disparity;
+}
+
+TEST(DisparityFastGuidedFilterPipelineTest, PreservesEdgesOfTheGuide) {
+    const cv::Mat input = stepDisparity();
+    const cv::Mat filtered = DisparityFastGuidedFilterPipeline(4, 1e-4, 1).apply(input, stepGuide(), cv::Mat(),
+                                                                               cv::Mat());
+    ASSERT_EQ(filtered.type(), CV_16SC1);
+    // A box filter of the same radius would put the pixels next to the edge halfway between the two sides.
+    for (int y = 0; y < SIZE; ++y) {
+        for (int x = EDGE - 2; x < EDGE + 2; ++x) {
+            EXPECT_LE(std::abs(filtered.at<short>(y, x) - input.at<short>(y, x)), DISP_SCALE / 2) << y << "," << x;
+        }
+    }
+}
+
+TEST(DisparityFastGuidedFilterPipelineTest, RoundTripsFixedPointValues) {
+    // 7.5 px is not a whole pixel, so a lost fractional bit shows up; minDisparity -3 keeps negatives valid.
+    for (const short value : {static_cast<short>(120), static_cast<short>(-2 * DISP_SCALE)}) {
+        const cv::Mat input(SIZE, SIZE, CV_16SC1, cv::Scalar(value));
+        for (const int subsample : {1, 2}) {
+            const cv::Mat filtered = DisparityFastGuidedFilterPipeline(4, 1e-2, subsample, -3)
+                    .apply(input, stepGuide(), cv::Mat(), cv::Mat());
+            ASSERT_EQ(filtered.type(), CV_16SC1);
+            EXPECT_EQ(cv::countNonZero(filtered != value), 0) << value << " subsample " << subsample;
+        }
+    }
+}
+
+TEST(DisparityFastGuidedFilterPipelineTest, FillsHolesOnlyWhenAsked) {
+    cv::Mat input(SIZE, SIZE, CV_16SC1, cv::Scalar(8 * DISP_SCALE));
+    input(cv::Rect(18, 18, 4, 4)).setTo(cv::Scalar(invalidDisparity()));
+    const cv::Mat guide(SIZE, SIZE, CV_8UC1, cv::Scalar(100));
+
+    const cv::Mat kept = DisparityFastGuidedFilterPipeline(4, 1e-2, 1).apply(input, guide, cv::Mat(), cv::Mat());
+    EXPECT_EQ(cv::countNonZero(kept(cv::Rect(18, 18, 4, 4)) != invalidDisparity()), 0);
+    // Invalid pixels carry no weight, so they do not drag their valid neighbours down.
+    EXPECT_EQ(kept.at<short>(17, 17), 8 * DISP_SCALE);
+
+    const cv::Mat filled = DisparityFastGuidedFilterPipeline(4, 1e-2, 1, 0, true).apply(input, guide, cv::Mat(),
+                                                                                         cv::Mat());
+    EXPECT_EQ(cv::countNonZero(filled != 8 * DISP_SCALE), 0);
+}
+
+TEST(DisparityFastGuidedFilterPipelineTest, KeepsValidPixelsWithoutSupport) {
+    // A lone valid pixel in a 33x33 window is below the minimum support, so it has no trusted model.
+    cv::Mat input(SIZE, SIZE, CV_16SC1, cv::Scalar(invalidDisparity()));
+    input.at<short>(20, 20) = 12 * DISP_SCALE;
+    const cv::Mat guide(SIZE, SIZE, CV_8UC1, cv::Scalar(100));
+
+    for (const bool fillHoles : {false, true}) {
+        const cv::Mat filtered = DisparityFastGuidedFilterPipeline(16, 1e-2, 1, 0, fillHoles)
+                .apply(input, guide, cv::Mat(), cv::Mat());
+        EXPECT_EQ(filtered.at<short>(20, 20), 12 * DISP_SCALE);
+        EXPECT_EQ(cv::countNonZero(filtered != invalidDisparity()), 1);
+    }
+}
+
+TEST(DisparityFastGuidedFilterPipelineTest, RejectsInvalidInput) {
+    EXPECT_THROW(DisparityFastGuidedFilterPipeline(0, 1e-2), std::invalid_argument);
+    EXPECT_THROW(DisparityFastGuidedFilterPipeline(4, 0.0), std::invalid_argument);
+    EXPECT_THROW(DisparityFastGuidedFilterPipeline(4, 1e-2, 0), std::invalid_argument);
+
+    const DisparityFastGuidedFilterPipeline filter(4, 1e-2);
+    EXPECT_THROW((void) filter.apply(cv::Mat(SIZE, SIZE, CV_32FC1), stepGuide(), cv::Mat(), cv::Mat()),
+                 std::invalid_argument);
+    EXPECT_THROW((void) filter.apply(stepDisparity(), cv::Mat(SIZE, SIZE + 1, CV_8UC1), cv::Mat(), cv::Mat()),
+                 std::invalid_argument);
+}
@@ -0,0 +1,72 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/height_map.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::processing;
+using namespace vlue::disparity;
+
+// Focal length 100 px, baseline 0.1 m, principal point (40, 30): pixel (u, v) at disparity d is the camera
+// point ((u - 40), (v - 30), 100) * 0.1 / d.
+static cv::Mat makeQ() {
+    return (cv::Mat_<double>(4, 4) << 1, 0, 0, -40,
+                                      0, 1, 0, -30,
+                                      0, 0, 0, 100,
+                                      0, 0, 10, 0);
+}
+
+static HeightMapPipeline::Parameters makeParams() {
+    HeightMapPipeline::Parameters params;
+    params.resolution = 0.5f;
+    params.xMin = 0.0f;
+    params.xMax = 4.0f;
+    params.yMin = -1.0f;
+    params.yMax = 1.0f;
+    params.minPoints = 1;
+    return params;
+}
+
+TEST(HeightMapPipelineTest, MapsPixelsToExpectedCells) {
+    cv::Mat disparity(60, 80, CV_16SC1, cv::Scalar(invalidDisparity()));
+    // Level camera at ground height. Ground point (1.25, -0.25, 0): free.
+    disparity.at<short>(30, 60) = 8 * DISP_SCALE;
+    // Ground point (1.25, 0.25, 0.3): above the obstacle height.
+    disparity.at<short>(6, 20) = 8 * DISP_SCALE;
+
+    const HeightMap map = HeightMapPipeline::build(disparity, makeQ(), makeParams());
+    ASSERT_EQ(map.height.size(), cv::Size(8, 4));
+    EXPECT_EQ(map.count.at<int>(1, 2), 1);
+    EXPECT_NEAR(map.height.at<float>(1, 2), 0.0f, 1e-5f);
+    EXPECT_EQ(map.occupancy.at<signed char>(1, 2), 0);
+    EXPECT_EQ(map.count.at<int>(2, 2), 1);
+    EXPECT_NEAR(map.height.at<float>(2, 2), 0.3f, 1e-5f);
+    EXPECT_EQ(map.occupancy.at<signed char>(2, 2), 100);
+
+    EXPECT_EQ(cv::countNonZero(map.count), 2);
+    EXPECT_EQ(cv::countNonZero(map.occupancy == -1), 8 * 4 - 2);
+    EXPECT_TRUE(std::isnan(map.height.at<float>(0, 0)));
+}
+
+TEST(HeightMapPipelineTest, AppliesCameraPose) {
+    cv::Mat disparity(80, 80, CV_16SC1, cv::Scalar(invalidDisparity()));
+    // Camera point (0.1, 1, 2.5): 1 m below a camera mounted 1 m high, i.e. on the floor at (2.5, -0.1).
+    disparity.at<short>(70, 44) = 4 * DISP_SCALE;
+    // Camera point (-0.1, 0, 2.5): level with the camera, 1 m above the floor at (2.5, 0.1).
+    disparity.at<short>(30, 36) = 4 * DISP_SCALE;
+
+    HeightMapPipeline::Parameters params = makeParams();
+    params.cameraToGround = HeightMapPipeline::cameraToGround(1.0, 0.0);
+    params.resolution = 0.2f;
+    const HeightMap map = HeightMapPipeline::build(disparity, makeQ(), params);
+
+    EXPECT_NEAR(map.height.at<float>(4, 12), 0.0f, 1e-5f);
+    EXPECT_EQ(map.occupancy.at<signed char>(4, 12), 0);
+    EXPECT_NEAR(map.height.at<float>(5, 12), 1.0f, 1e-5f);
+    EXPECT_EQ(map.occupancy.at<signed char>(5, 12), 100);
+    EXPECT_EQ(cv::countNonZero(map.count), 2);
+}
@@ -0,0 +1,71 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/hole_filling.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::processing;
+using namespace vlue::disparity;
+
+static constexpr short INVALID = invalidDisparity();
+
+static cv::Mat rowOf(const std::vector<short> &values) {
+    cv::Mat row(1, static_cast<int>(values.size()), CV_16SC1);
+    for (int x = 0; x < row.cols; ++x) {
+        row.at<short>(0, x) = values[x];
+    }
+    return row;
+}
+
+static std::vector<short> fill(const HoleFillingPipeline &filler, const std::vector<short> &values) {
+    const cv::Mat filled = filler.apply(rowOf(values), cv::Mat(), cv::Mat(), cv::Mat());
+    return {filled.ptr<short>(0), filled.ptr<short>(0) + filled.cols};
+}
+
+TEST(HoleFillingPipelineTest, BackgroundTakesTheFartherSide) {
+    const HoleFillingPipeline filler(HoleFillingMode::Background);
+    EXPECT_EQ(fill(filler, {80, INVALID, INVALID, INVALID, 160}), (std::vector<short>{80, 80, 80, 80, 160}));
+    EXPECT_EQ(fill(filler, {160, INVALID, 80}), (std::vector<short>{160, 80, 80}));
+}
+
+TEST(HoleFillingPipelineTest, InterpolateBlendsBetweenTheEnds) {
+    const HoleFillingPipeline filler(HoleFillingMode::Interpolate);
+    EXPECT_EQ(fill(filler, {80, INVALID, INVALID, INVALID, 160}), (std::vector<short>{80, 100, 120, 140, 160}));
+    EXPECT_EQ(fill(filler, {160, INVALID, 80}), (std::vector<short>{160, 120, 80}));
+}
+
+TEST(HoleFillingPipelineTest, ExtendsRunsTouchingTheBorder) {
+    // With only one side known, both modes copy it.
+    for (const auto mode : {HoleFillingMode::Background, HoleFillingMode::Interpolate}) {
+        const HoleFillingPipeline filler(mode);
+        EXPECT_EQ(fill(filler, {INVALID, INVALID, 96, 112, INVALID}), (std::vector<short>{96, 96, 96, 112, 112}));
+        EXPECT_EQ(fill(filler, {INVALID, INVALID, INVALID}), (std::vector<short>{INVALID, INVALID, INVALID}));
+    }
+}
+
+TEST(HoleFillingPipelineTest, LeavesWideHolesInvalid) {
+    const HoleFillingPipeline filler(HoleFillingMode::Interpolate, 2);
+    EXPECT_EQ(fill(filler, {80, INVALID, INVALID, 80, INVALID, INVALID, INVALID, 80}),
+              (std::vector<short>{80, 80, 80, 80, INVALID, INVALID, INVALID, 80}));
+}
+
+TEST(HoleFillingPipelineTest, HonoursMinDisparityAndWorksInPlace) {
+    // With minDisparity -2, -16 is a valid disparity and only values below -32 are holes.
+    const short invalid = invalidDisparity(-2);
+    cv::Mat input = rowOf({-16, invalid, invalid, 16});
+    const cv::Mat output = HoleFillingPipeline(HoleFillingMode::Background, 0, -2).apply(input, cv::Mat(), cv::Mat(),
+                                                                                        cv::Mat());
+    EXPECT_EQ(output.data, input.data);
+    EXPECT_EQ(cv::countNonZero(output != rowOf({-16, -16, -16, 16})), 0);
+}
+
+TEST(HoleFillingPipelineTest, RejectsInvalidInput) {
+    EXPECT_THROW(HoleFillingPipeline(HoleFillingMode::Background, -1), std::invalid_argument);
+    EXPECT_THROW((void) HoleFillingPipeline().apply(cv::Mat(1, 4, CV_32FC1), cv::Mat(), cv::Mat(), cv::Mat()),
+                 std::invalid_argument);
+}
@@ -0,0 +1,54 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/lr_check.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::processing;
+using namespace vlue::disparity;
+
+static constexpr int ROWS = 4, COLS = 40;
+
+// Right map in the createRightMatcher convention for a scene at a constant disparity of `pixels`.
+static cv::Mat rightMapFor(int pixels) {
+    return {ROWS, COLS, CV_16SC1, cv::Scalar(-pixels * DISP_SCALE)};
+}
+
+TEST(DisparityLRCheckPipelineTest, LeavesInputUntouched) {
+    const cv::Mat left(ROWS, COLS, CV_16SC1, cv::Scalar(5 * DISP_SCALE));
+    const cv::Mat checked = DisparityLRCheckPipeline(1).apply(left, cv::Mat(), rightMapFor(7), cv::Mat());
+
+    EXPECT_EQ(cv::countNonZero(left != 5 * DISP_SCALE), 0);
+    EXPECT_EQ(checked.at<short>(0, 20), invalidDisparity());
+}
+
+TEST(DisparityLRCheckPipelineTest, KeepsPixelsTheRightMapAgreesWith) {
+    const cv::Mat left(ROWS, COLS, CV_16SC1, cv::Scalar(5 * DISP_SCALE));
+    cv::Mat right = rightMapFor(5);
+    right.at<short>(1, 20) = -9 * DISP_SCALE;
+    right.at<short>(2, 30) = -6 * DISP_SCALE + 8;
+
+    const cv::Mat checked = DisparityLRCheckPipeline(1).apply(left, cv::Mat(), right, cv::Mat());
+    for (int y = 0; y < ROWS; ++y) {
+        for (int x = 0; x < COLS; ++x) {
+            // Pixels landing left of the image have nothing to agree with.
+            const bool kept = x >= 5 && !(y == 1 && x == 25);
+            EXPECT_EQ(checked.at<short>(y, x), kept ? 5 * DISP_SCALE : invalidDisparity()) << y << "," << x;
+        }
+    }
+}
+
+TEST(DisparityLRCheckPipelineTest, RejectsUnmatchedRightPixels) {
+    // The right matcher for minDisparity 0 and 16 disparities marks unmatched pixels with -16 px, which is
+    // within one pixel of a left disparity of 15.
+    const int minDisparity = 0, numDisparities = 16;
+    const cv::Mat left(ROWS, COLS, CV_16SC1, cv::Scalar(15 * DISP_SCALE));
+    const cv::Mat right(ROWS, COLS, CV_16SC1, cv::Scalar((-(minDisparity + numDisparities - 1) - 1) * DISP_SCALE));
+
+    const cv::Mat checked = DisparityLRCheckPipeline(1, false, 2, minDisparity, numDisparities)
+                                .apply(left, cv::Mat(), right, cv::Mat());
+    EXPECT_EQ(cv::countNonZero(checked != invalidDisparity(minDisparity)), 0);
+}
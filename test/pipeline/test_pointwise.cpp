@@ -0,0 +1,126 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/pointwise.h"
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+using namespace vlue::processing;
+
+// Every stage on its own, storing the intermediate image in between.
+static cv::Mat runSequentially(const cv::Mat &src, const std::vector<std::shared_ptr<PointwisePipeline>> &stages) {
+    cv::Mat image = src;
+    for (const auto &stage : stages) {
+        image = stage->process(image);
+    }
+    return image;
+}
+
+static cv::Mat runFused(const cv::Mat &src, const std::vector<std::shared_ptr<PointwisePipeline>> &stages) {
+    return FusedPointwisePipeline(stages).process(src);
+}
+
+TEST(FusedPointwisePipelineTest, RoundsBetweenStagesLikeSeparateStages) {
+    const std::vector<std::shared_ptr<PointwisePipeline>> stages{
+        std::make_shared<ScalePipeline>(0.5), std::make_shared<ScalePipeline>(2.0)};
+    const cv::Mat src(1, 1, CV_16SC1, cv::Scalar(3));
+
+    // 3 * 0.5 is stored as 2 (round half to even) before it is doubled.
+    EXPECT_EQ(runSequentially(src, stages).at<short>(0, 0), 4);
+    EXPECT_EQ(runFused(src, stages).at<short>(0, 0), 4);
+}
+
+static int countMismatches(const cv::Mat &actual, const cv::Mat &expected) {
+    EXPECT_EQ(actual.type(), expected.type());
+    return cv::countNonZero((actual != expected).reshape(1));
+}
+
+TEST(PointwisePipelineTest, ScaleMatchesConvertTo) {
+    // Exact binary fractions, so the reference and the kernel cannot differ by float rounding.
+    const ScalePipeline scale(0.75, -2.5);
+    cv::RNG rng(3);
+    for (const int type : {CV_8UC1, CV_16SC1, CV_16UC3}) {
+        cv::Mat src(5, 300, type);
+        rng.fill(src, cv::RNG::UNIFORM, 0, 2000);
+        cv::Mat expected;
+        src.convertTo(expected, -1, 0.75, -2.5);
+        EXPECT_EQ(countMismatches(scale.process(src), expected), 0) << "type " << type;
+    }
+}
+
+TEST(PointwisePipelineTest, ConvertMatchesConvertTo) {
+    // Halfway values round to even, out-of-range values saturate.
+    const cv::Mat src = (cv::Mat_<float>(1, 10) << -40000.0f, -3.5f, -0.5f, 0.5f, 1.5f, 2.5f, 254.5f, 255.5f,
+                         300.0f, 40000.0f);
+    for (const int depth : {CV_8U, CV_8S, CV_16U, CV_16S}) {
+        cv::Mat expected;
+        src.convertTo(expected, depth);
+        EXPECT_EQ(countMismatches(ConvertPipeline(depth).process(src), expected), 0) << "depth " << depth;
+    }
+    const cv::Mat converted = ConvertPipeline(CV_8U).process(src);
+    EXPECT_EQ(converted.at<uchar>(0, 1), 0);
+    EXPECT_EQ(converted.at<uchar>(0, 4), 2);
+    EXPECT_EQ(converted.at<uchar>(0, 5), 2);
+    EXPECT_EQ(converted.at<uchar>(0, 6), 254);
+    EXPECT_EQ(converted.at<uchar>(0, 8), 255);
+}
+
+TEST(PointwisePipelineTest, ThresholdMatchesCvThreshold) {
+    const std::vector<std::pair<ThresholdMode, int>> modes{
+        {ThresholdMode::Binary, cv::THRESH_BINARY}, {ThresholdMode::BinaryInv, cv::THRESH_BINARY_INV},
+        {ThresholdMode::Trunc, cv::THRESH_TRUNC}, {ThresholdMode::ToZero, cv::THRESH_TOZERO},
+        {ThresholdMode::ToZeroInv, cv::THRESH_TOZERO_INV}};
+    cv::RNG rng(5);
+    for (const int type : {CV_8UC1, CV_16SC1, CV_32FC1}) {
+        cv::Mat src(5, 300, type);
+        rng.fill(src, cv::RNG::UNIFORM, 0, 250);
+        for (const auto &[mode, cvType] : modes) {
+            cv::Mat expected;
+            cv::threshold(src, expected, 100, 200, cvType);
+            EXPECT_EQ(countMismatches(ThresholdPipeline(100, 200, mode).process(src), expected), 0)
+                << "type " << type << " mode " << cvType;
+        }
+    }
+}
+
+TEST(PointwisePipelineTest, ClampMatchesHandComputedValues) {
+    const cv::Mat src = (cv::Mat_<short>(1, 7) << -32768, -101, -100, 0, 900, 901, 32767);
+    const cv::Mat expected = (cv::Mat_<short>(1, 7) << -100, -100, -100, 0, 900, 900, 900);
+    EXPECT_EQ(countMismatches(ClampPipeline(-100, 900).process(src), expected), 0);
+}
+
+TEST(FusedPointwisePipelineTest, MatchesSequentialResults) {
+    const std::vector<std::vector<std::shared_ptr<PointwisePipeline>>> chains{
+        {std::make_shared<ScalePipeline>(0.3, 1.7), std::make_shared<ClampPipeline>(-100, 900),
+         std::make_shared<ScalePipeline>(3.1)},
+        {std::make_shared<ScalePipeline>(1.0 / 16), std::make_shared<ConvertPipeline>(CV_8U),
+         std::make_shared<ThresholdPipeline>(20, 255, ThresholdMode::ToZero)},
+        {std::make_shared<ConvertPipeline>(CV_32F), std::make_shared<ScalePipeline>(0.1),
+         std::make_shared<ScalePipeline>(10.0, 0.5)},
+    };
+    cv::RNG rng(7);
+    for (const int type : {CV_8UC1, CV_16SC1, CV_16UC3, CV_32FC1}) {
+        // Wider than one tile so tile boundaries are crossed.
+        cv::Mat src(9, 700, type);
+        rng.fill(src, cv::RNG::UNIFORM, 0, 2000);
+        for (const auto &chain : chains) {
+            const cv::Mat expected = runSequentially(src, chain);
+            const cv::Mat fused = runFused(src, chain);
+            ASSERT_EQ(fused.type(), expected.type());
+            EXPECT_EQ(cv::countNonZero((fused != expected).reshape(1)), 0) << "type " << type;
+        }
+    }
+}
+
+TEST(FusedPointwisePipelineTest, RejectsDepthsFloatCannotHold) {
+    const ScalePipeline scale(2.0);
+    EXPECT_THROW(scale.process(cv::Mat(2, 2, CV_32SC1, cv::Scalar(1))), std::invalid_argument);
+    EXPECT_THROW(scale.process(cv::Mat(2, 2, CV_64FC1, cv::Scalar(1))), std::invalid_argument);
+    EXPECT_THROW(ConvertPipeline(CV_64F), std::invalid_argument);
+}
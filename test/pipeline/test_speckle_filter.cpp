@@ -0,0 +1,116 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/speckle_filter.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::processing;
+using namespace vlue::disparity;
+
+// Tall enough that the image is cut into many stripes, whatever the thread count.
+static constexpr int ROWS = 96, COLS = 32;
+
+static cv::Mat emptyMap() {
+    return {ROWS, COLS, CV_16SC1, cv::Scalar(invalidDisparity())};
+}
+
+static int validCount(const cv::Mat &disparity) {
+    return cv::countNonZero(disparity != invalidDisparity());
+}
+
+TEST(SpeckleFilterPipelineTest, RemovesBlobsBelowTheSizeLimit) {
+    // Blob of exactly 12 pixels: removed below a limit of 13, kept at 12.
+    cv::Mat input = emptyMap();
+    input(cv::Rect(4, 4, 4, 3)).setTo(cv::Scalar(9 * DISP_SCALE));
+
+    cv::Mat below = input.clone();
+    (void) SpeckleFilterPipeline(13, 1).apply(below, cv::Mat(), cv::Mat(), cv::Mat());
+    EXPECT_EQ(validCount(below), 0);
+
+    cv::Mat at = input.clone();
+    (void) SpeckleFilterPipeline(12, 1).apply(at, cv::Mat(), cv::Mat(), cv::Mat());
+    EXPECT_EQ(validCount(at), 12);
+    EXPECT_EQ(cv::countNonZero(at != input), 0);
+}
+
+TEST(SpeckleFilterPipelineTest, SplitsBlobsAtDisparityJumps) {
+    // Two 3x4 halves two pixels apart in disparity: one blob with speckleRange 2, two speckles with 1.
+    cv::Mat input = emptyMap();
+    input(cv::Rect(4, 4, 3, 4)).setTo(cv::Scalar(9 * DISP_SCALE));
+    input(cv::Rect(7, 4, 3, 4)).setTo(cv::Scalar(11 * DISP_SCALE));
+
+    cv::Mat joined = input.clone();
+    (void) SpeckleFilterPipeline(24, 2).apply(joined, cv::Mat(), cv::Mat(), cv::Mat());
+    EXPECT_EQ(validCount(joined), 24);
+
+    cv::Mat split = input.clone();
+    (void) SpeckleFilterPipeline(24, 1).apply(split, cv::Mat(), cv::Mat(), cv::Mat());
+    EXPECT_EQ(validCount(split), 0);
+}
+
+TEST(SpeckleFilterPipelineTest, CountsBlobsAcrossStripeSeams) {
+    // A U shape: two one-pixel arms spanning most of the image, joined only along the bottom row. Each arm on its
+    // own is smaller than the limit; their labels have to be merged across every stripe seam they cross.
+    cv::Mat input = emptyMap();
+    const int top = 2, bottom = ROWS - 3, armLength = bottom - top + 1;
+    input(cv::Rect(5, top, 1, armLength)).setTo(cv::Scalar(6 * DISP_SCALE));
+    input(cv::Rect(20, top, 1, armLength)).setTo(cv::Scalar(6 * DISP_SCALE));
+    input(cv::Rect(6, bottom, 14, 1)).setTo(cv::Scalar(6 * DISP_SCALE));
+    const int blobSize = 2 * armLength + 14;
+
+    cv::Mat kept = input.clone();
+    (void) SpeckleFilterPipeline(blobSize, 1).apply(kept, cv::Mat(), cv::Mat(), cv::Mat());
+    EXPECT_EQ(validCount(kept), blobSize);
+
+    cv::Mat removed = input.clone();
+    (void) SpeckleFilterPipeline(blobSize + 1, 1).apply(removed, cv::Mat(), cv::Mat(), cv::Mat());
+    EXPECT_EQ(validCount(removed), 0);
+}
+
+TEST(SpeckleFilterPipelineTest, WorksInPlaceAndReusesBuffers) {
+    const SpeckleFilterPipeline filter(5, 1);
+    for (const int cols : {COLS, 2 * COLS, COLS}) {
+        cv::Mat input(ROWS, cols, CV_16SC1, cv::Scalar(invalidDisparity()));
+        input(cv::Rect(1, 1, 2, 2)).setTo(cv::Scalar(3 * DISP_SCALE));
+        input(cv::Rect(cols - 4, 10, 3, 3)).setTo(cv::Scalar(3 * DISP_SCALE));
+
+        const cv::Mat output = filter.apply(input, cv::Mat(), cv::Mat(), cv::Mat());
+        EXPECT_EQ(output.data, input.data);
+        EXPECT_EQ(validCount(output), 9) << cols;
+    }
+}
+
+TEST(SpeckleFilterPipelineTest, SharedStageRunsConcurrently) {
+    const SpeckleFilterPipeline filter(13, 1);
+    std::vector<std::thread> threads;
+    std::vector<int> counts(4, -1);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&filter, &counts, t] {
+            for (int i = 0; i < 20; ++i) {
+                cv::Mat input = emptyMap();
+                input(cv::Rect(4, 4, 4, 3)).setTo(cv::Scalar(9 * DISP_SCALE));
+                input(cv::Rect(10, 40, 5, 5)).setTo(cv::Scalar(9 * DISP_SCALE));
+                (void) filter.apply(input, cv::Mat(), cv::Mat(), cv::Mat());
+                counts[t] = validCount(input);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counts, std::vector<int>(4, 25));
+}
+
+TEST(SpeckleFilterPipelineTest, RejectsInvalidInput) {
+    EXPECT_THROW(SpeckleFilterPipeline(-1, 1), std::invalid_argument);
+    EXPECT_THROW(SpeckleFilterPipeline(10, -1), std::invalid_argument);
+    EXPECT_THROW((void) SpeckleFilterPipeline(10, 1).apply(cv::Mat(ROWS, COLS, CV_32FC1), cv::Mat(), cv::Mat(),
+                                                           cv::Mat()),
+                 std::invalid_argument);
+}
@@ -0,0 +1,70 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/static_pipeline.h"
+
+#include <mutex>
+#include <string>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::processing;
+
+namespace {
+    // Adds `delta` and logs `tag` once per tile, so the log shows how stages interleave.
+    class TaggedOffset : public PointwisePipeline {
+        char m_Tag;
+        float m_Delta;
+        std::string *m_Log;
+        std::mutex *m_Mutex;
+
+    public:
+        TaggedOffset(char tag, float delta, std::string &log, std::mutex &mutex)
+            : m_Tag(tag), m_Delta(delta), m_Log(&log), m_Mutex(&mutex) {}
+
+        void apply(float *data, int count) const override {
+            for (int i = 0; i < count; ++i) {
+                data[i] += m_Delta;
+            }
+            std::lock_guard<std::mutex> lock(*m_Mutex);
+            m_Log->push_back(m_Tag);
+        }
+    };
+
+    // A disparity stage that splits the pointwise runs around it.
+    struct Double {
+        [[nodiscard]] bool isEnabled() const { return true; }
+        [[nodiscard]] cv::Mat apply(const cv::Mat &leftDisparity, const cv::Mat &, const cv::Mat &,
+                                    const cv::Mat &) const {
+            cv::Mat out;
+            leftDisparity.convertTo(out, -1, 2.0);
+            return out;
+        }
+    };
+}
+
+TEST(StaticDisparityPipelineTest, FusesConsecutivePointwiseStages) {
+    std::string log;
+    std::mutex mutex;
+    const StaticDisparityPipeline post{TaggedOffset('a', 1, log, mutex), TaggedOffset('b', 2, log, mutex),
+                                       Double(), TaggedOffset('c', 3, log, mutex)};
+
+    // One row spanning three tiles keeps the log in a single, deterministic order.
+    cv::Mat disparity(1, 3 * 1024, CV_32FC1, cv::Scalar(1));
+    const cv::Mat none;
+    post(disparity, none, none, none);
+
+    EXPECT_EQ(log, "ababab" "ccc");
+    EXPECT_EQ(cv::countNonZero(disparity != (1 + 1 + 2) * 2 + 3), 0);
+}
+
+TEST(StaticDisparityPipelineTest, FusedRunMatchesStagesOneByOne) {
+    const StaticDisparityPipeline post{ScalePipeline(0.5), ScalePipeline(2.0), ClampPipeline(0, 100)};
+    cv::Mat disparity(4, 8, CV_16SC1);
+    cv::RNG(3).fill(disparity, cv::RNG::UNIFORM, -50, 200);
+
+    const cv::Mat expected = post.get<2>().process(post.get<1>().process(post.get<0>().process(disparity)));
+    const cv::Mat none;
+    post(disparity, none, none, none);
+    EXPECT_EQ(cv::countNonZero(disparity != expected), 0);
+}
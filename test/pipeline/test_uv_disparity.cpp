@@ -0,0 +1,65 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/pipeline/uv_disparity.h"
+#include "vision/disparity/disparity_format.h"
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::processing;
+using namespace vlue::disparity;
+
+// Sky above row 40, then ground at disparity (v - 40) / 2, i.e. the line v = 2d + 40 (41 on odd rows). A box
+// at disparity 30 covers columns 70..79 of rows 60..99 and stands on the ground at row 100.
+static cv::Mat makeScene() {
+    cv::Mat disparity(120, 160, CV_16SC1, cv::Scalar(invalidDisparity()));
+    for (int v = 40; v < disparity.rows; ++v) {
+        disparity.row(v).setTo(cv::Scalar((v - 40) / 2 * DISP_SCALE));
+    }
+    disparity(cv::Rect(70, 60, 10, 40)).setTo(cv::Scalar(30 * DISP_SCALE));
+    return disparity;
+}
+
+TEST(UVDisparityPipelineTest, RecoversGroundLineAndObstacle) {
+    UVDisparityPipeline::Parameters params;
+    const UVDisparitySummary summary = UVDisparityPipeline::analyze(makeScene(), params);
+
+    ASSERT_TRUE(summary.hasGround);
+    EXPECT_NEAR(summary.groundSlope, 2.0, 0.05);
+    EXPECT_NEAR(summary.groundIntercept, 40.5, 1.0);
+
+    // Ground pixels lie on the line and must not show up as obstacles.
+    ASSERT_EQ(summary.obstacles.size(), 10u);
+    for (size_t i = 0; i < summary.obstacles.size(); ++i) {
+        const ObstacleColumn &column = summary.obstacles[i];
+        EXPECT_EQ(column.u, 70 + static_cast<int>(i));
+        EXPECT_EQ(column.disparity, 30);
+        EXPECT_EQ(column.top, 60);
+        // Its last rows are within the tolerance of the ground line and count as ground.
+        EXPECT_NEAR(column.bottom, 98, 1);
+        EXPECT_EQ(column.count, column.bottom - column.top + 1);
+    }
+    EXPECT_TRUE(summary.vDisparity.empty());
+}
+
+TEST(UVDisparityPipelineTest, ReportsToCallbackAndReturnsInput) {
+    UVDisparityPipeline::Parameters params;
+    params.keepHistograms = true;
+    int calls = 0;
+    UVDisparitySummary reported;
+    const UVDisparityPipeline stage(params, [&](const UVDisparitySummary &summary) {
+        ++calls;
+        reported = summary;
+    });
+
+    const cv::Mat disparity = makeScene();
+    const cv::Mat output = stage.apply(disparity, cv::Mat(), cv::Mat(), cv::Mat());
+    EXPECT_EQ(output.data, disparity.data);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(reported.obstacles.size(), 10u);
+    ASSERT_EQ(reported.vDisparity.size(), cv::Size(params.numDisparities, disparity.rows));
+    // Row 100, just below the box, is ground at disparity 30 across the whole width.
+    EXPECT_EQ(reported.vDisparity.at<int>(100, 30), 160);
+    EXPECT_EQ(reported.uDisparity.at<int>(30, 75), reported.obstacles[5].count);
+}
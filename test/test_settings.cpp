@@ -3,6 +3,7 @@
 //
 #include <gtest/gtest.h>
 #include "settings/settings.h"
+#include <yaml-cpp/yaml.h>
 #include <iostream>
 
 using namespace vlue::settings;
@@ -26,3 +27,44 @@ TEST_F(SettingsTest, YAMLFileConstructor) {
     const AppConfig app_config{settings_file};
     std::cout << app_config << std::endl;
 }
+
+TEST_F(SettingsTest, CameraAndLoggingSections) {
+    const AppConfig app_config{YAML::Load(R"(
+camera:
+  config: stereo.yaml
+  settings: {exposure: manual}
+)")};
+    const auto &camera = app_config.getCameraConfig();
+    EXPECT_EQ(camera.config_path, "stereo.yaml");
+    EXPECT_EQ(camera.settings.exposure, "manual");
+    EXPECT_EQ(camera.settings.white_balance, "auto");
+    EXPECT_EQ(app_config.getLoggingConfig().level, "info");
+
+    const AppConfig empty{YAML::Load("capture: {}")};
+    EXPECT_TRUE(empty.getCameraConfig().config_path.empty());
+    EXPECT_EQ(empty.getCameraConfig().settings.exposure, "auto");
+    EXPECT_TRUE(empty.getLoggingConfig().file.empty());
+}
+
+TEST_F(SettingsTest, SchedulingSection) {
+    const YAML::Node config = YAML::Load(R"(
+scheduling:
+  numa_local: true
+  capture:
+    cpus: "0-2,5"
+    priority: 40
+  matcher:
+    cpus: [7, 6, 6]
+)");
+    const AppConfig app_config{config};
+    const auto &scheduling = app_config.getSchedulingConfig();
+    EXPECT_TRUE(scheduling.enable);
+    EXPECT_TRUE(scheduling.numa_local);
+    EXPECT_EQ(scheduling.capture.cpus, (std::vector<int>{0, 1, 2, 5}));
+    EXPECT_EQ(scheduling.capture.priority, 40);
+    EXPECT_EQ(scheduling.matcher.cpus, (std::vector<int>{6, 7}));
+    EXPECT_TRUE(scheduling.sink.cpus.empty());
+    EXPECT_FALSE(AppConfig{}.getSchedulingConfig().enable);
+
+    EXPECT_THROW(AppConfig{YAML::Load("scheduling: {capture: {cpus: \"3-1\"}}")}, std::invalid_argument);
+}
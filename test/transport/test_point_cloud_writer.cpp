@@ -0,0 +1,156 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/transport/point_cloud_writer.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::transport;
+
+static std::string prefix(const char *suffix) {
+    return ::testing::TempDir() + "vlue_cloud_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+static std::string readFile(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+// 4x3 cloud with two missing points: one at reprojectImageTo3D's "far away" depth, one NaN.
+static cv::Mat makeCloud(float offset) {
+    cv::Mat points(3, 4, CV_32FC3);
+    for (int y = 0; y < points.rows; ++y) {
+        for (int x = 0; x < points.cols; ++x) {
+            points.at<cv::Vec3f>(y, x) = cv::Vec3f(float(x) + offset, float(y), 2.0f);
+        }
+    }
+    points.at<cv::Vec3f>(0, 1)[2] = 10000.0f;
+    points.at<cv::Vec3f>(2, 3)[0] = std::numeric_limits<float>::quiet_NaN();
+    return points;
+}
+
+TEST(PointCloudWriter, WritesOneBinaryPlyPerFrame) {
+    const auto base = prefix("ply");
+    {
+        PointCloudWriter writer(base, PointCloudWriter::Options{});
+        cv::Mat colors(3, 4, CV_8UC3, cv::Scalar(10, 20, 30));
+        ASSERT_TRUE(writer.write(makeCloud(0.0f), colors, 7));
+        writer.flush();
+        EXPECT_EQ(writer.getWritten(), 1u);
+    }
+
+    const auto path = base + "_000007.ply";
+    const auto content = readFile(path);
+    const auto header = PointCloudWriter::header(CloudFormat::PLY, 10, true);
+    ASSERT_EQ(content.size(), header.size() + 10 * PointCloudWriter::pointSize(CloudFormat::PLY, true));
+    EXPECT_EQ(content.compare(0, header.size(), header), 0);
+
+    // First point is (0, 0, 2) coloured (R, G, B) = (30, 20, 10); (1, 0) was skipped, so the second is (2, 0, 2).
+    float xyz[3];
+    std::memcpy(xyz, content.data() + header.size(), sizeof(xyz));
+    EXPECT_EQ(xyz[2], 2.0f);
+    EXPECT_EQ(static_cast<unsigned char>(content[header.size() + 12]), 30);
+    EXPECT_EQ(static_cast<unsigned char>(content[header.size() + 14]), 10);
+    std::memcpy(xyz, content.data() + header.size() + 15, sizeof(xyz));
+    EXPECT_EQ(xyz[0], 2.0f);
+    std::remove(path.c_str());
+}
+
+TEST(PointCloudWriter, AppendsAndRollsSequenceParts) {
+    const auto base = prefix("seq");
+    PointCloudWriter::Options options;
+    options.format = CloudFormat::PCD;
+    options.mode = PointCloudWriter::Mode::Sequence;
+    options.preallocate = 4096;
+    const auto header = PointCloudWriter::header(CloudFormat::PCD, 10, false);
+    const std::size_t cloudBytes = header.size() + 10 * PointCloudWriter::pointSize(CloudFormat::PCD, false);
+    options.rollBytes = 2 * cloudBytes;
+    options.blockWhenFull = true;
+    {
+        PointCloudWriter writer(base, options);
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_TRUE(writer.write(makeCloud(float(i))));
+        }
+    }
+
+    // Two clouds fit in a part, trimmed to their exact size; the third starts the next part.
+    const auto first = readFile(base + "_part000.pcd");
+    const auto second = readFile(base + "_part001.pcd");
+    ASSERT_EQ(first.size(), 2 * cloudBytes);
+    ASSERT_EQ(second.size(), cloudBytes);
+    EXPECT_EQ(first.compare(cloudBytes, header.size(), header), 0);
+    float x;
+    std::memcpy(&x, second.data() + header.size(), sizeof(x));
+    EXPECT_EQ(x, 2.0f);
+    std::remove((base + "_part000.pcd").c_str());
+    std::remove((base + "_part001.pcd").c_str());
+}
+
+TEST(PointCloudWriter, DropsWhenTheQueueIsFull) {
+    PointCloudWriter::Options options;
+    options.queueFrames = 1;
+    const auto base = prefix("drop");
+    PointCloudWriter writer(base, options);
+    const cv::Mat cloud = makeCloud(0.0f);
+    int accepted = 0;
+    for (int i = 0; i < 50; ++i) {
+        accepted += writer.write(cloud, cv::Mat(), i);
+    }
+    writer.flush();
+    EXPECT_EQ(writer.getWritten() + writer.getDropped(), 50u);
+    EXPECT_EQ(writer.getWritten(), static_cast<uint64_t>(accepted));
+    for (int i = 0; i < 50; ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "_%06d.ply", i);
+        std::remove((base + name).c_str());
+    }
+}
+
+TEST(PointCloudWriter, RecoversWhenGrowingAPartFails) {
+    const auto base = prefix("grow");
+    PointCloudWriter::Options options;
+    options.format = CloudFormat::PCD;
+    options.mode = PointCloudWriter::Mode::Sequence;
+    options.preallocate = 4096;
+    options.blockWhenFull = true;
+    const auto header = PointCloudWriter::header(CloudFormat::PCD, 10, false);
+    const std::size_t cloudBytes = header.size() + 10 * PointCloudWriter::pointSize(CloudFormat::PCD, false);
+
+    // A file size limit stands in for a full disk while the part has to grow past its first step.
+    cv::Mat large(64, 64, CV_32FC3, cv::Scalar(1.0, 1.0, 2.0));
+    rlimit saved{};
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &saved), 0);
+    const auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+    {
+        PointCloudWriter writer(base, options);
+        ASSERT_TRUE(writer.write(makeCloud(0.0f)));
+        writer.flush();
+
+        rlimit limited = saved;
+        limited.rlim_cur = 8192;
+        ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limited), 0);
+        ASSERT_TRUE(writer.write(large));
+        writer.flush();
+        ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &saved), 0);
+        EXPECT_EQ(writer.getFailed(), 1u);
+
+        // Fits the capacity the part had before the failed grow; must remap instead of writing through it.
+        ASSERT_TRUE(writer.write(makeCloud(1.0f)));
+        writer.flush();
+        EXPECT_EQ(writer.getWritten(), 2u);
+    }
+    std::signal(SIGXFSZ, previousHandler);
+
+    EXPECT_EQ(readFile(base + "_part000.pcd").size(), 2 * cloudBytes);
+    std::remove((base + "_part000.pcd").c_str());
+}
@@ -0,0 +1,88 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+#include "vision/transport/shm_ring.h"
+
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+
+using namespace vlue::transport;
+
+static std::string segmentName(const char *suffix) {
+    return "/vlue_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+static cv::Mat makeFrame(int seed) {
+    cv::Mat frame(24, 32, CV_16SC1);
+    cv::RNG rng(seed);
+    rng.fill(frame, cv::RNG::UNIFORM, -100, 1000);
+    return frame;
+}
+
+TEST(ShmRing, FansOutToSeveralSubscribers) {
+    const auto name = segmentName("fanout");
+    ShmPublisher publisher(name, 32 * 24 * 2, 4);
+    ShmSubscriber first(name), second(name);
+
+    const cv::Mat frame = makeFrame(1);
+    EXPECT_EQ(publisher.publish(frame, PayloadKind::Disparity, 42, 1234), 0u);
+
+    for (auto *subscriber : {&first, &second}) {
+        ShmMessage message;
+        ASSERT_TRUE(subscriber->next(message));
+        EXPECT_EQ(message.info.kind, PayloadKind::Disparity);
+        EXPECT_EQ(message.info.frameSequence, 42u);
+        EXPECT_EQ(message.info.timestamp, 1234);
+        ASSERT_EQ(message.data.type(), CV_16SC1);
+        EXPECT_EQ(cv::countNonZero(message.data != frame), 0);
+        EXPECT_TRUE(message.valid());
+        EXPECT_FALSE(subscriber->next(message, std::chrono::milliseconds(5)));
+    }
+}
+
+TEST(ShmRing, ZeroCopyWriteIsVisibleAfterCommit) {
+    const auto name = segmentName("inplace");
+    ShmPublisher publisher(name, 1024, 2);
+    ShmSubscriber subscriber(name);
+
+    cv::Mat view = publisher.beginWrite(4, 8, CV_32FC3);
+    view.setTo(cv::Scalar(1.0, 2.0, 3.0));
+    ShmMessage message;
+    EXPECT_FALSE(subscriber.next(message, std::chrono::milliseconds(5)));
+
+    publisher.commit(PayloadKind::PointCloud);
+    ASSERT_TRUE(subscriber.next(message));
+    EXPECT_EQ(message.info.kind, PayloadKind::PointCloud);
+    EXPECT_EQ(message.data.at<cv::Vec3f>(3, 7), cv::Vec3f(1.0f, 2.0f, 3.0f));
+}
+
+TEST(ShmRing, DetectsOverwrites) {
+    const auto name = segmentName("overwrite");
+    ShmPublisher publisher(name, 32 * 24 * 2, 2);
+    ShmSubscriber subscriber(name);
+
+    publisher.publish(makeFrame(0), PayloadKind::Disparity, 0);
+    ShmMessage held;
+    ASSERT_TRUE(subscriber.next(held));
+    EXPECT_TRUE(held.valid());
+
+    // Lap the subscriber: message 0's slot is reused and messages 1 and 2 are gone by the time it reads.
+    for (uint64_t i = 1; i <= 4; ++i) {
+        publisher.publish(makeFrame(int(i)), PayloadKind::Disparity, i);
+    }
+    EXPECT_FALSE(held.valid());
+
+    ShmMessage message;
+    ASSERT_TRUE(subscriber.next(message));
+    EXPECT_EQ(message.info.frameSequence, 3u);
+    EXPECT_EQ(subscriber.getDropped(), 2u);
+    EXPECT_EQ(cv::countNonZero(message.data != makeFrame(3)), 0);
+}
+
+TEST(ShmRing, RejectsOversizedMessages) {
+    ShmPublisher publisher(segmentName("oversized"), 16, 2);
+    EXPECT_THROW(publisher.publish(makeFrame(0), PayloadKind::Disparity), std::invalid_argument);
+    EXPECT_THROW(ShmSubscriber(segmentName("missing")), std::runtime_error);
+}
@@ -0,0 +1,362 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+// Runs a configured matcher and post-processing chain over a Middlebury, KITTI or recorded dataset and reports
+// accuracy next to per-stage timing, so speed work can be checked against quality.
+//
+//     stereo_vision_eval <dataset> --config disparity.yaml --output results.json --tag $(git rev-parse --short HEAD)
+//
+#include "vision/disparity/sgbm.h"
+#include "vision/evaluation/dataset.h"
+#include "vision/evaluation/metrics.h"
+#include "vision/pipeline/pipeline.h"
+#include "vision/pipeline/pipeline_factory.h"
+#include "vision/pipeline/pointwise.h"
+#include "vision/helpers/yaml.h"
+#include "tool_helpers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <opencv2/core.hpp>
+
+using namespace vlue;
+using disparity::StereoSGBM;
+using processing::PipelinePtr;
+using processing::PipelineType;
+using tools::median;
+
+namespace {
+    struct Stage {
+        std::string name;
+        PipelinePtr pipeline;
+    };
+
+    struct SampleResult {
+        std::string name;
+        int width{0}, height{0};
+        evaluation::DisparityMetrics metrics;
+        std::vector<double> badRates;
+        // Median milliseconds: "match" first, then one entry per post-processing stage.
+        std::vector<double> stageMs;
+        double totalMs{0.0};
+    };
+
+    evaluation::DatasetLayout parseLayout(const std::string &layout) {
+        if (layout == "auto") return evaluation::DatasetLayout::Auto;
+        if (layout == "directory") return evaluation::DatasetLayout::Directory;
+        if (layout == "middlebury") return evaluation::DatasetLayout::Middlebury;
+        if (layout == "kitti") return evaluation::DatasetLayout::Kitti;
+        throw std::invalid_argument("Unknown dataset layout: " + layout);
+    }
+
+    StereoSGBM::Parameters defaultParameters(int channels) {
+        StereoSGBM::Parameters params;
+        params.numDisparities = 128;
+        params.blockSize = 5;
+        params.P1 = 8 * channels * params.blockSize * params.blockSize;
+        params.P2 = 32 * channels * params.blockSize * params.blockSize;
+        params.disp12MaxDiff = 1;
+        params.preFilterCap = 63;
+        params.uniquenessRatio = 10;
+        params.mode = StereoSGBM::MODE_SGBM_3WAY;
+        return params;
+    }
+
+    std::string jsonString(const std::string &text) {
+        std::ostringstream out;
+        out << '"';
+        for (const char c : text) {
+            switch (c) {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                            << std::dec << std::setfill(' ');
+                    } else {
+                        out << c;
+                    }
+            }
+        }
+        out << '"';
+        return out.str();
+    }
+
+    std::string jsonNumber(double value) {
+        if (!std::isfinite(value)) {
+            return "null";
+        }
+        std::ostringstream out;
+        out << std::setprecision(6) << value;
+        return out.str();
+    }
+
+    std::string thresholdKey(double threshold) {
+        std::ostringstream out;
+        out << "bad_" << threshold;
+        return out.str();
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Same dispatch as StereoSGBM::postprocess, unrolled here so every stage can be timed on its own.
+    void runStage(const Stage &stage, cv::Mat &leftDisparity, const cv::Mat &left, const cv::Mat &rightDisparity,
+                  const cv::Mat &right) {
+        if (stage.pipeline->getType() == PipelineType::Pointwise) {
+            leftDisparity = stage.pipeline->process(leftDisparity);
+        } else if (auto filter = std::dynamic_pointer_cast<processing::DisparityFilterPipeline>(stage.pipeline)) {
+            leftDisparity = filter->process(leftDisparity, left, rightDisparity, right);
+        } else {
+            throw std::invalid_argument("Stage '" + stage.name + "' cannot run on disparity maps.");
+        }
+    }
+
+    SampleResult evaluateSample(const evaluation::StereoSample &sample, const StereoSGBM &matcher,
+                                const std::vector<Stage> &stages, const std::vector<double> &thresholds,
+                                int warmup, int repeats) {
+        const int minDisparity = matcher.getParameters().minDisparity;
+        const int numDisparities = matcher.getParameters().numDisparities;
+        std::vector<std::vector<double>> times(stages.size() + 1);
+        cv::Mat leftDisparity, rightDisparity;
+
+        for (int r = 0; r < warmup + repeats; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            matcher.computeDisparity(sample.left, sample.right, leftDisparity, rightDisparity);
+            const double matchMs = elapsedMs(start);
+            if (r >= warmup) {
+                times[0].push_back(matchMs);
+            }
+            for (std::size_t i = 0; i < stages.size(); ++i) {
+                start = std::chrono::steady_clock::now();
+                runStage(stages[i], leftDisparity, sample.left, rightDisparity, sample.right);
+                const double stageMs = elapsedMs(start);
+                if (r >= warmup) {
+                    times[i + 1].push_back(stageMs);
+                }
+            }
+        }
+
+        if (leftDisparity.type() != CV_16SC1) {
+            throw std::invalid_argument("The post-processing chain must leave a CV_16SC1 disparity map.");
+        }
+
+        SampleResult result;
+        result.name = sample.name;
+        result.width = sample.left.cols;
+        result.height = sample.left.rows;
+        result.metrics = evaluation::evaluateDisparity(leftDisparity, rightDisparity, sample.groundTruth, minDisparity,
+                                                       numDisparities);
+        if (!sample.groundTruth.empty()) {
+            result.badRates = evaluation::badPixelRates(leftDisparity, sample.groundTruth, thresholds, minDisparity);
+        }
+        for (const auto &stageTimes : times) {
+            result.stageMs.push_back(median(stageTimes));
+            result.totalMs += result.stageMs.back();
+        }
+        return result;
+    }
+
+    void writeJson(std::ostream &out, const std::string &tag, const std::string &datasetPath,
+                   const std::string &configPath, const std::vector<double> &thresholds,
+                   const std::vector<std::string> &stageNames, const std::vector<SampleResult> &results) {
+        const std::time_t now = std::time(nullptr);
+        char timestamp[32];
+        std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        auto writeStages = [&](const std::vector<double> &stageMs) {
+            out << '{';
+            for (std::size_t i = 0; i < stageNames.size(); ++i) {
+                out << (i ? ", " : "") << jsonString(stageNames[i]) << ": " << jsonNumber(stageMs[i]);
+            }
+            out << '}';
+        };
+        auto writeBadRates = [&](const std::vector<double> &rates) {
+            for (std::size_t i = 0; i < rates.size(); ++i) {
+                out << ", " << jsonString(thresholdKey(thresholds[i])) << ": " << jsonNumber(rates[i]);
+            }
+        };
+
+        // Means over every sample; accuracy means only over samples with ground truth.
+        std::vector<double> meanStageMs(stageNames.size(), 0.0), meanBad(thresholds.size(), 0.0);
+        double density = 0.0, lr = 0.0, epe = 0.0, total = 0.0;
+        int withGroundTruth = 0;
+        for (const auto &r : results) {
+            for (std::size_t i = 0; i < stageNames.size(); ++i) {
+                meanStageMs[i] += r.stageMs[i] / results.size();
+            }
+            density += r.metrics.density / results.size();
+            lr += r.metrics.lrConsistency / results.size();
+            total += r.totalMs / results.size();
+            if (r.metrics.hasGroundTruth) {
+                ++withGroundTruth;
+                epe += r.metrics.endPointError;
+                for (std::size_t i = 0; i < thresholds.size(); ++i) {
+                    meanBad[i] += r.badRates[i];
+                }
+            }
+        }
+
+        out << "{\n";
+        out << "  \"tag\": " << jsonString(tag) << ",\n";
+        out << "  \"timestamp\": " << jsonString(timestamp) << ",\n";
+        out << "  \"dataset\": " << jsonString(datasetPath) << ",\n";
+        out << "  \"config\": " << jsonString(configPath) << ",\n";
+        out << "  \"threads\": " << cv::getNumThreads() << ",\n";
+        out << "  \"summary\": {\"samples\": " << results.size() << ", \"with_ground_truth\": " << withGroundTruth
+            << ", \"density\": " << jsonNumber(density) << ", \"lr_consistency\": " << jsonNumber(lr);
+        if (withGroundTruth > 0) {
+            out << ", \"epe\": " << jsonNumber(epe / withGroundTruth);
+            for (auto &bad : meanBad) {
+                bad /= withGroundTruth;
+            }
+            writeBadRates(meanBad);
+        }
+        out << ", \"total_ms\": " << jsonNumber(total) << ", \"fps\": " << jsonNumber(total > 0 ? 1000.0 / total : 0.0)
+            << ", \"stage_ms\": ";
+        writeStages(meanStageMs);
+        out << "},\n";
+
+        out << "  \"samples\": [\n";
+        for (std::size_t s = 0; s < results.size(); ++s) {
+            const auto &r = results[s];
+            out << "    {\"name\": " << jsonString(r.name) << ", \"width\": " << r.width << ", \"height\": " << r.height
+                << ", \"density\": " << jsonNumber(r.metrics.density)
+                << ", \"lr_consistency\": " << jsonNumber(r.metrics.lrConsistency);
+            if (r.metrics.hasGroundTruth) {
+                out << ", \"epe\": " << jsonNumber(r.metrics.endPointError);
+                writeBadRates(r.badRates);
+            }
+            out << ", \"total_ms\": " << jsonNumber(r.totalMs) << ", \"stage_ms\": ";
+            writeStages(r.stageMs);
+            out << '}' << (s + 1 < results.size() ? "," : "") << '\n';
+        }
+        out << "  ]\n}\n";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    argparse::ArgumentParser program("stereo_vision_eval");
+    program.add_argument("dataset").help("dataset root");
+    program.add_argument("--layout").default_value(std::string("auto"))
+           .help("auto, directory, middlebury or kitti");
+    program.add_argument("-c", "--config").default_value(std::string(""))
+           .help("disparity YAML with matcher parameters and an optional postprocess chain");
+    program.add_argument("-o", "--output").default_value(std::string(""))
+           .help("JSON results file; stdout only when empty");
+    program.add_argument("--tag").default_value(std::string("")).help("label stored with the results, e.g. a commit");
+    program.add_argument("--thresholds").default_value(std::string("0.5,1,2,4"))
+           .help("bad-pixel thresholds in pixels");
+    program.add_argument("--warmup").default_value(1).scan<'i', int>();
+    program.add_argument("--repeats").default_value(3).scan<'i', int>();
+    program.add_argument("--grayscale").default_value(false).implicit_value(true);
+
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl << program;
+        return 1;
+    }
+
+    try {
+        const auto datasetPath = program.get<std::string>("dataset");
+        const auto dataset = evaluation::StereoDataset::load(datasetPath,
+                                                              parseLayout(program.get<std::string>("--layout")),
+                                                              program.get<bool>("--grayscale"));
+        if (dataset.empty()) {
+            std::cerr << "Error: no stereo pairs found in " << datasetPath << std::endl;
+            return 1;
+        }
+
+        // The post-processing chain is run stage by stage here rather than inside the matcher, so it is
+        // stripped from the configuration the matcher sees. Stages are planned the way the matcher plans them:
+        // adjacent pointwise entries run and are timed as one fused pass, reported as e.g. "scale+threshold".
+        const auto configPath = program.get<std::string>("--config");
+        std::shared_ptr<StereoSGBM> matcher;
+        std::vector<Stage> stages;
+        if (configPath.empty()) {
+            matcher = std::make_shared<StereoSGBM>(defaultParameters(dataset.getSamples().front().left.channels()));
+        } else {
+            const YAML::Node config = utils::YAMLUtils::loadYamlConfig(configPath);
+            YAML::Node matcherConfig = YAML::Clone(config);
+            matcherConfig.remove("postprocess");
+            matcher = std::make_shared<StereoSGBM>(matcherConfig);
+            const YAML::Node entries = config["postprocess"];
+            const auto pipelines = processing::PipelineFactory::createAll(entries);
+            std::size_t next = 0;
+            for (const auto &pipeline : processing::FusedPointwisePipeline::fuse(pipelines)) {
+                std::string name = entries[next]["type"].as<std::string>();
+                if (pipeline != pipelines[next++]) {
+                    // A fused stage stands for the whole run of adjacent pointwise entries.
+                    while (next < pipelines.size() &&
+                           std::dynamic_pointer_cast<processing::PointwisePipeline>(pipelines[next])) {
+                        name += "+" + entries[next++]["type"].as<std::string>();
+                    }
+                }
+                stages.push_back({name, pipeline});
+            }
+        }
+
+        std::vector<std::string> stageNames{"match"};
+        for (const auto &stage : stages) {
+            stageNames.push_back(stage.name);
+        }
+
+        const auto thresholds = tools::parseList<double>(program.get<std::string>("--thresholds"));
+        const int warmup = std::max(0, program.get<int>("--warmup"));
+        const int repeats = std::max(1, program.get<int>("--repeats"));
+        std::vector<SampleResult> results;
+        for (const auto &sample : dataset.getSamples()) {
+            try {
+                results.push_back(evaluateSample(sample, *matcher, stages, thresholds, warmup, repeats));
+            } catch (const std::exception &e) {
+                std::cerr << "Warning: " << sample.name << " failed: " << e.what() << std::endl;
+                continue;
+            }
+            const auto &r = results.back();
+            std::cout << std::left << std::setw(24) << r.name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(9) << r.totalMs << " ms  density " << std::setprecision(3) << r.metrics.density;
+            if (r.metrics.hasGroundTruth) {
+                std::cout << "  epe " << r.metrics.endPointError;
+                for (std::size_t i = 0; i < thresholds.size(); ++i) {
+                    std::cout << "  " << thresholdKey(thresholds[i]) << ' ' << r.badRates[i];
+                }
+            }
+            std::cout << std::endl;
+        }
+        if (results.empty()) {
+            std::cerr << "Error: every sample failed." << std::endl;
+            return 1;
+        }
+
+        const auto tag = program.get<std::string>("--tag");
+        const auto output = program.get<std::string>("--output");
+        if (output.empty()) {
+            writeJson(std::cout, tag, datasetPath, configPath, thresholds, stageNames, results);
+        } else {
+            std::ofstream file(output);
+            if (!file) {
+                throw std::runtime_error("Cannot write " + output);
+            }
+            writeJson(file, tag, datasetPath, configPath, thresholds, stageNames, results);
+            std::cout << "Info: wrote " << output << std::endl;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,575 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+// Runs the full pipeline headless, capture (or replay) -> rectify -> match -> post-process -> sinks, and reports
+// steady-state throughput, per-stage and end-to-end latency percentiles and CPU use.
+//
+//     stereo_vision_run --config resources/settings.yaml --disparity disparity.yaml --frames 600 --workers 2
+//
+#include "settings/settings.h"
+#include "vision/capture/frame_source.h"
+#include "vision/capture/stereo_capture.h"
+#include "vision/disparity/batch.h"
+#include "vision/disparity/disparity_format.h"
+#include "vision/helpers/memory_tracker.h"
+#include "vision/helpers/thread_affinity.h"
+#include "vision/helpers/trace.h"
+#include "vision/helpers/yaml.h"
+#include "vision/sensors/camera/stereo_camera.h"
+#ifdef VISION_WITH_POINT_CLOUD_WRITER
+#include "vision/transport/point_cloud_writer.h"
+#endif
+#ifdef VISION_WITH_SHM
+#include "vision/transport/shm_ring.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <opencv2/calib3d.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <yaml-cpp/yaml.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace vlue;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    std::atomic<bool> g_Stop{false};
+
+    void onSignal(int) {
+        g_Stop = true;
+    }
+
+    double msBetween(Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    // Process CPU time (all threads) in seconds, or a negative value where it cannot be measured.
+    double processCpuSeconds() {
+#if defined(__unix__) || defined(__APPLE__)
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+                   static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+        }
+#endif
+        return -1.0;
+    }
+
+    // Small hand-off queue between pipeline threads. close() wakes everybody; pop() then drains what is left.
+    template<typename T>
+    class BoundedQueue {
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_Ready, m_Space;
+        std::deque<T> m_Items;
+        std::size_t m_Capacity;
+        bool m_Closed{false};
+
+    public:
+        explicit BoundedQueue(std::size_t capacity) : m_Capacity(std::max<std::size_t>(1, capacity)) {}
+
+        // Live sources drop the oldest frame instead of waiting, as the driver would. Returns true if one was dropped.
+        bool push(T item, bool dropOldest) {
+            bool dropped = false;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                if (dropOldest && m_Items.size() >= m_Capacity) {
+                    m_Items.pop_front();
+                    dropped = true;
+                }
+                m_Space.wait(lock, [&] { return m_Closed || m_Items.size() < m_Capacity; });
+                m_Items.push_back(std::move(item));
+            }
+            m_Ready.notify_one();
+            return dropped;
+        }
+
+        // Returns false on timeout, or once the queue is closed and empty.
+        bool pop(T &item, std::chrono::milliseconds timeout) {
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                if (!m_Ready.wait_for(lock, timeout, [&] { return m_Closed || !m_Items.empty(); }) ||
+                    m_Items.empty()) {
+                    return false;
+                }
+                item = std::move(m_Items.front());
+                m_Items.pop_front();
+            }
+            m_Space.notify_one();
+            return true;
+        }
+
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Closed = true;
+            }
+            m_Ready.notify_all();
+            m_Space.notify_all();
+        }
+
+        bool drained() {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_Closed && m_Items.empty();
+        }
+    };
+
+    struct CapturedFrame {
+        cv::Mat left, right;
+        Clock::time_point captured, rectified;
+    };
+
+    struct MatchedFrame {
+        disparity::BatchResult result;
+        Clock::time_point captured, rectified, submitted, matched;
+    };
+
+    struct Rectifier {
+        bool enabled{false};
+        cv::Mat leftMap1, leftMap2, rightMap1, rightMap2;
+        cv::Mat Q;
+
+        void apply(const cv::Mat &left, const cv::Mat &right, cv::Mat &leftOut, cv::Mat &rightOut) const {
+            if (!enabled) {
+                leftOut = left.clone();
+                rightOut = right.clone();
+                return;
+            }
+            const utils::TraceSpan span("rectify", "capture");
+            cv::remap(left, leftOut, leftMap1, leftMap2, cv::INTER_LINEAR);
+            cv::remap(right, rightOut, rightMap1, rightMap2, cv::INTER_LINEAR);
+        }
+    };
+
+    Rectifier makeRectifier(const std::string &cameraConfig, int width, int height) {
+        Rectifier rectifier;
+        sensors::StereoCamera camera(cameraConfig);
+        camera.stereo_rectify();
+        camera.init_stereo_undistort_rectify_map();
+        if (camera.size != cv::Size(width, height)) {
+            std::cerr << "Warning: calibration is for " << camera.size.width << "x" << camera.size.height
+                      << " but capture delivers " << width << "x" << height << ", not rectifying." << std::endl;
+            return rectifier;
+        }
+        // Fixed-point maps remap about twice as fast as the float ones.
+        cv::convertMaps(camera.l.map_x, camera.l.map_y, rectifier.leftMap1, rectifier.leftMap2, CV_16SC2);
+        cv::convertMaps(camera.r.map_x, camera.r.map_y, rectifier.rightMap1, rectifier.rightMap2, CV_16SC2);
+        rectifier.Q = camera.Q.clone();
+        rectifier.enabled = true;
+        return rectifier;
+    }
+
+    std::shared_ptr<capture::StereoCapture> openCapture(const settings::CaptureConfig &config,
+                                                        const argparse::ArgumentParser &program) {
+        const int width = config.resolution.width, height = config.resolution.height;
+        const auto raw = program.get<std::string>("--raw");
+        if (!raw.empty()) {
+            const auto fourcc = program.get<std::string>("--fourcc");
+            if (fourcc.size() != 4) {
+                throw std::invalid_argument("--fourcc takes four characters, e.g. YUYV.");
+            }
+            auto source = std::make_shared<capture::FileFrameSource>(
+                raw, 2 * width, height, capture::makeFourcc(fourcc[0], fourcc[1], fourcc[2], fourcc[3]),
+                4, program.get<bool>("--loop"));
+            return std::make_shared<capture::StereoCapture>(source, width, height);
+        }
+
+        const auto &sources = config.sources;
+        if (sources.size() >= 2) {
+            if (sources[0].index() != sources[1].index()) {
+                throw std::invalid_argument("Both capture sources must be device indices or both paths.");
+            }
+            if (std::holds_alternative<int>(sources[0])) {
+                return std::make_shared<capture::StereoCapture>(std::get<int>(sources[0]), std::get<int>(sources[1]),
+                                                                width, height);
+            }
+            return std::make_shared<capture::StereoCapture>(std::get<std::string>(sources[0]),
+                                                            std::get<std::string>(sources[1]), width, height);
+        }
+        if (std::holds_alternative<int>(sources[0])) {
+            return std::make_shared<capture::StereoCapture>(std::get<int>(sources[0]), width, height);
+        }
+        return std::make_shared<capture::StereoCapture>(std::get<std::string>(sources[0]), width, height);
+    }
+
+    struct Percentiles {
+        double p50{0}, p90{0}, p99{0}, max{0};
+    };
+
+    Percentiles percentiles(std::vector<double> values) {
+        Percentiles p;
+        if (values.empty()) {
+            return p;
+        }
+        std::sort(values.begin(), values.end());
+        auto at = [&](double q) {
+            return values[std::min(values.size() - 1, static_cast<std::size_t>(q * static_cast<double>(values.size())))];
+        };
+        p.p50 = at(0.50);
+        p.p90 = at(0.90);
+        p.p99 = at(0.99);
+        p.max = values.back();
+        return p;
+    }
+
+    void printPercentiles(std::ostream &os, const char *name, const std::vector<double> &values) {
+        const auto p = percentiles(values);
+        os << "  " << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(2)
+           << std::setw(9) << p.p50 << std::setw(9) << p.p90 << std::setw(9) << p.p99 << std::setw(9) << p.max << "\n";
+    }
+
+    // Everything the sink thread measures; only frames after the warm-up count.
+    struct Stats {
+        uint64_t delivered{0};
+        uint64_t measured{0};
+        Clock::time_point windowStart, windowEnd;
+        double cpuStart{-1.0}, cpuEnd{-1.0};
+        std::vector<double> queueMs, matchMs, sinkMs, totalMs;
+    };
+}
+
+int main(int argc, char *argv[]) {
+    argparse::ArgumentParser program("stereo_vision_run");
+    program.add_argument("-c", "--config").default_value(std::string("resources/settings.yaml"))
+           .help("application settings: capture, camera calibration and scheduling");
+    program.add_argument("-d", "--disparity").required()
+           .help("disparity YAML: matcher parameters and pre/post-processing stages");
+    program.add_argument("--frames").default_value(0).scan<'i', int>()
+           .help("stop after this many frames; 0 runs until the source ends or Ctrl-C");
+    program.add_argument("--duration").default_value(0.0).scan<'g', double>()
+           .help("stop after this many seconds; 0 for no limit");
+    program.add_argument("--warmup").default_value(30).scan<'i', int>()
+           .help("frames excluded from the statistics");
+    program.add_argument("--workers").default_value(1).scan<'i', int>()
+           .help("frames matched concurrently, each with its own matcher; 0 for one per hardware thread");
+    program.add_argument("--max-in-flight").default_value(0).scan<'i', int>();
+    program.add_argument("--gray").default_value(false).implicit_value(true)
+           .help("capture 8-bit luma instead of BGR");
+    program.add_argument("--no-rectify").default_value(false).implicit_value(true);
+    program.add_argument("--decode-workers").default_value(0).scan<'i', int>()
+           .help("decode threads for native and raw sources (see DecodePool)");
+    program.add_argument("--raw").default_value(std::string(""))
+           .help("replay a raw side-by-side frame file instead of the configured sources");
+    program.add_argument("--fourcc").default_value(std::string("YUYV")).help("pixel format of --raw");
+    program.add_argument("--loop").default_value(false).implicit_value(true).help("loop --raw");
+    program.add_argument("--queue").default_value(4).scan<'i', int>()
+           .help("frames buffered between capture and matching");
+#ifdef VISION_WITH_SHM
+    program.add_argument("--publish").default_value(std::string(""))
+           .help("publish disparity maps to this shared-memory ring");
+#endif
+#ifdef VISION_WITH_POINT_CLOUD_WRITER
+    program.add_argument("--clouds").default_value(std::string(""))
+           .help("write point clouds as binary PLY files with this path prefix");
+#endif
+    program.add_argument("--trace").default_value(std::string(""))
+           .help("record spans and write a Chrome trace JSON here");
+    program.add_argument("--memory").default_value(false).implicit_value(true)
+           .help("track cv::Mat memory per stage and print it at the end");
+
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl << program;
+        return 1;
+    }
+
+    try {
+        const settings::AppConfig config(program.get<std::string>("--config"));
+        const auto &captureConfig = config.getCaptureConfig();
+        const auto &scheduling = config.getSchedulingConfig();
+        const int width = captureConfig.resolution.width, height = captureConfig.resolution.height;
+        const bool replay = captureConfig.replay || !program.get<std::string>("--raw").empty();
+        const auto maxFrames = static_cast<uint64_t>(std::max(0, program.get<int>("--frames")));
+        const auto warmup = static_cast<uint64_t>(std::max(0, program.get<int>("--warmup")));
+        const double duration = program.get<double>("--duration");
+
+        if (program.get<bool>("--memory")) {
+            utils::MemoryTracker::instance().install();
+        }
+        const auto tracePath = program.get<std::string>("--trace");
+        if (!tracePath.empty()) {
+            utils::Tracer::start();
+        }
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+
+        // Every thread places itself when it starts; the report is printed once all of them have.
+        std::mutex placedMutex;
+        std::condition_variable placedCv;
+        std::size_t placed = 0;
+        auto place = [&](const std::string &role, const settings::SchedulingConfig::ThreadGroup &group) {
+            utils::Tracer::setThreadName(role);
+            if (scheduling.enable) {
+                utils::placeCurrentThread(role, group.cpus, group.priority, scheduling.numa_local);
+            }
+            std::lock_guard<std::mutex> lock(placedMutex);
+            ++placed;
+            placedCv.notify_all();
+        };
+
+        // The matcher runs on this thread. Pin it before anything calls parallel_for_, then start OpenCV's
+        // workers from here so they inherit the matcher CPU set rather than whichever thread gets there first.
+        place("matcher", scheduling.matcher);
+        cv::parallel_for_(cv::Range(0, std::max(1, cv::getNumThreads())), [](const cv::Range &) {});
+
+        Rectifier rectifier;
+        const auto &cameraConfig = config.getCameraConfig().config_path;
+        if (!program.get<bool>("--no-rectify") && !cameraConfig.empty()) {
+            rectifier = makeRectifier(cameraConfig, width, height);
+        }
+
+        auto capture = openCapture(captureConfig, program);
+        if (program.get<bool>("--gray")) {
+            capture->setOutputFormat(capture::CaptureOutputFormat::Gray);
+        }
+        std::size_t threads = 3;  // matcher, capture and sink
+        if (const int decodeWorkers = program.get<int>("--decode-workers"); decodeWorkers > 0) {
+            // The pool's grabbing thread is the one talking to the driver and gets the capture group as is;
+            // decode workers share its CPUs at the default priority so they cannot starve it.
+            const settings::SchedulingConfig::ThreadGroup decodeGroup{scheduling.capture.cpus, 0};
+            capture->setDecodeWorkers(
+                static_cast<unsigned>(decodeWorkers), 0,
+                [&] { place("capture.grab", scheduling.capture); },
+                [&, decodeGroup](unsigned index) { place("capture.decode." + std::to_string(index), decodeGroup); });
+            threads += 1 + static_cast<std::size_t>(decodeWorkers);
+        }
+
+        disparity::BatchStereoMatcher::Options batchOptions;
+        batchOptions.workers = static_cast<unsigned>(std::max(0, program.get<int>("--workers")));
+        batchOptions.maxInFlight = program.get<int>("--max-in-flight");
+        batchOptions.copyInputs = false;  // every rectified frame is a fresh buffer
+        disparity::BatchStereoMatcher batch(utils::YAMLUtils::loadYamlConfig(program.get<std::string>("--disparity")),
+                                            batchOptions);
+
+#ifdef VISION_WITH_SHM
+        std::unique_ptr<transport::ShmPublisher> publisher;
+        if (const auto name = program.get<std::string>("--publish"); !name.empty()) {
+            publisher = std::make_unique<transport::ShmPublisher>(name, std::size_t(width) * height * sizeof(short));
+        }
+#endif
+#ifdef VISION_WITH_POINT_CLOUD_WRITER
+        std::unique_ptr<transport::PointCloudWriter> clouds;
+        if (const auto prefix = program.get<std::string>("--clouds"); !prefix.empty()) {
+            if (rectifier.Q.empty()) {
+                throw std::invalid_argument("--clouds needs rectified input and its Q matrix.");
+            }
+            clouds = std::make_unique<transport::PointCloudWriter>(prefix, transport::PointCloudWriter::Options{});
+        }
+#endif
+
+        std::cout << "Info: " << (replay ? "replaying" : "capturing") << " " << width << "x" << height
+                  << (rectifier.enabled ? ", rectified" : ", unrectified") << ", " << batch.getWorkers()
+                  << " matcher worker(s)" << std::endl;
+
+        BoundedQueue<CapturedFrame> captured(static_cast<std::size_t>(std::max(1, program.get<int>("--queue"))));
+        BoundedQueue<MatchedFrame> matched(2 * batch.getWorkers() + 2);
+        std::atomic<uint64_t> captureDrops{0};
+        const auto started = Clock::now();
+        auto outOfTime = [&] {
+            return duration > 0.0 && std::chrono::duration<double>(Clock::now() - started).count() >= duration;
+        };
+
+        std::thread captureThread([&] {
+            place("capture", scheduling.capture);
+            uint64_t count = 0;
+            int misses = 0;
+            while (!g_Stop && !outOfTime() && (maxFrames == 0 || count < maxFrames)) {
+                capture::StereoFrame frame;
+                const auto state = capture->captureStereoFrame(frame);
+                if (state == capture::CaptureFrameState::NoCapture) {
+                    std::cerr << "Error: capture source is not open." << std::endl;
+                    break;
+                }
+                if (state != capture::CaptureFrameState::HasRightFrame) {
+                    // End of a replay; a live camera gets a few chances before we give up.
+                    if (replay || ++misses > 10) {
+                        break;
+                    }
+                    continue;
+                }
+                misses = 0;
+                CapturedFrame item;
+                item.captured = Clock::now();
+                rectifier.apply(frame.left, frame.right, item.left, item.right);
+                frame.release();
+                item.rectified = Clock::now();
+                if (captured.push(std::move(item), !replay)) {
+                    ++captureDrops;
+                }
+                ++count;
+            }
+            captured.close();
+        });
+
+        Stats stats;
+        uint64_t sinkErrors = 0;
+        std::thread sinkThread([&] {
+            place("sink", scheduling.sink);
+            MatchedFrame frame;
+            while (!matched.drained()) {
+                if (!matched.pop(frame, std::chrono::milliseconds(100))) {
+                    continue;
+                }
+                try {
+                    const utils::TraceSpan span("sink", "sink");
+#ifdef VISION_WITH_SHM
+                    if (publisher) {
+                        publisher->publish(frame.result.leftDisparity, transport::PayloadKind::Disparity,
+                                           frame.result.sequence);
+                    }
+#endif
+#ifdef VISION_WITH_POINT_CLOUD_WRITER
+                    if (clouds) {
+                        // reprojectImageTo3D takes CV_16S as whole pixels; drop the fractional bits first.
+                        // Invalid pixels become minDisparity - 1 and are still treated as missing.
+                        cv::Mat disparity, points;
+                        frame.result.leftDisparity.convertTo(disparity, CV_32F, 1.0 / disparity::DISP_SCALE);
+                        cv::reprojectImageTo3D(disparity, points, rectifier.Q, true);
+                        clouds->write(points, frame.result.left, static_cast<int64_t>(frame.result.sequence));
+                    }
+#endif
+                } catch (const std::exception &e) {
+                    if (sinkErrors++ == 0) {
+                        std::cerr << "Error: sink failed: " << e.what() << std::endl;
+                    }
+                }
+
+                const auto done = Clock::now();
+                if (++stats.delivered == warmup + 1) {
+                    stats.windowStart = done;
+                    stats.cpuStart = processCpuSeconds();
+                }
+                if (stats.delivered <= warmup) {
+                    continue;
+                }
+                ++stats.measured;
+                stats.windowEnd = done;
+                stats.cpuEnd = processCpuSeconds();
+                stats.queueMs.push_back(msBetween(frame.rectified, frame.submitted));
+                stats.matchMs.push_back(msBetween(frame.submitted, frame.matched));
+                stats.sinkMs.push_back(msBetween(frame.matched, done));
+                stats.totalMs.push_back(msBetween(frame.captured, done));
+            }
+        });
+
+        if (scheduling.enable) {
+            // Report once every thread has placed itself; a thread that never starts should not hold up the run.
+            std::unique_lock<std::mutex> lock(placedMutex);
+            placedCv.wait_for(lock, std::chrono::seconds(2), [&] { return placed >= threads; });
+            lock.unlock();
+            utils::printPlacementReport(std::cout);
+        }
+
+        // Matcher loop on this thread: feed the batch, hand results to the sink in order.
+        std::deque<MatchedFrame> inFlight;
+        uint64_t matchErrors = 0;
+        auto deliver = [&](std::chrono::milliseconds timeout) {
+            MatchedFrame frame;
+            try {
+                if (!batch.next(frame.result, timeout)) {
+                    return false;
+                }
+            } catch (const std::exception &e) {
+                if (matchErrors++ == 0) {
+                    std::cerr << "Error: matching failed: " << e.what() << std::endl;
+                }
+                inFlight.pop_front();
+                return true;
+            }
+            auto &timing = inFlight.front();
+            frame.captured = timing.captured;
+            frame.rectified = timing.rectified;
+            frame.submitted = timing.submitted;
+            frame.matched = Clock::now();
+            inFlight.pop_front();
+            matched.push(std::move(frame), false);
+            return true;
+        };
+
+        CapturedFrame frame;
+        while (!captured.drained()) {
+            if (!captured.pop(frame, std::chrono::milliseconds(10))) {
+                while (deliver(std::chrono::milliseconds(0))) {
+                }
+                continue;
+            }
+            while (batch.full()) {
+                deliver(std::chrono::milliseconds::max());
+            }
+            MatchedFrame timing;
+            timing.captured = frame.captured;
+            timing.rectified = frame.rectified;
+            timing.submitted = Clock::now();
+            inFlight.push_back(timing);
+            batch.submit(frame.left, frame.right);
+            while (deliver(std::chrono::milliseconds(0))) {
+            }
+        }
+        while (!inFlight.empty()) {
+            deliver(std::chrono::milliseconds::max());
+        }
+        matched.close();
+        captureThread.join();
+        sinkThread.join();
+#ifdef VISION_WITH_POINT_CLOUD_WRITER
+        if (clouds) {
+            clouds->flush();
+        }
+#endif
+
+        // Report.
+        const double window = std::chrono::duration<double>(stats.windowEnd - stats.windowStart).count();
+        std::cout << "\nFrames: " << stats.delivered << " delivered, " << stats.measured << " measured after "
+                  << warmup << " warm-up, " << captureDrops << " dropped at capture, " << matchErrors
+                  << " failed to match\n";
+        if (stats.measured > 1 && window > 0.0) {
+            std::cout << std::fixed << std::setprecision(2) << "Throughput: "
+                      << static_cast<double>(stats.measured - 1) / window << " fps over " << window << " s\n";
+            if (stats.cpuStart >= 0.0) {
+                const double cpu = (stats.cpuEnd - stats.cpuStart) / window;
+                std::cout << "CPU: " << std::setprecision(0) << 100.0 * cpu << "% (" << std::setprecision(2) << cpu
+                          << " of " << std::thread::hardware_concurrency() << " cores)\n";
+            }
+            std::cout << "Latency (ms)        p50      p90      p99      max\n";
+            printPercentiles(std::cout, "queue", stats.queueMs);
+            printPercentiles(std::cout, "match", stats.matchMs);
+            printPercentiles(std::cout, "sink", stats.sinkMs);
+            printPercentiles(std::cout, "end-to-end", stats.totalMs);
+        } else {
+            std::cout << "Not enough frames after the warm-up for statistics.\n";
+        }
+        std::cout.flush();
+
+        if (program.get<bool>("--memory")) {
+            utils::MemoryTracker::instance().dump(std::cout);
+        }
+        if (!tracePath.empty()) {
+            utils::Tracer::stop();
+            if (utils::Tracer::writeChromeTrace(tracePath)) {
+                std::cout << "Info: wrote " << utils::Tracer::spanCount() << " spans to " << tracePath << std::endl;
+            }
+        }
+        return matchErrors > 0 && stats.delivered == 0 ? 1 : 0;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
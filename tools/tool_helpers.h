@@ -0,0 +1,51 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+// Small helpers shared by the command-line tools.
+//
+
+#ifndef VISION_TOOLS_TOOL_HELPERS_H
+#define VISION_TOOLS_TOOL_HELPERS_H
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace vlue::tools {
+    // Comma-separated values, e.g. "0.5,1,2,4"; empty items are skipped and an empty list is an error.
+    template<typename Tp>
+    std::vector<Tp> parseList(const std::string &text) {
+        std::vector<Tp> values;
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (item.empty()) {
+                continue;
+            }
+            if constexpr (std::is_integral_v<Tp>) {
+                values.push_back(static_cast<Tp>(std::stoi(item)));
+            } else {
+                values.push_back(static_cast<Tp>(std::stod(item)));
+            }
+        }
+        if (values.empty()) {
+            throw std::invalid_argument("Empty value list: '" + text + "'");
+        }
+        return values;
+    }
+
+    // Upper median, 0 for no samples.
+    inline double median(std::vector<double> values) {
+        if (values.empty()) {
+            return 0.0;
+        }
+        const auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+        std::nth_element(values.begin(), middle, values.end());
+        return *middle;
+    }
+}
+
+#endif //VISION_TOOLS_TOOL_HELPERS_H
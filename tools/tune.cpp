@@ -0,0 +1,341 @@
+//
+// Created by Mark-Walen on 2026/10/19.
+//
+// Searches StereoSGBM settings over recorded stereo pairs and writes the chosen set back as a disparity YAML.
+//
+//     stereo_vision_tune <dataset> --budget-ms 30 --output disparity.yaml --front front.csv
+//
+#include "vision/disparity/sgbm.h"
+#include "vision/evaluation/dataset.h"
+#include "vision/evaluation/metrics.h"
+#include "vision/pipeline/pipeline.h"
+#include "tool_helpers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <opencv2/core.hpp>
+#include <yaml-cpp/yaml.h>
+
+using namespace vlue;
+using disparity::StereoSGBM;
+using tools::median;
+using tools::parseList;
+
+namespace {
+    // WLS settings used for candidates that enable it; only on/off is searched.
+    constexpr double WLS_LAMBDA = 8000.0;
+    constexpr double WLS_SIGMA_COLOR = 1.5;
+    constexpr int WLS_LRC_THRESH = 24;
+    constexpr int WLS_DISC_RADIUS = 3;
+
+    struct Candidate {
+        StereoSGBM::Parameters params;
+        bool wls{false};
+
+        // Median milliseconds per pair during the sweep (one core per candidate) and, for the Pareto front,
+        // when re-timed alone with every core available.
+        double sweepMs{0.0};
+        double latencyMs{0.0};
+        evaluation::DisparityMetrics metrics;
+        double quality{0.0};
+    };
+
+    const char *modeName(int mode) {
+        switch (mode) {
+            case StereoSGBM::MODE_SGBM: return "SGBM";
+            case StereoSGBM::MODE_HH: return "HH";
+            case StereoSGBM::MODE_SGBM_3WAY: return "3WAY";
+            case StereoSGBM::MODE_HH4: return "HH4";
+            default: return "?";
+        }
+    }
+
+    StereoSGBM makeMatcher(const Candidate &candidate) {
+        StereoSGBM matcher(candidate.params);
+        if (candidate.wls) {
+            matcher.registerPostprocessPipeline(std::make_shared<processing::DisparityWLSFilterPipeline>(
+                WLS_LAMBDA, WLS_SIGMA_COLOR, WLS_LRC_THRESH, WLS_DISC_RADIUS));
+        }
+        return matcher;
+    }
+
+    // Runs the candidate over every pair; returns the median time per pair and fills the averaged metrics.
+    double runCandidate(Candidate &candidate, const evaluation::StereoDataset &dataset, int repeats,
+                        bool collectMetrics) {
+        const StereoSGBM matcher = makeMatcher(candidate);
+        std::vector<double> times;
+        evaluation::DisparityMetrics sum;
+        int withGroundTruth = 0;
+
+        for (const auto &sample : dataset.getSamples()) {
+            cv::Mat leftDisparity, rightDisparity;
+            for (int r = 0; r < repeats; ++r) {
+                const auto start = std::chrono::steady_clock::now();
+                matcher.computeDisparity(sample.left, sample.right, leftDisparity, rightDisparity);
+                times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+            if (!collectMetrics) {
+                continue;
+            }
+            const auto metrics = evaluation::evaluateDisparity(leftDisparity, rightDisparity, sample.groundTruth,
+                                                               candidate.params.minDisparity,
+                                                               candidate.params.numDisparities);
+            sum.density += metrics.density;
+            sum.lrConsistency += metrics.lrConsistency;
+            if (metrics.hasGroundTruth) {
+                sum.badPixelRate += metrics.badPixelRate;
+                sum.endPointError += metrics.endPointError;
+                ++withGroundTruth;
+            }
+        }
+
+        if (collectMetrics) {
+            const auto n = static_cast<double>(dataset.size());
+            candidate.metrics.density = sum.density / n;
+            candidate.metrics.lrConsistency = sum.lrConsistency / n;
+            candidate.metrics.hasGroundTruth = withGroundTruth > 0;
+            if (withGroundTruth > 0) {
+                candidate.metrics.badPixelRate = sum.badPixelRate / withGroundTruth;
+                candidate.metrics.endPointError = sum.endPointError / withGroundTruth;
+            }
+            // Ground truth decides when we have it; otherwise prefer dense maps that survive the LR check.
+            candidate.quality = candidate.metrics.hasGroundTruth
+                                    ? 1.0 - candidate.metrics.badPixelRate
+                                    : candidate.metrics.density * candidate.metrics.lrConsistency;
+        }
+        return median(times);
+    }
+
+    std::vector<Candidate> paretoFront(const std::vector<Candidate> &candidates) {
+        std::vector<Candidate> front;
+        for (const auto &c : candidates) {
+            const bool dominated = std::any_of(candidates.begin(), candidates.end(), [&](const Candidate &o) {
+                return o.sweepMs <= c.sweepMs && o.quality >= c.quality &&
+                       (o.sweepMs < c.sweepMs || o.quality > c.quality);
+            });
+            if (!dominated) {
+                front.push_back(c);
+            }
+        }
+        std::sort(front.begin(), front.end(), [](const Candidate &a, const Candidate &b) { return a.sweepMs < b.sweepMs; });
+        return front;
+    }
+
+    void writeParameters(const Candidate &candidate, const std::string &path) {
+        const auto &p = candidate.params;
+        YAML::Emitter out;
+        out << YAML::Comment("Generated by stereo_vision_tune");
+        out << YAML::BeginMap;
+        out << YAML::Key << "minDisparity" << YAML::Value << p.minDisparity;
+        out << YAML::Key << "numDisparities" << YAML::Value << p.numDisparities;
+        out << YAML::Key << "blockSize" << YAML::Value << p.blockSize;
+        out << YAML::Key << "P1" << YAML::Value << p.P1;
+        out << YAML::Key << "P2" << YAML::Value << p.P2;
+        out << YAML::Key << "disp12MaxDiff" << YAML::Value << p.disp12MaxDiff;
+        out << YAML::Key << "preFilterCap" << YAML::Value << p.preFilterCap;
+        out << YAML::Key << "uniquenessRatio" << YAML::Value << p.uniquenessRatio;
+        out << YAML::Key << "speckleWindowSize" << YAML::Value << p.speckleWindowSize;
+        out << YAML::Key << "speckleRange" << YAML::Value << p.speckleRange;
+        out << YAML::Key << "mode" << YAML::Value << p.mode;
+        out << YAML::Key << "downscale" << YAML::Value << p.downscale;
+        if (candidate.wls) {
+            out << YAML::Key << "postprocess" << YAML::Value << YAML::BeginSeq << YAML::BeginMap;
+            out << YAML::Key << "type" << YAML::Value << "wls";
+            out << YAML::Key << "lambda" << YAML::Value << WLS_LAMBDA;
+            out << YAML::Key << "sigmaColor" << YAML::Value << WLS_SIGMA_COLOR;
+            out << YAML::Key << "LRCThresh" << YAML::Value << WLS_LRC_THRESH;
+            out << YAML::Key << "discRadius" << YAML::Value << WLS_DISC_RADIUS;
+            out << YAML::EndMap << YAML::EndSeq;
+        }
+        out << YAML::EndMap;
+
+        std::ofstream file(path);
+        if (!file) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+        file << out.c_str() << std::endl;
+    }
+
+    void printCandidate(std::ostream &os, const Candidate &c) {
+        os << std::setw(5) << c.params.blockSize << std::setw(6) << c.params.numDisparities
+           << std::setw(6) << modeName(c.params.mode) << std::setw(8) << c.params.P1 << std::setw(8) << c.params.P2
+           << std::setw(4) << c.params.downscale << std::setw(5) << (c.wls ? "yes" : "no")
+           << std::fixed << std::setprecision(2) << std::setw(10) << c.sweepMs << std::setw(10) << c.latencyMs
+           << std::setprecision(4) << std::setw(9) << c.metrics.density << std::setw(9) << c.metrics.lrConsistency;
+        if (c.metrics.hasGroundTruth) {
+            os << std::setw(9) << c.metrics.badPixelRate << std::setw(9) << c.metrics.endPointError;
+        }
+        os << std::setw(9) << c.quality << "\n";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    argparse::ArgumentParser program("stereo_vision_tune");
+    program.add_argument("dataset").help("directory with left/, right/ and optionally disparity/ subfolders");
+    program.add_argument("-o", "--output").default_value(std::string("disparity.yaml"))
+           .help("where to write the selected parameters");
+    program.add_argument("--front").default_value(std::string(""))
+           .help("optional CSV file receiving the Pareto front");
+    program.add_argument("--budget-ms").default_value(0.0).scan<'g', double>()
+           .help("latency budget per frame; 0 selects the best quality on the front");
+    program.add_argument("--block-sizes").default_value(std::string("3,5,7,9"));
+    program.add_argument("--num-disparities").default_value(std::string("64,96,128"));
+    program.add_argument("--modes").default_value(std::string("0,1,2,3"))
+           .help("0 = SGBM, 1 = HH, 2 = SGBM_3WAY, 3 = HH4");
+    program.add_argument("--penalty-scales").default_value(std::string("0.5,1,2"))
+           .help("multipliers on the usual P1 = 8*cn*bs^2, P2 = 32*cn*bs^2");
+    program.add_argument("--downscales").default_value(std::string("1,2"));
+    program.add_argument("--wls").default_value(std::string("0,1")).help("0 = off, 1 = on");
+    program.add_argument("--min-disparity").default_value(0).scan<'i', int>();
+    program.add_argument("--uniqueness-ratio").default_value(10).scan<'i', int>();
+    program.add_argument("--max-candidates").default_value(0).scan<'i', int>()
+           .help("randomly sample this many grid points; 0 runs the whole grid");
+    program.add_argument("--seed").default_value(0).scan<'i', int>();
+    program.add_argument("--repeats").default_value(3).scan<'i', int>()
+           .help("timed runs per pair when re-timing the front");
+    program.add_argument("--grayscale").default_value(false).implicit_value(true);
+
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl << program;
+        return 1;
+    }
+
+    try {
+        const auto dataset = evaluation::StereoDataset::loadDirectory(program.get<std::string>("dataset"),
+                                                                       program.get<bool>("--grayscale"));
+        if (dataset.empty()) {
+            std::cerr << "Error: no stereo pairs found." << std::endl;
+            return 1;
+        }
+        const int cn = dataset.getSamples().front().left.channels();
+        std::cout << "Info: " << dataset.size() << " pairs, ground truth: "
+                  << (dataset.hasGroundTruth() ? "yes" : "no") << std::endl;
+
+        std::vector<Candidate> candidates;
+        for (int blockSize : parseList<int>(program.get<std::string>("--block-sizes"))) {
+            for (int numDisparities : parseList<int>(program.get<std::string>("--num-disparities"))) {
+                for (int mode : parseList<int>(program.get<std::string>("--modes"))) {
+                    for (double scale : parseList<double>(program.get<std::string>("--penalty-scales"))) {
+                        for (int downscale : parseList<int>(program.get<std::string>("--downscales"))) {
+                            for (int wls : parseList<int>(program.get<std::string>("--wls"))) {
+                                Candidate c;
+                                c.params.minDisparity = program.get<int>("--min-disparity");
+                                c.params.numDisparities = numDisparities;
+                                c.params.blockSize = blockSize;
+                                c.params.P1 = static_cast<int>(8 * cn * blockSize * blockSize * scale);
+                                c.params.P2 = static_cast<int>(32 * cn * blockSize * blockSize * scale);
+                                c.params.disp12MaxDiff = 1;
+                                c.params.preFilterCap = 63;
+                                c.params.uniquenessRatio = program.get<int>("--uniqueness-ratio");
+                                c.params.mode = mode;
+                                c.params.downscale = downscale;
+                                c.wls = wls != 0;
+                                candidates.push_back(c);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        const int maxCandidates = program.get<int>("--max-candidates");
+        if (maxCandidates > 0 && static_cast<int>(candidates.size()) > maxCandidates) {
+            std::mt19937 rng(static_cast<unsigned>(program.get<int>("--seed")));
+            std::shuffle(candidates.begin(), candidates.end(), rng);
+            candidates.resize(maxCandidates);
+        }
+        std::cout << "Info: evaluating " << candidates.size() << " candidates on "
+                  << cv::getNumThreads() << " threads" << std::endl;
+
+        // One candidate per task. OpenCV runs parallel regions nested inside a task serially, so sweep times
+        // are single-core numbers that compare fairly against each other.
+        std::vector<char> failed(candidates.size(), 0);
+        cv::parallel_for_(cv::Range(0, static_cast<int>(candidates.size())), [&](const cv::Range &range) {
+            for (int i = range.start; i < range.end; ++i) {
+                try {
+                    candidates[i].sweepMs = runCandidate(candidates[i], dataset, 1, true);
+                } catch (const std::exception &e) {
+                    std::cerr << "Warning: candidate " << i << " failed: " << e.what() << std::endl;
+                    failed[i] = 1;
+                }
+            }
+        }, static_cast<double>(candidates.size()));
+
+        std::vector<Candidate> evaluated;
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            if (!failed[i]) {
+                evaluated.push_back(candidates[i]);
+            }
+        }
+        if (evaluated.empty()) {
+            std::cerr << "Error: every candidate failed." << std::endl;
+            return 1;
+        }
+
+        // The front is small; re-time it alone with every core to get deployable latencies.
+        auto front = paretoFront(evaluated);
+        const int repeats = std::max(1, program.get<int>("--repeats"));
+        for (auto &c : front) {
+            c.latencyMs = runCandidate(c, dataset, repeats, false);
+        }
+
+        std::cout << "\nPareto front (" << front.size() << " of " << evaluated.size() << "):\n"
+                  << "   bs  ndisp  mode      P1      P2  ds  wls  sweep_ms   lat_ms  density   lr_ok"
+                  << (dataset.hasGroundTruth() ? "      bad      epe" : "") << "  quality\n";
+        for (const auto &c : front) {
+            printCandidate(std::cout, c);
+        }
+
+        const double budget = program.get<double>("--budget-ms");
+        const Candidate *selected = nullptr;
+        for (const auto &c : front) {
+            if (budget > 0.0 && c.latencyMs > budget) {
+                continue;
+            }
+            if (!selected || c.quality > selected->quality) {
+                selected = &c;
+            }
+        }
+        if (!selected) {
+            selected = &*std::min_element(front.begin(), front.end(), [](const Candidate &a, const Candidate &b) {
+                return a.latencyMs < b.latencyMs;
+            });
+            std::cerr << "Warning: nothing meets the " << budget << " ms budget, selecting the fastest candidate."
+                      << std::endl;
+        }
+
+        const auto output = program.get<std::string>("--output");
+        writeParameters(*selected, output);
+        std::cout << "\nSelected:\n";
+        printCandidate(std::cout, *selected);
+        std::cout << "Info: wrote " << output << std::endl;
+
+        const auto frontPath = program.get<std::string>("--front");
+        if (!frontPath.empty()) {
+            std::ofstream csv(frontPath);
+            csv << "blockSize,numDisparities,mode,P1,P2,downscale,wls,sweep_ms,latency_ms,density,lr_consistency,"
+                   "bad_pixel_rate,epe,quality\n";
+            for (const auto &c : front) {
+                csv << c.params.blockSize << ',' << c.params.numDisparities << ',' << c.params.mode << ','
+                    << c.params.P1 << ',' << c.params.P2 << ',' << c.params.downscale << ',' << c.wls << ','
+                    << c.sweepMs << ',' << c.latencyMs << ',' << c.metrics.density << ','
+                    << c.metrics.lrConsistency << ',' << c.metrics.badPixelRate << ','
+                    << c.metrics.endPointError << ',' << c.quality << '\n';
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}